@@ -0,0 +1,115 @@
+// Microbenchmark for SdramModelSim word storage.
+//
+// Replays the SDRAM traffic of one 640x480 RGB565 frame -- a full
+// framebuffer clear (as MEM_FILL produces) followed by a display scanout
+// of every scanline -- through:
+//
+//   * map  -- the previous std::unordered_map<uint32_t, uint16_t> storage
+//             (one hash lookup per word, a node allocation per new word).
+//   * page -- SdramModelSim's two-level table of lazily allocated pages.
+//
+// Addresses follow the 4x4 block-tiled framebuffer layout (INT-011) in
+// the word-address space connect_sdram() produces, where each pixel's
+// even byte address is also its word address.  Both stores must return
+// the same scanout checksum.
+//
+// Build and run: make bench-sdram-sim  (from integration/)
+
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <iostream>
+#include <unordered_map>
+#include <utility>
+
+#include "sdram_model_sim.hpp"
+
+namespace {
+
+constexpr int FB_WIDTH = 640;
+constexpr int FB_HEIGHT = 480;
+constexpr int BLOCKS_PER_ROW = FB_WIDTH / 4;
+constexpr uint32_t FB_BASE = 0;
+
+/// Previous SdramModelSim storage, kept for comparison.
+class MapStore {
+public:
+    uint16_t read_word(uint32_t word_addr) const {
+        if (word_addr >= SdramModelSim::TOTAL_WORDS) {
+            return 0;
+        }
+        auto it = mem_.find(word_addr);
+        return it != mem_.end() ? it->second : 0;
+    }
+
+    void write_word(uint32_t word_addr, uint16_t data) {
+        if (word_addr >= SdramModelSim::TOTAL_WORDS) {
+            return;
+        }
+        mem_[word_addr] = data;
+    }
+
+private:
+    std::unordered_map<uint32_t, uint16_t> mem_;
+};
+
+/// Word address of pixel (x, y) in the block-tiled framebuffer.
+uint32_t pixel_addr(int x, int y) {
+    uint32_t block_idx = static_cast<uint32_t>((y >> 2) * BLOCKS_PER_ROW + (x >> 2));
+    uint32_t pixel_off = static_cast<uint32_t>(((y & 3) * 4 + (x & 3)) * 2);
+    return FB_BASE + (block_idx << 5) + pixel_off;
+}
+
+/// One frame: clear in block order, then scan out row by row.
+/// Returns a checksum of the scanned-out pixels.
+template <typename Store>
+uint64_t run_frame(Store& store, uint16_t clear_color) {
+    for (int block = 0; block < BLOCKS_PER_ROW * (FB_HEIGHT / 4); block++) {
+        for (uint32_t px = 0; px < 16; px++) {
+            store.write_word(FB_BASE + (static_cast<uint32_t>(block) << 5) + px * 2, clear_color);
+        }
+    }
+    uint64_t checksum = 0;
+    for (int y = 0; y < FB_HEIGHT; y++) {
+        for (int x = 0; x < FB_WIDTH; x++) {
+            checksum = checksum * 31 + store.read_word(pixel_addr(x, y));
+        }
+    }
+    return checksum;
+}
+
+/// Run `frames` frames on a fresh store (the first frame pays for page or
+/// node allocation); return ms/frame and the combined checksum.
+template <typename Store>
+std::pair<double, uint64_t> bench(int frames) {
+    Store store;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; f++) {
+        checksum ^= run_frame(store, static_cast<uint16_t>(0x1234 + f));
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                    .count();
+    return {ms / frames, checksum};
+}
+
+} // namespace
+
+int main() {
+    constexpr int FRAMES = 20;
+
+    auto [map_ms, map_sum] = bench<MapStore>(FRAMES);
+    auto [page_ms, page_sum] = bench<SdramModelSim>(FRAMES);
+
+    std::cout << std::format("SdramModelSim storage, {}x{} clear + scanout, {} frames\n",
+                             FB_WIDTH, FB_HEIGHT, FRAMES);
+    std::cout << std::format("  unordered_map: {:8.3f} ms/frame\n", map_ms);
+    std::cout << std::format("  paged array:   {:8.3f} ms/frame  ({:.1f}x)\n", page_ms,
+                             map_ms / page_ms);
+    if (map_sum != page_sum) {
+        std::cerr << "ERROR: map and paged stores disagree\n";
+        return 1;
+    }
+    std::cout << "  Scanout checksums match.\n";
+    return 0;
+}
@@ -21,14 +21,17 @@
 #include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <filesystem>
 #include <format>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 // Verilator-generated headers
@@ -36,10 +39,18 @@
 #include "Vgpu_top___024root.h"
 #include "Vgpu_top_gpu_top.h"
 #include "verilated.h"
+#include "verilated_save.h"
 
 // Behavioral SDRAM model (provides memory storage)
 #include "sdram_model_sim.hpp"
 
+// Shared with the integration harness: SDRAM pin adapter, checkpoint header,
+// PERF_TIMESTAMP readback, frame file output
+#include "frame_writer.hpp"
+#include "perf_timestamps.hpp"
+#include "sdram_pins.hpp"
+#include "sim_checkpoint.hpp"
+
 // SDL3 display
 #include <SDL3/SDL.h>
 
@@ -155,6 +166,33 @@ private:
     bool quit_ = false;
 };
 
+/// PERF_TIMESTAMP markers placed by the script (gpu.timestamp()).
+///
+/// Written by the Lua thread, read by the main thread at exit.  A marker
+/// reusing an earlier marker's slot replaces it, so a script that stamps
+/// the same slots every frame reports only the latest frame.
+class TimestampLog {
+public:
+    /// Record a marker, replacing any earlier one with the same slot.
+    void add(TimestampDirective ts) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        std::erase_if(marks_, [&](const TimestampDirective& m) {
+            return m.word_addr == ts.word_addr;
+        });
+        marks_.push_back(std::move(ts));
+    }
+
+    /// Copy of the markers in placement order.
+    [[nodiscard]] std::vector<TimestampDirective> snapshot() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return marks_;
+    }
+
+private:
+    mutable std::mutex mtx_;
+    std::vector<TimestampDirective> marks_;
+};
+
 // ---------------------------------------------------------------------------
 // SDL3 RAII wrappers
 // ---------------------------------------------------------------------------
@@ -232,162 +270,13 @@ void tick(Vgpu_top* top, uint64_t& sim_time) {
 // SDRAM pin-level connection
 // ---------------------------------------------------------------------------
 //
-// The SDRAM controller in gpu_top drives physical SDRAM pins (sdram_csn,
-// sdram_rasn, sdram_casn, sdram_wen, sdram_ba, sdram_a, sdram_dq, sdram_dqm).
-// This function decodes the SDRAM commands from those pins and connects them
-// to the SdramModelSim's memory store.
-//
-// With --pins-inout-enables, Verilator splits the inout sdram_dq port into:
-//   sdram_dq      -- input  (we drive read data to the controller)
-//   sdram_dq__out -- output (controller drives write data)
-//   sdram_dq__en  -- output enable (1 = controller driving)
-
-// SDRAM command encoding: {csn, rasn, casn, wen}
-static constexpr uint8_t SDRAM_CMD_NOP = 0b0111;
-static constexpr uint8_t SDRAM_CMD_ACTIVATE = 0b0011;
-static constexpr uint8_t SDRAM_CMD_READ = 0b0101;
-static constexpr uint8_t SDRAM_CMD_WRITE = 0b0100;
-static constexpr uint8_t SDRAM_CMD_PRECHARGE = 0b0010;
-static constexpr uint8_t SDRAM_CMD_AUTO_REFRESH = 0b0001;
-static constexpr uint8_t SDRAM_CMD_LOAD_MODE = 0b0000;
-
-/// CAS latency (CL=3, matching sdram_controller.sv).
-static constexpr int CAS_LATENCY = 3;
-
-/// Maximum depth for the CAS latency read pipeline.
-static constexpr int READ_PIPE_DEPTH = 8;
-
-/// Per-bank active row tracking.
-struct SdramBankState {
-    bool row_active = false;
-    uint32_t active_row = 0;
-};
-
-/// Read pipeline entry for CAS latency modeling.
-struct ReadPipeEntry {
-    bool valid = false;
-    uint32_t word_addr = 0;
-    int countdown = 0;
-};
-
-/// SDRAM connection state persisted across clock cycles.
-struct SdramConnState {
-    std::array<SdramBankState, 4> banks = {};
-    std::array<ReadPipeEntry, READ_PIPE_DEPTH> read_pipe = {};
-    int read_pipe_head = 0;
-};
-
-/// Connect the SDRAM model to the Verilated model's physical SDRAM pins.
-///
-/// Called once per clock cycle (after eval on rising edge). Decodes SDRAM
-/// commands and handles read pipeline with CAS latency, matching the
-/// integration harness approach.
-static void connect_sdram(Vgpu_top* top, SdramModelSim& sdram, SdramConnState& conn) {
-    // Step 1: Advance read pipeline -- deliver matured reads onto DQ bus
-    bool read_data_valid = false;
-    uint16_t read_data = 0;
-
-    std::ranges::for_each(conn.read_pipe, [&](ReadPipeEntry& entry) {
-        if (entry.valid) {
-            entry.countdown--;
-            if (entry.countdown <= 0) {
-                read_data = sdram.read_word(entry.word_addr);
-                read_data_valid = true;
-                entry.valid = false;
-            }
-        }
-    });
-
-    // Drive read data onto the DQ input bus
-    top->sdram_dq = read_data_valid ? read_data : 0;
-
-    // Step 2: Decode current-cycle SDRAM command from pins
-    auto cmd = static_cast<uint8_t>(
-        ((top->sdram_csn & 1) << 3) | ((top->sdram_rasn & 1) << 2) | ((top->sdram_casn & 1) << 1) |
-        ((top->sdram_wen & 1) << 0)
-    );
-
-    auto bank = static_cast<uint8_t>(top->sdram_ba & 0x3);
-    auto addr = static_cast<uint16_t>(top->sdram_a & 0x1FFF);
-
-    switch (cmd) {
-        case SDRAM_CMD_ACTIVATE: {
-            conn.banks[bank].row_active = true;
-            conn.banks[bank].active_row = addr;
-            break;
-        }
-
-        case SDRAM_CMD_READ: {
-            // Schedule read with CAS latency delay
-            uint32_t col = addr & 0x1FF;
-            uint32_t row = conn.banks[bank].active_row;
-            uint32_t word_addr = (static_cast<uint32_t>(bank) << 23) | (row << 9) | col;
-
-            // Find an empty pipeline slot using ranges
-            auto it = std::ranges::find_if(conn.read_pipe, [](const ReadPipeEntry& e) {
-                return !e.valid;
-            });
-
-            // Fall back to head if no empty slot found
-            auto& slot = (it != conn.read_pipe.end())
-                             ? *it
-                             : conn.read_pipe[static_cast<size_t>(conn.read_pipe_head)];
-
-            slot.valid = true;
-            slot.word_addr = word_addr;
-            // CAS_LATENCY - 1: compensate for one-cycle offset since
-            // connect_sdram is called AFTER tick()
-            slot.countdown = CAS_LATENCY - 1;
-
-            auto slot_idx = static_cast<int>(&slot - conn.read_pipe.data());
-            conn.read_pipe_head = (slot_idx + 1) % READ_PIPE_DEPTH;
-            break;
-        }
-
-        case SDRAM_CMD_WRITE: {
-            uint32_t col = addr & 0x1FF;
-            uint32_t row = conn.banks[bank].active_row;
-            uint32_t word_addr = (static_cast<uint32_t>(bank) << 23) | (row << 9) | col;
-
-            auto wdata = static_cast<uint16_t>(top->sdram_dq__out & 0xFFFF);
-            auto dqm = static_cast<uint8_t>(top->sdram_dqm & 0x3);
-
-            // Apply byte mask
-            if (dqm == 0x00) {
-                sdram.write_word(word_addr, wdata);
-            } else {
-                uint16_t existing = sdram.read_word(word_addr);
-                if ((dqm & 0x01) == 0) {
-                    existing = (existing & 0xFF00) | (wdata & 0x00FF);
-                }
-                if ((dqm & 0x02) == 0) {
-                    existing = (existing & 0x00FF) | (wdata & 0xFF00);
-                }
-                sdram.write_word(word_addr, existing);
-            }
-            break;
-        }
-
-        case SDRAM_CMD_PRECHARGE: {
-            if ((addr & (1 << 10)) != 0) {
-                std::ranges::for_each(conn.banks, [](SdramBankState& b) { b.row_active = false; });
-            } else {
-                conn.banks[bank].row_active = false;
-            }
-            break;
-        }
-
-        case SDRAM_CMD_NOP:
-        case SDRAM_CMD_AUTO_REFRESH:
-        case SDRAM_CMD_LOAD_MODE:
-        default:
-            break;
-    }
-}
+// connect_sdram() and SdramPinAdapter (rtl/tb/sdram_pins.hpp) decode the
+// controller's SDRAM pins and serve them from the SdramModelSim memory
+// store, exactly as in the integration harness.
 
 /// Assert reset for the specified number of cycles, then deassert.
 static void reset_gpu(
-    Vgpu_top* top, SdramModelSim& sdram, SdramConnState& conn, uint64_t& sim_time, int cycles
+    Vgpu_top* top, SdramModelSim& sdram, SdramPinAdapter& conn, uint64_t& sim_time, int cycles
 ) {
     top->rst_n = 0;
     for (int i = 0; i < cycles; i++) {
@@ -399,6 +288,92 @@ static void reset_gpu(
     connect_sdram(top, sdram, conn);
 }
 
+// ---------------------------------------------------------------------------
+// Checkpoint save / restore
+// ---------------------------------------------------------------------------
+//
+// Same file layout as the integration harness (see sim_checkpoint.hpp),
+// except the SDRAM contents are SdramModelSim's allocated pages, each
+// written as (first_word, PAGE_WORDS words).  Requires a --savable
+// model (SIM_SAVABLE); other builds report checkpoints as unavailable.
+
+#ifdef SIM_SAVABLE
+static_assert(std::is_trivially_copyable_v<SdramPinAdapter>);
+
+/// Save the post-init simulation state to `path`.
+/// Throws std::runtime_error if the file cannot be created.
+static void save_checkpoint(
+    const std::string& path,
+    Vgpu_top* top,
+    const SdramModelSim& sdram,
+    const SdramPinAdapter& conn,
+    uint64_t sim_time
+) {
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+        throw std::runtime_error(std::format("cannot create checkpoint {}", path));
+    }
+    sim_checkpoint::write_header(os, {sim_time, 0, {}, {}});
+    sim_checkpoint::write_pod(os, conn);
+    sim_checkpoint::write_pod(os, static_cast<uint64_t>(sdram.allocated_pages()));
+    sdram.for_each_page([&os](uint32_t first_word, std::span<const uint16_t> words) {
+        sim_checkpoint::write_pod(os, first_word);
+        os.write(words.data(), words.size_bytes());
+    });
+    os << *top;
+    os.close();
+}
+
+/// Restore simulation state saved by save_checkpoint().
+/// Must be called before the first eval() of a freshly constructed model.
+/// Checkpoint pages overwrite the model's; other pages (e.g. data from a
+/// mapped SDRAM image) are kept.
+///
+/// @return The restored sim_time.
+static uint64_t restore_checkpoint(
+    const std::string& path, Vgpu_top* top, SdramModelSim& sdram, SdramPinAdapter& conn
+) {
+    VerilatedRestore is;
+    is.open(path.c_str());
+    if (!is.isOpen()) {
+        throw std::runtime_error(std::format("cannot open checkpoint {}", path));
+    }
+    auto header = sim_checkpoint::read_header(is);
+    sim_checkpoint::read_pod(is, conn);
+    uint64_t page_count = 0;
+    sim_checkpoint::read_pod(is, page_count);
+    for (uint64_t i = 0; i < page_count; i++) {
+        uint32_t first_word = 0;
+        sim_checkpoint::read_pod(is, first_word);
+        if (first_word >= SdramModelSim::TOTAL_WORDS) {
+            throw std::runtime_error(
+                std::format("checkpoint {}: SDRAM page 0x{:06X} out of range", path, first_word));
+        }
+        auto words = sdram.writable_page(first_word);
+        is.read(words.data(), words.size_bytes());
+    }
+    is >> *top;
+    is.close();
+    return header.sim_time;
+}
+#else
+[[noreturn]] static void checkpoints_unavailable() {
+    throw std::runtime_error("checkpoints need a --savable build (SIM_SAVABLE)");
+}
+
+static void save_checkpoint(
+    const std::string&, Vgpu_top*, const SdramModelSim&, const SdramPinAdapter&, uint64_t
+) {
+    checkpoints_unavailable();
+}
+
+static uint64_t
+restore_checkpoint(const std::string&, Vgpu_top*, SdramModelSim&, SdramPinAdapter&) {
+    checkpoints_unavailable();
+}
+#endif
+
 // ---------------------------------------------------------------------------
 // Lua thread function
 // ---------------------------------------------------------------------------
@@ -407,9 +382,12 @@ static void reset_gpu(
 ///
 /// The script calls gpu.write_reg() and gpu.wait_vsync() which block on
 /// the SimChannel and VsyncNotifier abstractions until the main simulation
-/// loop processes the requests.
-static void
-lua_thread_func(const char* script_path, SimChannel& cmd_channel, VsyncNotifier& vsync) {
+/// loop processes the requests.  gpu.timestamp() markers are recorded in
+/// `timestamps` for the report printed at exit.
+static void lua_thread_func(
+    const char* script_path, SimChannel& cmd_channel, VsyncNotifier& vsync,
+    TimestampLog& timestamps
+) {
     sol::state lua;
     lua.open_libraries(
         sol::lib::base,
@@ -450,8 +428,27 @@ lua_thread_func(const char* script_path, SimChannel& cmd_channel, VsyncNotifier&
     };
 
     // gpu.wait_vsync() -- block until the next vsync rising edge.
-    gpu["wait_vsync"] = [&vsync]() {
+    // Frames waited so far name the "phase" of later timestamps.
+    int frame = 0;
+    gpu["wait_vsync"] = [&vsync, &frame]() {
         vsync.wait_for_vsync();
+        frame++;
+    };
+
+    // gpu.timestamp(label, addr) -- write PERF_TIMESTAMP with the 32-bit
+    // word address `addr`; the value is read back and reported at exit.
+    gpu["timestamp"] = [&cmd_channel, &timestamps, &frame](
+                           const std::string& label, uint32_t addr
+                       ) {
+        uint32_t word_addr = addr & PERF_TIMESTAMP_ADDR_MASK;
+        timestamps.add({label, word_addr, std::format("frame {}", frame), 0});
+
+        SimCmd cmd;
+        cmd.rw = 0; // Write
+        cmd.addr = REG_PERF_TIMESTAMP;
+        cmd.wdata = word_addr;
+
+        cmd_channel.push_and_wait(cmd);
     };
 
     // Load and execute the script
@@ -468,6 +465,28 @@ lua_thread_func(const char* script_path, SimChannel& cmd_channel, VsyncNotifier&
     }
 }
 
+// ---------------------------------------------------------------------------
+// Frame dumps
+// ---------------------------------------------------------------------------
+
+/// Write the presented RGBA frame as <stem>_<NNNNN><ext> beside `pattern`,
+/// in the format its extension selects (.png or .qoi; see frame_writer.hpp).
+static void dump_frame(
+    const std::filesystem::path& pattern, int index, int width, int height,
+    std::span<const uint8_t> rgba
+) {
+    size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    std::vector<uint8_t> rgb(pixels * 3);
+    for (size_t i = 0; i < pixels; i++) {
+        std::copy_n(&rgba[i * 4], 3, &rgb[i * 3]);
+    }
+    std::filesystem::path path = pattern;
+    path.replace_filename(std::format(
+        "{}_{:05}{}", pattern.stem().string(), index, pattern.extension().string()
+    ));
+    frame_writer::write_frame(path, width, height, rgb);
+}
+
 // ---------------------------------------------------------------------------
 // Usage
 // ---------------------------------------------------------------------------
@@ -475,10 +494,22 @@ lua_thread_func(const char* script_path, SimChannel& cmd_channel, VsyncNotifier&
 static void print_usage(const char* prog) {
     std::cerr << std::format(
         "Usage: {} --script <path.lua> [--width N] [--height N]\n"
+        "          [--restore <ckpt>] [--save-checkpoint <ckpt>]\n"
+        "          [--sdram-image <file> [--sdram-image-mode cow|shared]]\n"
+        "          [--dump-frames <frames/f.png|.qoi>]\n"
         "\n"
-        "  --script <path>   Lua script to execute (required)\n"
-        "  --width  <N>      Display width  (default: {})\n"
-        "  --height <N>      Display height (default: {})\n",
+        "  --script <path>          Lua script to execute (required)\n"
+        "  --width  <N>             Display width  (default: {})\n"
+        "  --height <N>             Display height (default: {})\n"
+        "  --restore <ckpt>         Resume from a post-init checkpoint\n"
+        "                           (skips reset and SDRAM init)\n"
+        "  --save-checkpoint <ckpt> Save a post-init checkpoint after SDRAM init\n"
+        "  --sdram-image <file>     Back SDRAM with a mapped image file\n"
+        "                           (pre-staged textures, palettes, ...)\n"
+        "  --sdram-image-mode <m>   cow (default; file is read-only) or shared\n"
+        "                           (final SDRAM state is left in the file)\n"
+        "  --dump-frames <path>     Write every presented frame as <stem>_NNNNN<ext>\n"
+        "                           (.png: striped parallel PNG; .qoi: fastest)\n",
         prog,
         DEFAULT_WIDTH,
         DEFAULT_HEIGHT
@@ -499,6 +530,11 @@ int main(int argc, char** argv) {
         const char* script_path = nullptr;
         int disp_width = DEFAULT_WIDTH;
         int disp_height = DEFAULT_HEIGHT;
+        std::string restore_file;
+        std::string save_file;
+        std::string sdram_image;
+        SdramImageMode sdram_image_mode = SdramImageMode::COPY_ON_WRITE;
+        std::filesystem::path dump_pattern;
 
         for (int i = 1; i < argc; i++) {
             if (std::strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
@@ -507,6 +543,16 @@ int main(int argc, char** argv) {
                 disp_width = std::atoi(argv[++i]);
             } else if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
                 disp_height = std::atoi(argv[++i]);
+            } else if (std::strcmp(argv[i], "--restore") == 0 && i + 1 < argc) {
+                restore_file = argv[++i];
+            } else if (std::strcmp(argv[i], "--save-checkpoint") == 0 && i + 1 < argc) {
+                save_file = argv[++i];
+            } else if (std::strcmp(argv[i], "--sdram-image") == 0 && i + 1 < argc) {
+                sdram_image = argv[++i];
+            } else if (std::strcmp(argv[i], "--sdram-image-mode") == 0 && i + 1 < argc) {
+                sdram_image_mode = parse_sdram_image_mode(argv[++i]);
+            } else if (std::strcmp(argv[i], "--dump-frames") == 0 && i + 1 < argc) {
+                dump_pattern = argv[++i];
             } else if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
                 print_usage(argv[0]);
                 return 0;
@@ -518,6 +564,13 @@ int main(int argc, char** argv) {
             return 1;
         }
 
+        // The display tap is RGB888 (after the display pipeline), so a raw
+        // RGB565 dump would not be lossless here.
+        if (!dump_pattern.empty()
+            && frame_writer::frame_format(dump_pattern) == frame_writer::FrameFormat::RGB565) {
+            throw std::runtime_error("--dump-frames: use a .png or .qoi path");
+        }
+
         // ---------------------------------------------------------------
         // 2. Initialize SDL3 (RAII guard ensures SDL_Quit on all paths)
         // ---------------------------------------------------------------
@@ -560,38 +613,64 @@ int main(int argc, char** argv) {
 
         auto top = std::make_unique<Vgpu_top>(contextp.get());
 
-        SdramModelSim sdram;
-        SdramConnState conn;
+        // --sdram-image maps a staged image so its contents are present
+        // from cycle 0; a restored checkpoint's pages are applied on top.
+        std::unique_ptr<SdramModelSim> sdram_ptr =
+            sdram_image.empty() ? std::make_unique<SdramModelSim>()
+                                : std::make_unique<SdramModelSim>(sdram_image, sdram_image_mode);
+        SdramModelSim& sdram = *sdram_ptr;
+        if (!sdram_image.empty()) {
+            std::cout << std::format(
+                "Mapped SDRAM image {} ({} pages with data).\n", sdram_image,
+                sdram.allocated_pages()
+            );
+        }
+        SdramPinAdapter conn;
 
         uint64_t sim_time = 0;
 
         // ---------------------------------------------------------------
-        // 4. Reset the GPU
+        // 4. Reset the GPU (or restore a post-init checkpoint)
         // ---------------------------------------------------------------
         // Ensure SPI pins are inactive during reset
         top->spi_cs_n = 1;
         top->spi_sck = 0;
         top->spi_mosi = 0;
 
-        reset_gpu(top.get(), sdram, conn, sim_time, 100);
+        if (!restore_file.empty()) {
+            sim_time = restore_checkpoint(restore_file, top.get(), sdram, conn);
+            std::cout << std::format(
+                "Restored {} at cycle {}.\n", restore_file, sim_time / 2
+            );
+        } else {
+            reset_gpu(top.get(), sdram, conn, sim_time, 100);
+
+            // Wait for SDRAM controller initialization (~25k cycles at 100 MHz)
+            std::cout << "Waiting for SDRAM controller initialization...\n";
+            for (int i = 0; i < 25000; i++) {
+                tick(top.get(), sim_time);
+                connect_sdram(top.get(), sdram, conn);
+            }
+            std::cout << "SDRAM controller initialized.\n";
 
-        // Wait for SDRAM controller initialization (~25k cycles at 100 MHz)
-        std::cout << "Waiting for SDRAM controller initialization...\n";
-        for (int i = 0; i < 25000; i++) {
-            tick(top.get(), sim_time);
-            connect_sdram(top.get(), sdram, conn);
+            if (!save_file.empty()) {
+                save_checkpoint(save_file, top.get(), sdram, conn, sim_time);
+                std::cout << std::format("Post-init checkpoint written to: {}\n", save_file);
+            }
         }
-        std::cout << "SDRAM controller initialized.\n";
 
         // ---------------------------------------------------------------
         // 5. Initialize command channel and start script thread
         // ---------------------------------------------------------------
         SimChannel cmd_channel;
         VsyncNotifier vsync_notifier;
+        TimestampLog timestamps;
 
-        std::jthread lua_thread([script_path, &cmd_channel, &vsync_notifier](
-                                    std::stop_token /*stop*/
-                                ) { lua_thread_func(script_path, cmd_channel, vsync_notifier); });
+        std::jthread lua_thread(
+            [script_path, &cmd_channel, &vsync_notifier, &timestamps](std::stop_token /*stop*/) {
+                lua_thread_func(script_path, cmd_channel, vsync_notifier, timestamps);
+            }
+        );
 
         // ---------------------------------------------------------------
         // 6. Main simulation loop
@@ -599,6 +678,7 @@ int main(int argc, char** argv) {
         bool running = true;
         uint8_t prev_vsync = 0;
         int pixel_count = 0;
+        int frame_count = 0;
         int tick_count = 0;
 
         std::cout << "Simulation running. Close the window or let the "
@@ -617,6 +697,11 @@ int main(int argc, char** argv) {
             {
                 SimCmd cmd;
                 if (!top->rootp->gpu_top->fifo_wr_almost_full && cmd_channel.try_pop(cmd)) {
+                    // Arm a PERF_TIMESTAMP slot as its marker enters the
+                    // FIFO, so an unexecuted marker reads back as such.
+                    if (cmd.rw == 0 && cmd.addr == REG_PERF_TIMESTAMP) {
+                        arm_perf_timestamp(sdram, static_cast<uint32_t>(cmd.wdata));
+                    }
                     top->rootp->gpu_top->sim_cmd_valid = 1;
                     top->rootp->gpu_top->sim_cmd_rw = cmd.rw;
                     top->rootp->gpu_top->sim_cmd_addr = cmd.addr;
@@ -656,6 +741,11 @@ int main(int argc, char** argv) {
                 SDL_RenderTexture(renderer.get(), texture.get(), nullptr, nullptr);
                 SDL_RenderPresent(renderer.get());
 
+                if (!dump_pattern.empty()) {
+                    dump_frame(dump_pattern, frame_count, disp_width, disp_height, pixel_buf);
+                }
+                frame_count++;
+
                 // Reset pixel counter for the next frame
                 pixel_count = 0;
 
@@ -697,6 +787,24 @@ int main(int argc, char** argv) {
         // Verilator finalization before model destruction
         top->final();
 
+        if (const SdramImage* image = sdram.image();
+            image && image->mode() == SdramImageMode::SHARED) {
+            image->sync();
+            std::cout << std::format("SDRAM image written to: {}\n", image->path());
+        }
+
+        if (!dump_pattern.empty()) {
+            std::cout << std::format(
+                "{} frames written as {}_NNNNN{}\n", frame_count,
+                (dump_pattern.parent_path() / dump_pattern.stem()).string(),
+                dump_pattern.extension().string()
+            );
+        }
+
+        if (auto marks = timestamps.snapshot(); !marks.empty()) {
+            std::cout << format_perf_timeline(sdram, marks);
+        }
+
         std::cout << std::format("Simulation complete. Total cycles: {}\n", sim_time / 2);
 
     } catch (const std::exception& e) {
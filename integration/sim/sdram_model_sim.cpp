@@ -15,6 +15,8 @@
 
 #include "sdram_model_sim.hpp"
 
+#include <algorithm>
+
 SdramModelSim::SdramModelSim() {
     reset();
 }
@@ -41,22 +43,62 @@ void SdramModelSim::reset() {
     mem_burst_done = 0;
 }
 
+SdramModelSim::SdramModelSim(const std::string& image_path, SdramImageMode mode)
+    : image_(std::make_unique<SdramImage>(image_path, TOTAL_WORDS, mode)) {
+    reset();
+    // Holes in the image file are zero; only pages overlapping its data
+    // extents need to be present up front.
+    for (auto [first, last] : image_->data_extents()) {
+        for (size_t page = first / PAGE_WORDS; page * PAGE_WORDS < last; page++) {
+            touch_page(static_cast<uint32_t>(page * PAGE_WORDS));
+        }
+    }
+}
+
+uint16_t* SdramModelSim::touch_page(uint32_t word_addr) {
+    auto& table = dir_[word_addr / (TABLE_ENTRIES * PAGE_WORDS)];
+    if (!table) {
+        table = std::make_unique<PageTable>(); // value-initialized: all nullptr
+    }
+    auto& page = (*table)[(word_addr / PAGE_WORDS) % TABLE_ENTRIES];
+    if (!page) {
+        if (image_) {
+            page = image_->data() + (word_addr / PAGE_WORDS) * PAGE_WORDS;
+        } else {
+            owned_pages_.push_back(std::make_unique<uint16_t[]>(PAGE_WORDS)); // zeroed
+            page = owned_pages_.back().get();
+        }
+        allocated_pages_++;
+    }
+    return page;
+}
+
+void SdramModelSim::clear_memory() {
+    if (image_) {
+        for_each_page([this](uint32_t first_word, std::span<const uint16_t>) {
+            std::fill_n(image_->data() + first_word, PAGE_WORDS, uint16_t{0});
+        });
+    }
+    for (auto& table : dir_) {
+        table.reset();
+    }
+    owned_pages_.clear();
+    allocated_pages_ = 0;
+}
+
 uint16_t SdramModelSim::read_word(uint32_t word_addr) const {
     if (word_addr >= TOTAL_WORDS) {
         return 0;
     }
-    auto it = mem_.find(word_addr);
-    if (it != mem_.end()) {
-        return it->second;
-    }
-    return 0;
+    const uint16_t* page = find_page(word_addr);
+    return page ? page[word_addr % PAGE_WORDS] : 0;
 }
 
 void SdramModelSim::write_word(uint32_t word_addr, uint16_t data) {
     if (word_addr >= TOTAL_WORDS) {
         return;
     }
-    mem_[word_addr] = data;
+    touch_page(word_addr)[word_addr % PAGE_WORDS] = data;
 }
 
 uint32_t SdramModelSim::read_word32(uint32_t byte_addr) const {
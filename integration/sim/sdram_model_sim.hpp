@@ -19,8 +19,15 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <unordered_map>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "sdram_image.hpp"
 
 /// SDRAM behavioral model state machine states.
 enum class SdramState : uint8_t {
@@ -39,8 +46,14 @@ enum class SdramState : uint8_t {
 /// timing for CAS latency, row activation, auto-refresh, and burst
 /// cancel/PRECHARGE sequencing.
 ///
-/// Memory is stored sparsely using an unordered_map to avoid allocating
-/// a full 32 MB array when only a fraction of addresses are used.
+/// Memory is stored sparsely in a two-level page table of lazily
+/// allocated 4 KB pages, so only the regions a program touches cost
+/// memory, while each access is two array indexings rather than a hash
+/// lookup.  Pages that were never written read as zero.
+///
+/// Optionally the pages live in a memory-mapped SDRAM image file
+/// (sdram_image.hpp) instead: the image's data regions are present from
+/// the start, and in SHARED mode every write also lands in the file.
 class SdramModelSim {
 public:
     // -- Timing constants (W9825G6KH at 100 MHz) --
@@ -87,6 +100,19 @@ public:
     /// Construct the SDRAM behavioral model.
     SdramModelSim();
 
+    /// Construct the model backed by a memory-mapped SDRAM image file.
+    ///
+    /// @param image_path  Image file (see SdramImage for the format).
+    /// @param mode        COPY_ON_WRITE (file is a preload) or SHARED
+    ///                    (writes land in the file).
+    /// @throws std::runtime_error if the image cannot be mapped.
+    SdramModelSim(const std::string& image_path, SdramImageMode mode);
+
+    /// Backing image, or nullptr for an anonymous model.
+    const SdramImage* image() const {
+        return image_.get();
+    }
+
     /// Evaluate one clock cycle of the SDRAM model.
     ///
     /// Must be called once per rising clock edge. Updates all output
@@ -123,6 +149,46 @@ public:
     /// Reset all internal state (state machine, counters, outputs).
     void reset();
 
+    /// Words per lazily allocated page (4 KB).
+    static constexpr uint32_t PAGE_WORDS = 2048;
+
+    /// Number of pages present (allocated, or mapped from the image).
+    size_t allocated_pages() const {
+        return allocated_pages_;
+    }
+
+    /// Visit every allocated page as fn(first_word_addr, words), in
+    /// ascending address order.  `words` is a std::span<const uint16_t> of
+    /// PAGE_WORDS words.  Used for checkpoint save.
+    template <typename Fn>
+    void for_each_page(Fn&& fn) const {
+        for (uint32_t dir = 0; dir < DIR_ENTRIES; dir++) {
+            if (!dir_[dir]) {
+                continue;
+            }
+            for (uint32_t t = 0; t < TABLE_ENTRIES; t++) {
+                if (const uint16_t* page = (*dir_[dir])[t]) {
+                    fn((dir * TABLE_ENTRIES + t) * PAGE_WORDS,
+                       std::span<const uint16_t>(page, PAGE_WORDS));
+                }
+            }
+        }
+    }
+
+    /// Return the page containing word_addr, allocating it if needed.
+    /// Used by checkpoint restore to fill memory in place.  word_addr must
+    /// be < TOTAL_WORDS.
+    ///
+    /// @return  The PAGE_WORDS words of the page.
+    std::span<uint16_t> writable_page(uint32_t word_addr) {
+        return {touch_page(word_addr), PAGE_WORDS};
+    }
+
+    /// Discard all memory contents (every word reads back as 0).
+    /// Image-backed pages are zeroed in place.  Used before checkpoint
+    /// restore.
+    void clear_memory();
+
     /// Return the current state machine state (for test inspection).
     SdramState current_state() const {
         return state_;
@@ -151,6 +217,34 @@ private:
 
     uint8_t cancel_pending_ = 0; ///< Burst cancel was requested
 
-    /// Sparse memory storage (word_addr -> 16-bit value).
-    std::unordered_map<uint32_t, uint16_t> mem_;
+    // -- Sparse memory storage --
+    //
+    // word_addr[23:18] indexes the directory, word_addr[17:11] the page
+    // table, and word_addr[10:0] the word within the page.
+
+    static constexpr uint32_t TABLE_ENTRIES = 128;
+    static constexpr uint32_t DIR_ENTRIES = TOTAL_WORDS / (TABLE_ENTRIES * PAGE_WORDS);
+    static_assert(DIR_ENTRIES * TABLE_ENTRIES * PAGE_WORDS == TOTAL_WORDS);
+
+    /// Page table entries point at PAGE_WORDS words, either an owned
+    /// allocation or a page of the mapped image; nullptr = not present.
+    using PageTable = std::array<uint16_t*, TABLE_ENTRIES>;
+
+    /// Return the page containing word_addr, or nullptr if never written.
+    const uint16_t* find_page(uint32_t word_addr) const {
+        const auto& table = dir_[word_addr / (TABLE_ENTRIES * PAGE_WORDS)];
+        if (!table) {
+            return nullptr;
+        }
+        return (*table)[(word_addr / PAGE_WORDS) % TABLE_ENTRIES];
+    }
+
+    /// Return the page containing word_addr, making it present (a zeroed
+    /// allocation, or the image page) on first touch.
+    uint16_t* touch_page(uint32_t word_addr);
+
+    std::array<std::unique_ptr<PageTable>, DIR_ENTRIES> dir_; ///< Page directory
+    std::vector<std::unique_ptr<uint16_t[]>> owned_pages_;    ///< Anonymous pages
+    std::unique_ptr<SdramImage> image_;                       ///< Mapped image file, if any
+    size_t allocated_pages_ = 0;                              ///< Pages present
 };
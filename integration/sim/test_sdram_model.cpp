@@ -8,6 +8,8 @@
 //   4. Burst cancel: mem_ack within tPRECHARGE=2 cycles after cancel.
 //   5. Single-word 32-bit read assembly.
 //   6. Burst write correctness.
+//   7. Refresh periodicity.
+//   8. Sparse page storage: zero reads, page-boundary writes, bounds.
 //
 // Spec-ref: unit_037_verilator_interactive_sim.md `1a4b995821bd694a` 2026-02-28
 //
@@ -18,6 +20,7 @@
 
 #include <array>
 #include <cstdio>
+#include <span>
 
 /// Aggregates test failure count across all test functions.
 struct TestResults {
@@ -535,6 +538,52 @@ static void test_refresh_periodicity(TestResults& results) {
     std::printf("  test_refresh_periodicity: PASS\n");
 }
 
+// -----------------------------------------------------------------------
+// Test 8: Sparse page storage
+// -----------------------------------------------------------------------
+static void test_sparse_pages(TestResults& results) {
+    std::printf("  test_sparse_pages...\n");
+    SdramModelSim model;
+    constexpr uint32_t PAGE = SdramModelSim::PAGE_WORDS;
+
+    TEST_ASSERT_EQ(results, model.allocated_pages(), size_t{0}, "Fresh model allocates nothing");
+    TEST_ASSERT_EQ(results, model.read_word(0x123456), uint16_t{0}, "Untouched word reads 0");
+    TEST_ASSERT_EQ(results, model.allocated_pages(), size_t{0}, "Reads do not allocate");
+
+    // Straddle a page boundary, then touch the last word of the address space.
+    model.write_word(PAGE - 1, 0x1111);
+    model.write_word(PAGE, 0x2222);
+    model.write_word(SdramModelSim::TOTAL_WORDS - 1, 0x3333);
+    model.write_word(SdramModelSim::TOTAL_WORDS, 0x4444); // ignored
+    TEST_ASSERT_EQ(results, model.read_word(PAGE - 1), uint16_t{0x1111}, "Page 0 tail");
+    TEST_ASSERT_EQ(results, model.read_word(PAGE), uint16_t{0x2222}, "Page 1 head");
+    TEST_ASSERT_EQ(results, model.read_word(PAGE + 1), uint16_t{0}, "Fresh page is zeroed");
+    TEST_ASSERT_EQ(
+        results, model.read_word(SdramModelSim::TOTAL_WORDS - 1), uint16_t{0x3333}, "Last word"
+    );
+    TEST_ASSERT_EQ(
+        results, model.read_word(SdramModelSim::TOTAL_WORDS), uint16_t{0}, "Out of range reads 0"
+    );
+    TEST_ASSERT_EQ(results, model.allocated_pages(), size_t{3}, "Three pages allocated");
+
+    // Pages are visited in ascending order.
+    uint32_t prev = 0;
+    bool ordered = true;
+    int visited = 0;
+    model.for_each_page([&](uint32_t first_word, std::span<const uint16_t> words) {
+        ordered = ordered && (visited == 0 || first_word > prev) && words.size() == PAGE;
+        prev = first_word;
+        visited++;
+    });
+    TEST_ASSERT(results, ordered && visited == 3, "for_each_page visits pages in order");
+
+    model.clear_memory();
+    TEST_ASSERT_EQ(results, model.allocated_pages(), size_t{0}, "clear_memory frees pages");
+    TEST_ASSERT_EQ(results, model.read_word(PAGE), uint16_t{0}, "Cleared word reads 0");
+
+    std::printf("  test_sparse_pages: PASS\n");
+}
+
 // -----------------------------------------------------------------------
 // Main
 // -----------------------------------------------------------------------
@@ -550,6 +599,7 @@ int main() {
     test_read_word32(results);
     test_burst_write(results);
     test_refresh_periodicity(results);
+    test_sparse_pages(results);
 
     std::printf("\n");
     if (results.failures == 0) {
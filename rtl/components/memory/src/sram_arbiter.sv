@@ -126,8 +126,8 @@ module sram_arbiter (
     // Internal State
     // ====================================================================
 
-    reg [1:0] granted_port;          // Currently granted port (0-3)
-    reg       grant_active;          // A grant is in progress
+    reg [1:0] granted_port /* verilator public */;  // Currently granted port (0-3)
+    reg       grant_active /* verilator public */;  // A grant is in progress
     reg       burst_active;          // A burst transfer is in progress
 
     // ====================================================================
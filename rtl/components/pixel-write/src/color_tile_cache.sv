@@ -98,6 +98,9 @@ module color_tile_cache (
     // ====================================================================
     // FSM States
     // ====================================================================
+    // Encodings are named in rtl/tb/unit_profile.cpp (CACHE_STATES, shared
+    // with zbuf_tile_cache.sv) for the harness --profile report;
+    // `make test-unit-profile` checks the match.
     typedef enum logic [3:0] {
         S_IDLE         = 4'd0,
         S_RD_HIT       = 4'd1,  // BRAM data ready — output rd_data + rd_valid
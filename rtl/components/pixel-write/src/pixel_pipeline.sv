@@ -252,6 +252,8 @@ module pixel_pipeline (
     // Pipeline FSM
     // ====================================================================
 
+    // Encodings are named in rtl/tb/unit_profile.cpp (PP_STATES) for the
+    // harness --profile report; `make test-unit-profile` checks the match.
     typedef enum logic [3:0] {
         PP_IDLE     = 4'd0,   // Accept new fragment, combinational tests
         PP_Z_READ   = 4'd1,   // Issue Z-buffer read request
@@ -159,6 +159,8 @@ module rasterizer (
     // Legacy single-state alias for sub-modules that test FSM state
     // (edge walk control signals, shared multiplier mux, etc.)
     // Combines setup and iteration states into a unified view.
+    // Encodings are named in rtl/tb/unit_profile.cpp (RAST_STATES) for the
+    // harness --profile report; `make test-unit-profile` checks the match.
     typedef enum logic [4:0] {
         IDLE            = 5'd0,
         SETUP           = 5'd1,
@@ -433,7 +435,7 @@ module rasterizer (
     //   Total: 129 + 40 + 24 + 480 + 60 = 733 bits
     localparam FIFO_WIDTH = 733;
 
-    wire                   fifo_wr_en;
+    wire                   fifo_wr_en /* verilator public */;  // Sampled by harness --tri-trace
     wire [FIFO_WIDTH-1:0]  fifo_wr_data;
     wire                   fifo_rd_en;
     wire [FIFO_WIDTH-1:0]  fifo_rd_data;
@@ -198,11 +198,11 @@ module register_file (
     reg [63:0] tex1_cfg_reg;            // TEX1_CFG register
     reg [15:0] palette0_base_r;         // PALETTE0 BASE_ADDR (LOAD_TRIGGER is fire-and-forget, not stored)
     reg [15:0] palette1_base_r;         // PALETTE1 BASE_ADDR (LOAD_TRIGGER is fire-and-forget, not stored)
-    reg [63:0] mem_addr_reg;            // MEM_ADDR register
+    reg [63:0] mem_addr_reg /* verilator public */; // MEM_ADDR register
     // mem_data write value is held in the mem_data_out output register
 
     // FB_DISPLAY blocking: pending value waits for vsync
-    reg        fb_display_pending;      // A pending FB_DISPLAY write is waiting
+    reg        fb_display_pending /* verilator public */; // A pending FB_DISPLAY write is waiting
     reg [63:0] fb_display_pending_val;  // Pending FB_DISPLAY value
 
     // FB_CACHE_CTRL blocking: command stream stalls until UNIT-013 acks flush/invalidate
@@ -286,6 +286,9 @@ module zbuf_tile_cache (
     // ====================================================================
     // FSM States
     // ====================================================================
+    // Encodings are named in rtl/tb/unit_profile.cpp (CACHE_STATES, shared
+    // with color_tile_cache.sv) for the harness --profile report;
+    // `make test-unit-profile` checks the match.
     typedef enum logic [3:0] {
         S_IDLE      = 4'd0,
         S_TAG_RD    = 4'd8,  // Wait 1 cycle for tag EBR read (slow path)
@@ -0,0 +1,195 @@
+// Microbenchmark for frame output (png_writer vs frame_writer).
+//
+// Encodes one synthetic 640x480 RGB565 frame (shaded background, flat and
+// Gouraud-like triangles, a noisy "textured" block) with:
+//
+//   * stb          -- png_writer::write_png(), the single-threaded
+//                     stb_image_write path, to a temp file read back
+//                     for the check (file I/O included in its time).
+//   * striped xN   -- frame_writer::encode_png() with N row stripes.
+//   * qoi          -- frame_writer::encode_qoi().
+//
+// Every PNG is decoded with png_reader and the QOI stream with a local
+// decoder; all must reproduce the frame exactly.  Reports ms/frame and
+// encoded size (the raw .rgb565 dump is 2 bytes per pixel, no encoding).
+//
+// Build and run: make bench-frame-writer  (from integration/)
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "frame_writer.hpp"
+#include "png_reader.hpp"
+#include "png_writer.hpp"
+
+namespace {
+
+constexpr int WIDTH = 640;
+constexpr int HEIGHT = 480;
+
+constexpr uint16_t pack_rgb565(int r, int g, int b) {
+    return static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+/// A frame with the mix a rendered scene has: large smooth regions, hard
+/// triangle edges, and a patch of high-frequency texture.
+std::vector<uint16_t> make_frame() {
+    std::vector<uint16_t> fb(static_cast<size_t>(WIDTH) * HEIGHT);
+    uint32_t lcg = 12345;
+    auto next = [&lcg] {
+        lcg = lcg * 1664525u + 1013904223u;
+        return lcg >> 8;
+    };
+
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            fb[static_cast<size_t>(y) * WIDTH + x] =
+                pack_rgb565(x * 255 / WIDTH, 64, y * 255 / HEIGHT);
+        }
+    }
+
+    // Triangles: half flat-shaded, half shaded by position.
+    for (int t = 0; t < 40; t++) {
+        int x0 = static_cast<int>(next() % WIDTH);
+        int y0 = static_cast<int>(next() % HEIGHT);
+        int size = 20 + static_cast<int>(next() % 120);
+        auto flat = static_cast<uint16_t>(next());
+        bool shaded = (t & 1) != 0;
+        for (int dy = 0; dy < size && y0 + dy < HEIGHT; dy++) {
+            for (int dx = 0; dx <= dy && x0 + dx < WIDTH; dx++) {
+                int v = 255 * dx / size;
+                fb[static_cast<size_t>(y0 + dy) * WIDTH + x0 + dx] =
+                    shaded ? pack_rgb565(v, 255 - v, 128) : flat;
+            }
+        }
+    }
+
+    // Noisy textured block.
+    for (int y = 300; y < 428; y++) {
+        for (int x = 40; x < 168; x++) {
+            fb[static_cast<size_t>(y) * WIDTH + x] = static_cast<uint16_t>(next());
+        }
+    }
+    return fb;
+}
+
+/// Decode a 3-channel QOI stream (enough of the format for the check).
+std::vector<uint8_t> decode_qoi(const std::vector<uint8_t>& qoi, size_t pixels) {
+    std::vector<uint8_t> rgb;
+    rgb.reserve(pixels * 3);
+    std::array<std::array<uint8_t, 3>, 64> index{};
+    std::array<uint8_t, 3> px = {0, 0, 0};
+    size_t p = 14;
+    while (rgb.size() < pixels * 3 && p < qoi.size()) {
+        uint8_t op = qoi[p++];
+        int run = 1;
+        if (op == 0xFE) {
+            px = {qoi[p], qoi[p + 1], qoi[p + 2]};
+            p += 3;
+        } else if ((op & 0xC0) == 0x00) {
+            px = index[op];
+        } else if ((op & 0xC0) == 0x40) {
+            px[0] = static_cast<uint8_t>(px[0] + ((op >> 4) & 3) - 2);
+            px[1] = static_cast<uint8_t>(px[1] + ((op >> 2) & 3) - 2);
+            px[2] = static_cast<uint8_t>(px[2] + (op & 3) - 2);
+        } else if ((op & 0xC0) == 0x80) {
+            int dg = (op & 0x3F) - 32;
+            uint8_t b2 = qoi[p++];
+            px[0] = static_cast<uint8_t>(px[0] + dg + ((b2 >> 4) & 0xF) - 8);
+            px[1] = static_cast<uint8_t>(px[1] + dg);
+            px[2] = static_cast<uint8_t>(px[2] + dg + (b2 & 0xF) - 8);
+        } else {
+            run = (op & 0x3F) + 1;
+        }
+        index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + 255 * 11) % 64] = px;
+        for (int i = 0; i < run; i++) {
+            rgb.insert(rgb.end(), px.begin(), px.end());
+        }
+    }
+    return rgb;
+}
+
+/// Best-of-`reps` wall time of `encode` in milliseconds.
+double time_ms(
+    int reps, const std::function<std::vector<uint8_t>()>& encode, std::vector<uint8_t>& out
+) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        auto start = std::chrono::steady_clock::now();
+        out = encode();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    constexpr int REPS = 10;
+    const std::vector<uint16_t> fb = make_frame();
+    const std::vector<uint8_t> expected = png_writer::rgb565_to_rgb888(fb);
+    bool ok = true;
+
+    std::cout << std::format("{}x{} RGB565 frame, best of {} runs\n", WIDTH, HEIGHT, REPS);
+    std::cout << std::format("  {:<12} {:>10} {:>10}\n", "encoder", "ms/frame", "bytes");
+
+    std::vector<uint8_t> bytes;
+    auto report_png = [&](const char* name, double ms) {
+        png_reader::RgbImage img = png_reader::decode_png(bytes);
+        bool match = img.width == WIDTH && img.height == HEIGHT && img.rgb == expected;
+        ok = ok && match;
+        std::cout << std::format("  {:<12} {:>10.2f} {:>10}{}\n", name, ms, bytes.size(),
+                                 match ? "" : "  MISMATCH");
+    };
+
+    const std::filesystem::path stb_path =
+        std::filesystem::temp_directory_path() / "bench_frame_writer_stb.png";
+    double stb_ms = time_ms(REPS, [&] {
+        png_writer::write_png(stb_path.c_str(), WIDTH, HEIGHT, fb);
+        std::ifstream in(stb_path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                    std::istreambuf_iterator<char>());
+    }, bytes);
+    std::filesystem::remove(stb_path);
+    report_png("stb", stb_ms);
+
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> thread_counts = {1};
+    for (unsigned n = 2; n < hw; n *= 2) {
+        thread_counts.push_back(n);
+    }
+    if (hw > 1) {
+        thread_counts.push_back(hw);
+    }
+    for (unsigned n : thread_counts) {
+        double ms = time_ms(
+            REPS, [&] { return frame_writer::encode_png(WIDTH, HEIGHT, fb, n); }, bytes
+        );
+        report_png(std::format("striped x{}", n).c_str(), ms);
+    }
+
+    double qoi_ms =
+        time_ms(REPS, [&] { return frame_writer::encode_qoi(WIDTH, HEIGHT, fb); }, bytes);
+    bool qoi_match = decode_qoi(bytes, fb.size()) == expected;
+    ok = ok && qoi_match;
+    std::cout << std::format("  {:<12} {:>10.2f} {:>10}{}\n", "qoi", qoi_ms, bytes.size(),
+                             qoi_match ? "" : "  MISMATCH");
+    std::cout << std::format("  {:<12} {:>10} {:>10}\n", "raw rgb565", "-", fb.size() * 2);
+
+    if (!ok) {
+        std::cerr << "ERROR: an encoder did not reproduce the frame\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Command FIFO occupancy telemetry implementation.
+//
+// See cmd_fifo_stats.hpp for what is measured.
+
+#include "cmd_fifo_stats.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+double percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+/// Number of occupancy ranges report() folds the histogram into.
+constexpr uint32_t REPORT_BUCKETS = 8;
+
+} // namespace
+
+CmdFifoStats::CmdFifoStats(uint32_t depth) : depth_(depth), histogram_(depth + 1, 0) {}
+
+void CmdFifoStats::sample(uint32_t occupancy, bool almost_full, bool full) {
+    occupancy = std::min(occupancy, depth_);
+    histogram_[occupancy]++;
+    cycles_++;
+    occupancy_sum_ += occupancy;
+    max_occupancy_ = std::max(max_occupancy_, occupancy);
+    almost_full_cycles_ += almost_full;
+    full_cycles_ += full;
+}
+
+uint32_t CmdFifoStats::percentile(double fraction) const {
+    auto target = static_cast<uint64_t>(fraction * static_cast<double>(cycles_));
+    uint64_t seen = 0;
+    for (uint32_t n = 0; n <= depth_; n++) {
+        seen += histogram_[n];
+        if (seen >= target && seen > 0) {
+            return n;
+        }
+    }
+    return max_occupancy_;
+}
+
+std::string CmdFifoStats::report() const {
+    std::string r = std::format(
+        "Command FIFO: {} cycles, depth {}, mean {:.1f}, p50 {}, p90 {}, p99 {}, max {} entries\n",
+        cycles_, depth_,
+        cycles_ ? static_cast<double>(occupancy_sum_) / static_cast<double>(cycles_) : 0.0,
+        percentile(0.5), percentile(0.9), percentile(0.99), max_occupancy_
+    );
+    r += std::format(
+        "  almost full {} cycles ({:.1f}%), full {} cycles ({:.1f}%), "
+        "host stalled on CMD_FULL {} cycles\n",
+        almost_full_cycles_, percent(almost_full_cycles_, cycles_), full_cycles_,
+        percent(full_cycles_, cycles_), host_stall_cycles_
+    );
+    r += std::format("  {:>11}  {:>10} cycles ({:5.1f}%)\n", "empty", histogram_[0],
+                     percent(histogram_[0], cycles_));
+    uint32_t width = std::max(1u, depth_ / REPORT_BUCKETS);
+    for (uint32_t lo = 1; lo <= depth_; lo += width) {
+        uint32_t hi = std::min(depth_, lo + width - 1);
+        uint64_t n = 0;
+        for (uint32_t k = lo; k <= hi; k++) {
+            n += histogram_[k];
+        }
+        r += std::format("  {:>5}-{:<5}  {:>10} cycles ({:5.1f}%)\n", lo, hi, n,
+                         percent(n, cycles_));
+    }
+    return r;
+}
+
+void CmdFifoStats::write_histogram_csv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error(std::format("cannot write FIFO histogram {}", path));
+    }
+    out << "occupancy,cycles,fraction\n";
+    for (uint32_t n = 0; n <= depth_; n++) {
+        out << std::format("{},{},{:.6f}\n", n, histogram_[n], percent(histogram_[n], cycles_) / 100.0);
+    }
+    if (!out) {
+        throw std::runtime_error(std::format("cannot write FIFO histogram {}", path));
+    }
+}
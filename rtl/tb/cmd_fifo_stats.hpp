@@ -0,0 +1,58 @@
+// Command FIFO occupancy telemetry for the harness_fifo build variant.
+//
+// The default harness writes straight into the register file
+// (SIM_DIRECT_REG), so command_fifo.sv (UNIT-002) never holds anything.
+// harness_fifo feeds the FIFO through the SIM_DIRECT_CMD ports, as
+// gpu_sim does, and CmdFifoStats samples it every cycle:
+//
+//   - an occupancy histogram (rd_count, one bin per entry count)
+//   - cycles with wr_almost_full set (the CMD_FULL the host sees) and
+//     with the FIFO completely full
+//   - cycles the host had a write ready but was held off by CMD_FULL
+//
+// Host stalls with the histogram's upper tail pressed against the
+// almost-full threshold mean a deeper FIFO would absorb the burst; a tail
+// that stays well below it means depth is not what limits the stream.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Per-cycle command FIFO occupancy statistics.
+class CmdFifoStats {
+public:
+    /// @param depth  FIFO depth in entries (command_fifo.sv DEPTH).
+    explicit CmdFifoStats(uint32_t depth);
+
+    /// Account one cycle: entries in the FIFO (read-side count) and the
+    /// write-side full flags.
+    void sample(uint32_t occupancy, bool almost_full, bool full);
+
+    /// Account one cycle the host waited on CMD_FULL with a write ready.
+    void host_stall() {
+        host_stall_cycles_++;
+    }
+
+    /// Multi-line summary: occupancy distribution, time at full, stalls.
+    std::string report() const;
+
+    /// Write the occupancy histogram as CSV, one row per entry count.
+    /// @throws std::runtime_error if the file cannot be written.
+    void write_histogram_csv(const std::string& path) const;
+
+    /// Smallest occupancy that at least `fraction` of the sampled cycles
+    /// did not exceed (0.5 = median).
+    uint32_t percentile(double fraction) const;
+
+private:
+    uint32_t depth_;
+    std::vector<uint64_t> histogram_; ///< Cycles per occupancy, depth + 1 bins
+    uint64_t cycles_ = 0;
+    uint64_t occupancy_sum_ = 0;
+    uint32_t max_occupancy_ = 0;
+    uint64_t almost_full_cycles_ = 0;
+    uint64_t full_cycles_ = 0;
+    uint64_t host_stall_cycles_ = 0;
+};
@@ -0,0 +1,176 @@
+// Compiled binary command streams: compiler and mmap loader.
+//
+// See cmd_stream.hpp for the file layout.
+
+#include "cmd_stream.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t RECORD_ALIGN = 16;
+
+/// Append the raw bytes of a trivially-copyable value.
+template <typename T>
+void append_pod(std::vector<uint8_t>& out, const T& value) {
+    const auto* p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(value));
+}
+
+} // namespace
+
+ScriptView view_script(const HexScript& script) {
+    ScriptView view;
+    view.fb_width = script.fb_width;
+    view.fb_height = script.fb_height;
+    view.textures = script.textures;
+    view.timestamps = script.timestamps;
+    view.phases.reserve(script.phases.size());
+    for (const auto& phase : script.phases) {
+        view.phases.push_back({phase.name, phase.commands});
+    }
+    return view;
+}
+
+std::vector<uint8_t> compile_cmd_stream(const HexScript& script) {
+    size_t names_offset =
+        sizeof(CmdStreamHeader) + script.phases.size() * sizeof(CmdStreamPhase);
+    size_t names_size = 0;
+    size_t record_count = 0;
+    for (const auto& phase : script.phases) {
+        names_size += phase.name.size();
+        record_count += phase.commands.size();
+    }
+    size_t records_offset = (names_offset + names_size + RECORD_ALIGN - 1) / RECORD_ALIGN * RECORD_ALIGN;
+
+    std::vector<uint8_t> out;
+    out.reserve(records_offset + record_count * sizeof(HexRegWrite));
+
+    CmdStreamHeader header{};
+    header.magic = CMD_STREAM_MAGIC;
+    header.fb_width = script.fb_width;
+    header.fb_height = script.fb_height;
+    header.phase_count = static_cast<uint32_t>(script.phases.size());
+    header.record_count = record_count;
+    header.records_offset = records_offset;
+    append_pod(out, header);
+
+    uint64_t first_record = 0;
+    size_t name_offset = names_offset;
+    for (const auto& phase : script.phases) {
+        CmdStreamPhase entry{};
+        entry.first_record = first_record;
+        entry.record_count = phase.commands.size();
+        entry.name_offset = static_cast<uint32_t>(name_offset);
+        entry.name_length = static_cast<uint32_t>(phase.name.size());
+        append_pod(out, entry);
+        first_record += phase.commands.size();
+        name_offset += phase.name.size();
+    }
+    for (const auto& phase : script.phases) {
+        out.insert(out.end(), phase.name.begin(), phase.name.end());
+    }
+    out.resize(records_offset, 0);
+
+    // Records are written byte by byte so the pad bytes are zero.
+    for (const auto& phase : script.phases) {
+        for (const auto& rw : phase.commands) {
+            std::array<uint8_t, sizeof(HexRegWrite)> rec{};
+            rec[0] = rw.addr;
+            std::memcpy(&rec[offsetof(HexRegWrite, data)], &rw.data, sizeof(rw.data));
+            out.insert(out.end(), rec.begin(), rec.end());
+        }
+    }
+    return out;
+}
+
+bool is_cmd_stream(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::array<char, 8> magic{};
+    file.read(magic.data(), magic.size());
+    return file && magic == CMD_STREAM_MAGIC;
+}
+
+CmdStream::CmdStream(const std::string& path) {
+    auto fail = [&path](const std::string& what) {
+        return std::runtime_error(std::format("command stream {}: {}", path, what));
+    };
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw fail(std::format("cannot open: {}", std::strerror(errno)));
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CmdStreamHeader)) {
+        ::close(fd);
+        throw fail("truncated header");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    void* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        throw fail(std::format("cannot map: {}", std::strerror(errno)));
+    }
+    base_ = static_cast<const uint8_t*>(map);
+
+    try {
+        CmdStreamHeader header;
+        std::memcpy(&header, base_, sizeof(header));
+        if (header.magic != CMD_STREAM_MAGIC) {
+            throw fail("bad magic (not a .pgcmd file, or an older format)");
+        }
+        if (header.records_offset % RECORD_ALIGN != 0 || header.records_offset > size_
+            || header.record_count > (size_ - header.records_offset) / sizeof(HexRegWrite)) {
+            throw fail("record table out of bounds");
+        }
+        size_t table_end =
+            sizeof(CmdStreamHeader) + size_t{header.phase_count} * sizeof(CmdStreamPhase);
+        if (table_end > header.records_offset) {
+            throw fail("phase table out of bounds");
+        }
+
+        // Zero-copy: the records are viewed in place.  mmap returns a
+        // page-aligned base and records_offset is 16-byte aligned.
+        std::span<const HexRegWrite> records(
+            reinterpret_cast<const HexRegWrite*>(base_ + header.records_offset),
+            header.record_count
+        );
+
+        view_.fb_width = header.fb_width;
+        view_.fb_height = header.fb_height;
+        view_.phases.reserve(header.phase_count);
+        for (uint32_t i = 0; i < header.phase_count; i++) {
+            CmdStreamPhase entry;
+            std::memcpy(
+                &entry, base_ + sizeof(CmdStreamHeader) + i * sizeof(CmdStreamPhase), sizeof(entry)
+            );
+            if (entry.first_record > records.size()
+                || entry.record_count > records.size() - entry.first_record
+                || size_t{entry.name_offset} + entry.name_length > header.records_offset) {
+                throw fail(std::format("phase {} out of bounds", i));
+            }
+            view_.phases.push_back({
+                std::string_view(
+                    reinterpret_cast<const char*>(base_ + entry.name_offset), entry.name_length
+                ),
+                records.subspan(entry.first_record, entry.record_count),
+            });
+        }
+    } catch (...) {
+        ::munmap(const_cast<uint8_t*>(base_), size_);
+        throw;
+    }
+}
+
+CmdStream::~CmdStream() {
+    ::munmap(const_cast<uint8_t*>(base_), size_);
+}
@@ -0,0 +1,126 @@
+// Compiled binary command streams for the integration harness.
+//
+// A .pgcmd file is a parsed hex script (hex_parser.hpp) laid out so the
+// harness can mmap it and hand each phase to execute_script() as a
+// std::span<const HexRegWrite> without parsing or copying.  It is meant
+// for multi-megabyte captured command streams where text parsing would
+// dominate start-up.
+//
+// File layout (all integers little-endian):
+//
+//   CmdStreamHeader      magic "PGSCMD01", framebuffer size, phase count,
+//                        record count, records offset
+//   CmdStreamPhase[n]    first record, record count, name offset/length
+//   phase names          UTF-8, not NUL-terminated
+//   (zero padding to a 16-byte boundary)
+//   records[m]           HexRegWrite in its native 16-byte layout:
+//                        addr:u8, 7 zero pad bytes, data:u64
+//
+// Records use the in-memory HexRegWrite layout rather than a packed 9-byte
+// form so a mapped file can be viewed as HexRegWrite directly.
+// '## TEXTURE:' directives are not carried (no active script uses them),
+// nor are '## TIMESTAMP:' labels: the marker writes stay in the records,
+// but a run from a .pgcmd file prints no timestamp timeline.
+//
+// The text format stays the source of truth: compile with
+//   hex_compile <script.hex> <script.pgcmd>
+// and pass either file to `harness --script`.
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hex_parser.hpp"
+
+static_assert(std::endian::native == std::endian::little,
+              "command streams are mapped in place and stored little-endian");
+static_assert(sizeof(HexRegWrite) == 16 && offsetof(HexRegWrite, data) == 8,
+              "command-stream records mirror the HexRegWrite layout");
+
+/// File magic; bump the trailing digits when the layout changes.
+inline constexpr std::array<char, 8> CMD_STREAM_MAGIC = {'P', 'G', 'S', 'C', 'M', 'D', '0', '1'};
+
+/// Fixed-size file header.
+struct CmdStreamHeader {
+    std::array<char, 8> magic;
+    int32_t fb_width;
+    int32_t fb_height;
+    uint32_t phase_count;
+    uint32_t reserved; ///< Zero
+    uint64_t record_count;
+    uint64_t records_offset; ///< Byte offset of records[0] (16-byte aligned)
+};
+static_assert(sizeof(CmdStreamHeader) == 40);
+
+/// Phase table entry.
+struct CmdStreamPhase {
+    uint64_t first_record;
+    uint64_t record_count;
+    uint32_t name_offset; ///< Byte offset of the name from the file start
+    uint32_t name_length;
+};
+static_assert(sizeof(CmdStreamPhase) == 24);
+
+/// One phase of a script, viewed in place.
+struct ScriptPhaseView {
+    std::string_view name;
+    std::span<const HexRegWrite> commands;
+};
+
+/// Non-owning view of a script, from a parsed HexScript or a mapped
+/// CmdStream.  The owner must outlive the view.
+struct ScriptView {
+    int fb_width = 0;
+    int fb_height = 0;
+    std::vector<ScriptPhaseView> phases;
+    std::span<const TextureDirective> textures;
+    std::span<const TimestampDirective> timestamps;
+
+    /// Total register writes across all phases.
+    size_t command_count() const {
+        size_t n = 0;
+        for (const auto& phase : phases) {
+            n += phase.commands.size();
+        }
+        return n;
+    }
+};
+
+/// View a parsed hex script.
+ScriptView view_script(const HexScript& script);
+
+/// Serialize a parsed hex script to the .pgcmd layout.
+std::vector<uint8_t> compile_cmd_stream(const HexScript& script);
+
+/// Return true if `path` starts with CMD_STREAM_MAGIC.
+bool is_cmd_stream(const std::string& path);
+
+/// Read-only mapping of a .pgcmd file.
+class CmdStream {
+public:
+    /// Map and validate `path`.
+    /// @throws std::runtime_error if the file cannot be mapped or is not a
+    ///         well-formed command stream.
+    explicit CmdStream(const std::string& path);
+    ~CmdStream();
+
+    CmdStream(const CmdStream&) = delete;
+    CmdStream& operator=(const CmdStream&) = delete;
+
+    /// View of the mapped script; valid while this object lives.
+    const ScriptView& view() const {
+        return view_;
+    }
+
+private:
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    ScriptView view_;
+};
@@ -0,0 +1,160 @@
+// Header-only backdoor for memory upload writes (harness --fast-upload).
+//
+// MEM_ADDR (0x70), MEM_DATA (0x71) and MEM_FILL (0x44) go through the
+// register file and mem_dma like any other command: two harness cycles
+// per write, plus the gpu_busy stall while mem_dma bursts the data (one
+// arbiter grant per word for MEM_FILL).  Upload-heavy scripts such as
+// VER-017 spend most of their cycles there.  FastUpload applies the same
+// writes straight to the SDRAM model instead, producing exactly the words
+// the RTL path would:
+//
+//   * MEM_ADDR loads the 64-bit pointer register; bits [21:0] are the
+//     dword address (register_file.sv).
+//   * MEM_DATA writes DATA[15:0], [31:16], [47:32], [63:48] to four
+//     consecutive columns from byte address {dword[21:0], 2'b00}
+//     (mem_dma.sv, col_step2 = 0), then increments the pointer.
+//   * MEM_FILL writes VALUE = DATA[39:24] to COUNT = DATA[59:40] words at
+//     byte addresses {BASE[22:0], 1'b0} + 2*i, BASE = DATA[23:0]
+//     (mem_dma.sv, col_step2 = 1).
+//
+// Byte addresses become model word addresses the way sdram_controller.sv
+// splits them (bank = [23:22], row = [21:9], column = [8:1]) and
+// SdramPinAdapter recombines them: (bank << 23) | (row << 9) | column.
+//
+// Upload writes may only take the backdoor on a drained pipeline, when no
+// earlier command still has SDRAM traffic in flight that the RTL would
+// order around them.  Phases start drained, so a phase's leading run of
+// uploads goes straight through.  Any other write ends the run: it goes
+// through RTL, and the harness drains the pipeline before the next run of
+// uploads (VER-017's palette phase, for instance, is palette uploads, a
+// PALETTE0 load trigger, then the index uploads).  When a run ends,
+// sync_write() yields the MEM_ADDR write that brings the RTL pointer up
+// to date, so the register file matches the backdoor's view (checkpoints,
+// later phases without --fast-upload).
+
+#ifndef FAST_UPLOAD_HPP
+#define FAST_UPLOAD_HPP
+
+#include <cstdint>
+#include <span>
+
+#include "hex_parser.hpp"
+
+/// MEM_FILL register index (INT-010).
+inline constexpr uint8_t REG_MEM_FILL = 0x44;
+
+/// MEM_ADDR register index (INT-010).
+inline constexpr uint8_t REG_MEM_ADDR = 0x70;
+
+/// MEM_DATA register index (INT-010).
+inline constexpr uint8_t REG_MEM_DATA = 0x71;
+
+/// Applies MEM_ADDR / MEM_DATA / MEM_FILL writes to an SDRAM model
+/// (anything with write_word() on 16-bit word addresses).
+class FastUpload {
+public:
+    /// @param mem_addr  Current value of the RTL MEM_ADDR register.
+    explicit FastUpload(uint64_t mem_addr = 0) : mem_addr_(mem_addr) {}
+
+    /// True for the register writes apply() handles.
+    static bool is_upload(uint8_t addr) {
+        return addr == REG_MEM_ADDR || addr == REG_MEM_DATA || addr == REG_MEM_FILL;
+    }
+
+    /// Apply one upload write.
+    /// @return false (nothing applied) if `w` is not an upload write.
+    template <typename Memory>
+    bool apply(Memory& sdram, const HexRegWrite& w) {
+        switch (w.addr) {
+            case REG_MEM_ADDR:
+                mem_addr_ = w.data;
+                pointer_moved_ = true;
+                break;
+            case REG_MEM_DATA: {
+                uint32_t byte_addr = (static_cast<uint32_t>(mem_addr_) & 0x3F'FFFF) << 2;
+                uint32_t word = model_addr(byte_addr);
+                for (int k = 0; k < 4; k++) {
+                    sdram.write_word(word + k, static_cast<uint16_t>(w.data >> (16 * k)));
+                }
+                mem_addr_++;
+                pointer_moved_ = true;
+                words_ += 4;
+                break;
+            }
+            case REG_MEM_FILL: {
+                uint32_t byte_addr = (static_cast<uint32_t>(w.data) & 0x7F'FFFF) << 1;
+                auto value = static_cast<uint16_t>(w.data >> 24);
+                auto count = static_cast<uint32_t>(w.data >> 40) & 0xF'FFFF;
+                for (uint32_t i = 0; i < count; i++) {
+                    sdram.write_word(model_addr(byte_addr), value);
+                    byte_addr = (byte_addr + 2) & 0xFF'FFFF;
+                }
+                words_ += count;
+                break;
+            }
+            default:
+                return false;
+        }
+        writes_++;
+        return true;
+    }
+
+    /// Apply the leading run of upload writes in `script`.
+    /// @return Number of writes applied (the run's length).
+    template <typename Memory>
+    size_t apply_prefix(Memory& sdram, std::span<const HexRegWrite> script) {
+        size_t n = 0;
+        while (n < script.size() && apply(sdram, script[n])) {
+            n++;
+        }
+        return n;
+    }
+
+    /// Length of the leading run of non-upload writes in `script`: the
+    /// writes that must go through RTL before the next backdoor run.
+    static size_t rtl_prefix(std::span<const HexRegWrite> script) {
+        size_t n = 0;
+        while (n < script.size() && !is_upload(script[n].addr)) {
+            n++;
+        }
+        return n;
+    }
+
+    /// True when MEM_ADDR or MEM_DATA moved the pointer since the last
+    /// sync_write().
+    bool needs_sync() const {
+        return pointer_moved_;
+    }
+
+    /// MEM_ADDR write that sets the RTL pointer to the backdoor's value.
+    HexRegWrite sync_write() {
+        pointer_moved_ = false;
+        return {REG_MEM_ADDR, mem_addr_};
+    }
+
+    /// Upload writes applied so far.
+    uint64_t writes() const {
+        return writes_;
+    }
+
+    /// 16-bit SDRAM words written so far.
+    uint64_t words() const {
+        return words_;
+    }
+
+    /// SDRAM model word address of controller byte address `byte_addr`.
+    static uint32_t model_addr(uint32_t byte_addr) {
+        uint32_t bank = (byte_addr >> 22) & 0x3;
+        uint32_t row = (byte_addr >> 9) & 0x1FFF;
+        uint32_t col = byte_addr & 0x1FE;
+        return (bank << 23) | (row << 9) | col;
+    }
+
+private:
+    uint64_t mem_addr_;
+    bool pointer_moved_ = false;
+    uint64_t writes_ = 0;
+    uint64_t words_ = 0;
+};
+
+#endif // FAST_UPLOAD_HPP
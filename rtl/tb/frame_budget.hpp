@@ -0,0 +1,101 @@
+// Header-only per-frame cycle budget report for multi-frame runs
+// (harness --frames).
+//
+// Every golden scene renders one frame, which says nothing about
+// sustained throughput.  With --frames N the harness replays the scene's
+// per-frame phases N times; each frame ends with a drain, an FB_DISPLAY
+// present and a wait for the vsync that latches it.  FrameCycles records
+// the two parts separately: render cycles are the GPU's work for the
+// frame, the vsync wait is what double buffering would hide.
+//
+// Every frame renders into and re-presents the buffer FB_CONFIG names;
+// the harness does not alternate framebuffers, because the color tile
+// cache is not tagged with the buffer base and retargeting it per frame
+// would need an invalidate the single-frame goldens never exercise.
+//
+// Frame 0 also runs the scene's one-time setup and upload phases, so it
+// is reported on its own warm-up line and left out of the statistics.
+//
+// Frame times are projected at the 100 MHz core clock (clk_core) against
+// the 60 Hz budget of 1,666,666 cycles per frame.
+
+#ifndef FRAME_BUDGET_HPP
+#define FRAME_BUDGET_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Core clock the cycle counts are projected at (clk_core).
+inline constexpr uint64_t CORE_CLOCK_HZ = 100'000'000;
+
+/// Target display refresh rate.
+inline constexpr uint64_t TARGET_FPS = 60;
+
+/// Core cycles available per frame at TARGET_FPS.
+inline constexpr uint64_t FRAME_BUDGET_CYCLES = CORE_CLOCK_HZ / TARGET_FPS;
+
+/// Cycle accounting for one rendered frame.
+struct FrameCycles {
+    uint64_t render = 0;     ///< Script injection + drain to idle
+    uint64_t vsync_wait = 0; ///< Present until the FB_DISPLAY latched at vsync
+};
+
+/// One report line for a frame.
+inline std::string format_frame_line(std::string_view label, const FrameCycles& f) {
+    return std::format(
+        "  {:<10} {:>10} render  {:>10} vsync wait  {:5.1f}% of budget\n", label, f.render,
+        f.vsync_wait, 100.0 * static_cast<double>(f.render) / FRAME_BUDGET_CYCLES);
+}
+
+/// Multi-line report: the warm-up frame 0, each steady-state frame, then
+/// min / avg / p99 / max render cycles, projected FPS and how many
+/// steady-state frames overran the 60 Hz budget.  A lone frame is its
+/// own statistic, since there is no steady state to separate it from.
+inline std::string format_frame_report(std::span<const FrameCycles> frames) {
+    if (frames.empty()) {
+        return {};
+    }
+    std::string r = std::format("Frames ({} rendered):\n", frames.size());
+    std::span<const FrameCycles> steady = frames;
+    if (frames.size() > 1) {
+        r += format_frame_line("warm-up 0", frames.front());
+        steady = frames.subspan(1);
+    }
+    std::vector<uint64_t> render;
+    render.reserve(steady.size());
+    uint64_t total = 0;
+    size_t over_budget = 0;
+    for (size_t i = 0; i < steady.size(); i++) {
+        const FrameCycles& f = steady[i];
+        r += format_frame_line(std::format("frame {}", frames.size() - steady.size() + i), f);
+        render.push_back(f.render);
+        total += f.render;
+        over_budget += f.render > FRAME_BUDGET_CYCLES;
+    }
+
+    std::ranges::sort(render);
+    // Nearest-rank p99: the smallest value at least 99% of frames do not exceed.
+    size_t p99_rank = (render.size() * 99 + 99) / 100;
+    uint64_t p99 = render[std::max<size_t>(p99_rank, 1) - 1];
+    double avg = static_cast<double>(total) / static_cast<double>(render.size());
+    if (steady.size() < frames.size()) {
+        r += std::format("  steady state (frames 1-{}):\n", frames.size() - 1);
+    }
+    r += std::format(
+        "  render cycles: min {}  avg {:.0f}  p99 {}  max {}\n", render.front(), avg, p99,
+        render.back());
+    r += std::format(
+        "  projected at {} MHz: {:.1f} FPS avg, {:.1f} FPS at p99; {} of {} frames over the "
+        "{} Hz budget ({} cycles)\n",
+        CORE_CLOCK_HZ / 1'000'000, static_cast<double>(CORE_CLOCK_HZ) / avg,
+        static_cast<double>(CORE_CLOCK_HZ) / static_cast<double>(std::max<uint64_t>(p99, 1)),
+        over_budget, steady.size(), TARGET_FPS, FRAME_BUDGET_CYCLES);
+    return r;
+}
+
+#endif // FRAME_BUDGET_HPP
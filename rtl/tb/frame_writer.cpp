@@ -0,0 +1,401 @@
+// Fast frame output implementation: striped parallel PNG, QOI, raw RGB565.
+//
+// See frame_writer.hpp for the stream layout.  Rows use the same adaptive
+// filter choice as stb_image_write; each stripe is deflated by zlib at
+// its fastest level.  The zlib stream around the stripes (header, Adler-32
+// trailer) and the PNG chunks are assembled here, since zlib's own
+// wrapper cannot join independently compressed pieces.
+//
+// References:
+//   RFC 1950 (zlib), RFC 1951 (deflate), PNG specification (ISO 15948)
+//   QOI specification 1.0 (qoiformat.org)
+
+#include "frame_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <zlib.h>
+
+#include "png_writer.hpp"
+
+namespace frame_writer {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Deflate (zlib)
+// ---------------------------------------------------------------------------
+
+constexpr int MIN_STRIPE_ROWS = 16;
+
+/// Deflate `data` as one raw deflate stream at Z_BEST_SPEED.  A non-final
+/// stripe ends with a sync flush (an empty stored block, no BFINAL), so
+/// the output ends byte-aligned and the next stripe's stream can be
+/// appended directly.  Runs on worker threads, so failure is returned
+/// rather than thrown.
+bool deflate_stripe(std::span<const uint8_t> data, bool final, std::vector<uint8_t>& out) {
+    z_stream zs{};
+    // Negative window bits: raw deflate, no zlib header or trailer.
+    if (deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    // deflateBound() covers Z_FINISH; a sync flush adds at most 5 bytes.
+    out.resize(deflateBound(&zs, static_cast<uLong>(data.size())) + 8);
+    zs.next_in = const_cast<Bytef*>(data.data());
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = out.data();
+    zs.avail_out = static_cast<uInt>(out.size());
+    int ret = deflate(&zs, final ? Z_FINISH : Z_SYNC_FLUSH);
+    out.resize(zs.total_out);
+    deflateEnd(&zs);
+    return ret == (final ? Z_STREAM_END : Z_OK) && zs.avail_in == 0;
+}
+
+uint32_t adler32(std::span<const uint8_t> data) {
+    return static_cast<uint32_t>(
+        ::adler32(::adler32(0, nullptr, 0), data.data(), static_cast<uInt>(data.size())));
+}
+
+uint32_t crc32(std::span<const uint8_t> data) {
+    return static_cast<uint32_t>(
+        ::crc32(::crc32(0, nullptr, 0), data.data(), static_cast<uInt>(data.size())));
+}
+
+// ---------------------------------------------------------------------------
+// PNG assembly
+// ---------------------------------------------------------------------------
+
+void put_be32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void put_chunk(std::vector<uint8_t>& png, const char* type, std::span<const uint8_t> data) {
+    put_be32(png, static_cast<uint32_t>(data.size()));
+    size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+    put_be32(png, crc32(std::span(png).subspan(start)));
+}
+
+int paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+}
+
+/// Filters rows with the filter type whose output has the smallest sum
+/// of absolute signed values, the usual adaptive heuristic.  All five
+/// candidates are produced in one pass over the row.
+class RowFilter {
+public:
+    explicit RowFilter(size_t row_bytes) {
+        for (auto& c : candidates_) {
+            c.resize(row_bytes);
+        }
+    }
+
+    /// Append the type byte and filtered `row` to `out`.  `above` is the
+    /// previous image row (all zero for the first one).
+    void filter(
+        std::span<const uint8_t> row, std::span<const uint8_t> above, std::vector<uint8_t>& out
+    ) {
+        // One branch-free loop per filter type so they vectorize.  The
+        // first pixel has no left neighbours (a = c = 0), so Sub and Paeth
+        // degenerate to None and Up there, and Average to x - b / 2.
+        constexpr size_t BPP = 3;
+        // Raw pointers: byte stores through the vectors' operator[] may
+        // alias their own data pointers, which blocks vectorization.
+        const size_t n = row.size();
+        const uint8_t* x = row.data();
+        const uint8_t* b = above.data();
+        uint8_t* none = candidates_[0].data();
+        uint8_t* sub = candidates_[1].data();
+        uint8_t* up = candidates_[2].data();
+        uint8_t* avg = candidates_[3].data();
+        uint8_t* pth = candidates_[4].data();
+        for (size_t k = 0; k < BPP; k++) {
+            sub[k] = x[k];
+            avg[k] = static_cast<uint8_t>(x[k] - (b[k] >> 1));
+            pth[k] = static_cast<uint8_t>(x[k] - b[k]);
+        }
+        for (size_t k = 0; k < n; k++) {
+            none[k] = x[k];
+            up[k] = static_cast<uint8_t>(x[k] - b[k]);
+        }
+        for (size_t k = BPP; k < n; k++) {
+            sub[k] = static_cast<uint8_t>(x[k] - x[k - BPP]);
+            avg[k] = static_cast<uint8_t>(x[k] - ((x[k - BPP] + b[k]) >> 1));
+        }
+        for (size_t k = BPP; k < n; k++) {
+            pth[k] = static_cast<uint8_t>(x[k] - paeth(x[k - BPP], b[k], b[k - BPP]));
+        }
+
+        // Row sums stay far below 2^31 (at most 128 per byte).
+        std::array<int, 5> cost{};
+        for (size_t t = 0; t < 5; t++) {
+            for (uint8_t v : candidates_[t]) {
+                cost[t] += std::abs(static_cast<int8_t>(v));
+            }
+        }
+        auto best = static_cast<size_t>(std::ranges::min_element(cost) - cost.begin());
+        out.push_back(static_cast<uint8_t>(best));
+        out.insert(out.end(), candidates_[best].begin(), candidates_[best].end());
+    }
+
+private:
+    std::array<std::vector<uint8_t>, 5> candidates_;
+};
+
+/// One stripe's share of the zlib stream.
+struct Stripe {
+    std::vector<uint8_t> deflated;
+    uint32_t adler = 1;
+    size_t raw_bytes = 0; ///< Filtered bytes (the Adler-32 input length)
+    bool ok = false;      ///< deflate_stripe() succeeded
+};
+
+void encode_stripe(
+    int width, int y0, int y1, bool final, std::span<const uint8_t> rgb, Stripe& stripe
+) {
+    const size_t row_bytes = static_cast<size_t>(width) * 3;
+    const std::vector<uint8_t> zero_row(row_bytes);
+    RowFilter row_filter(row_bytes);
+    std::vector<uint8_t> filtered;
+    filtered.reserve(static_cast<size_t>(y1 - y0) * (row_bytes + 1));
+    for (int y = y0; y < y1; y++) {
+        auto row = rgb.subspan(static_cast<size_t>(y) * row_bytes, row_bytes);
+        auto above = y == 0 ? std::span<const uint8_t>(zero_row)
+                            : rgb.subspan(static_cast<size_t>(y - 1) * row_bytes, row_bytes);
+        row_filter.filter(row, above, filtered);
+    }
+    stripe.raw_bytes = filtered.size();
+    stripe.adler = adler32(filtered);
+    stripe.ok = deflate_stripe(filtered, final, stripe.deflated);
+}
+
+void check_dimensions(const char* what, int width, int height, size_t bytes, size_t bytes_per_px) {
+    if (width <= 0 || height <= 0
+        || bytes < static_cast<size_t>(width) * static_cast<size_t>(height) * bytes_per_px) {
+        throw std::runtime_error(std::format("{}: invalid parameters", what));
+    }
+}
+
+void write_bytes(const std::filesystem::path& path, std::span<const uint8_t> bytes) {
+    std::ofstream f(path, std::ios::binary);
+    f.write(
+        reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())
+    );
+    if (!f) {
+        throw std::runtime_error("write_frame: failed to write frame file");
+    }
+}
+
+} // namespace
+
+FrameFormat frame_format(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    std::ranges::transform(ext, ext.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    if (ext == ".qoi") {
+        return FrameFormat::QOI;
+    }
+    if (ext == ".rgb565") {
+        return FrameFormat::RGB565;
+    }
+    return FrameFormat::PNG;
+}
+
+std::vector<uint8_t> encode_png(
+    int width, int height, std::span<const uint8_t> rgb, unsigned threads
+) {
+    check_dimensions("encode_png", width, height, rgb.size(), 3);
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    int stripes = std::clamp(static_cast<int>(threads), 1, std::max(1, height / MIN_STRIPE_ROWS));
+
+    // Stripes are contiguous row ranges; the first height % stripes get
+    // one extra row.
+    std::vector<Stripe> parts(static_cast<size_t>(stripes));
+    {
+        std::vector<std::jthread> workers;
+        int y = 0;
+        for (int s = 0; s < stripes; s++) {
+            int rows = height / stripes + (s < height % stripes ? 1 : 0);
+            int y0 = y;
+            y += rows;
+            bool final = s == stripes - 1;
+            auto& part = parts[static_cast<size_t>(s)];
+            if (final) {
+                encode_stripe(width, y0, y, final, rgb, part);
+            } else {
+                workers.emplace_back([=, &part] { encode_stripe(width, y0, y, final, rgb, part); });
+            }
+        }
+    } // join
+
+    std::vector<uint8_t> zlib = {0x78, 0x01}; // deflate, 32K window, fastest
+    uint32_t adler = 1;
+    for (const auto& part : parts) {
+        if (!part.ok) {
+            throw std::runtime_error("encode_png: deflate failed");
+        }
+        zlib.insert(zlib.end(), part.deflated.begin(), part.deflated.end());
+        adler = static_cast<uint32_t>(
+            adler32_combine(adler, part.adler, static_cast<z_off_t>(part.raw_bytes)));
+    }
+    put_be32(zlib, adler);
+
+    std::vector<uint8_t> ihdr;
+    put_be32(ihdr, static_cast<uint32_t>(width));
+    put_be32(ihdr, static_cast<uint32_t>(height));
+    ihdr.insert(ihdr.end(), {8, 2, 0, 0, 0}); // 8-bit RGB, deflate, adaptive, no interlace
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    png.reserve(zlib.size() + 64);
+    put_chunk(png, "IHDR", ihdr);
+    put_chunk(png, "IDAT", zlib);
+    put_chunk(png, "IEND", {});
+    return png;
+}
+
+std::vector<uint8_t> encode_png(
+    int width, int height, std::span<const uint16_t> framebuffer, unsigned threads
+) {
+    check_dimensions("encode_png", width, height, framebuffer.size(), 1);
+    return encode_png(width, height, png_writer::rgb565_to_rgb888(framebuffer), threads);
+}
+
+// ---------------------------------------------------------------------------
+// QOI
+// ---------------------------------------------------------------------------
+
+std::vector<uint8_t> encode_qoi(int width, int height, std::span<const uint8_t> rgb) {
+    check_dimensions("encode_qoi", width, height, rgb.size(), 3);
+
+    constexpr uint8_t QOI_OP_INDEX = 0x00;
+    constexpr uint8_t QOI_OP_DIFF = 0x40;
+    constexpr uint8_t QOI_OP_LUMA = 0x80;
+    constexpr uint8_t QOI_OP_RUN = 0xC0;
+    constexpr uint8_t QOI_OP_RGB = 0xFE;
+
+    const size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    std::vector<uint8_t> out = {'q', 'o', 'i', 'f'};
+    out.reserve(14 + pixels * 4 + 8);
+    put_be32(out, static_cast<uint32_t>(width));
+    put_be32(out, static_cast<uint32_t>(height));
+    out.push_back(3); // channels
+    out.push_back(0); // sRGB with linear alpha
+
+    // Alpha is always 255, so it only enters the index hash (as 255 * 11).
+    std::array<std::array<uint8_t, 3>, 64> index{};
+    std::array<uint8_t, 3> prev = {0, 0, 0};
+    int run = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        std::array<uint8_t, 3> px = {rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]};
+        if (px == prev) {
+            run++;
+            if (run == 62 || i + 1 == pixels) {
+                out.push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            out.push_back(static_cast<uint8_t>(QOI_OP_RUN | (run - 1)));
+            run = 0;
+        }
+
+        size_t slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + 255 * 11) % 64;
+        if (index[slot] == px) {
+            out.push_back(static_cast<uint8_t>(QOI_OP_INDEX | slot));
+        } else {
+            index[slot] = px;
+            auto dr = static_cast<int8_t>(px[0] - prev[0]);
+            auto dg = static_cast<int8_t>(px[1] - prev[1]);
+            auto db = static_cast<int8_t>(px[2] - prev[2]);
+            int dr_dg = dr - dg;
+            int db_dg = db - dg;
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                out.push_back(
+                    static_cast<uint8_t>(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2))
+                );
+            } else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8
+                       && db_dg <= 7) {
+                out.push_back(static_cast<uint8_t>(QOI_OP_LUMA | (dg + 32)));
+                out.push_back(static_cast<uint8_t>((dr_dg + 8) << 4 | (db_dg + 8)));
+            } else {
+                out.insert(out.end(), {QOI_OP_RGB, px[0], px[1], px[2]});
+            }
+        }
+        prev = px;
+    }
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1}); // end marker
+    return out;
+}
+
+std::vector<uint8_t> encode_qoi(int width, int height, std::span<const uint16_t> framebuffer) {
+    check_dimensions("encode_qoi", width, height, framebuffer.size(), 1);
+    return encode_qoi(width, height, png_writer::rgb565_to_rgb888(framebuffer));
+}
+
+// ---------------------------------------------------------------------------
+// Frame files
+// ---------------------------------------------------------------------------
+
+void write_frame(
+    const std::filesystem::path& path, int width, int height,
+    std::span<const uint16_t> framebuffer
+) {
+    switch (frame_format(path)) {
+    case FrameFormat::QOI:
+        write_bytes(path, encode_qoi(width, height, framebuffer));
+        break;
+    case FrameFormat::RGB565: {
+        check_dimensions("write_frame", width, height, framebuffer.size(), 1);
+        size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+        std::vector<uint8_t> raw;
+        raw.reserve(pixels * 2);
+        for (uint16_t px : framebuffer.first(pixels)) {
+            raw.push_back(static_cast<uint8_t>(px));
+            raw.push_back(static_cast<uint8_t>(px >> 8));
+        }
+        write_bytes(path, raw);
+        break;
+    }
+    case FrameFormat::PNG:
+        write_bytes(path, encode_png(width, height, framebuffer));
+        break;
+    }
+}
+
+void write_frame(
+    const std::filesystem::path& path, int width, int height, std::span<const uint8_t> rgb
+) {
+    switch (frame_format(path)) {
+    case FrameFormat::QOI:
+        write_bytes(path, encode_qoi(width, height, rgb));
+        break;
+    case FrameFormat::RGB565:
+        throw std::runtime_error("write_frame: .rgb565 dumps need RGB565 framebuffer data");
+    case FrameFormat::PNG:
+        write_bytes(path, encode_png(width, height, rgb));
+        break;
+    }
+}
+
+} // namespace frame_writer
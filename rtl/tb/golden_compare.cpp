@@ -0,0 +1,97 @@
+// Pixel-level golden image comparison implementation.
+//
+// See golden_compare.hpp for the comparison rules.
+
+#include "golden_compare.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <limits>
+
+#include "png_writer.hpp"
+
+namespace {
+
+/// Largest absolute channel difference between golden pixel `i` and `pixel`.
+int channel_error(const png_reader::RgbImage& golden, size_t i, uint16_t pixel, uint64_t& sq_sum) {
+    auto [r, g, b] = png_writer::rgb565_to_rgb888(pixel);
+    int dr = std::abs(r - golden.rgb[i * 3]);
+    int dg = std::abs(g - golden.rgb[i * 3 + 1]);
+    int db = std::abs(b - golden.rgb[i * 3 + 2]);
+    sq_sum += static_cast<uint64_t>(dr * dr + dg * dg + db * db);
+    return std::max({dr, dg, db});
+}
+
+constexpr uint16_t pack_rgb565(int r, int g, int b) {
+    return static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+} // namespace
+
+GoldenDiff compare_to_golden(
+    const png_reader::RgbImage& golden, int width, int height,
+    std::span<const uint16_t> framebuffer, int tolerance
+) {
+    GoldenDiff diff;
+    diff.width = width;
+    diff.height = height;
+    diff.golden_width = golden.width;
+    diff.golden_height = golden.height;
+    diff.tolerance = tolerance;
+    if (diff.size_mismatch()) {
+        return diff;
+    }
+
+    uint64_t sq_sum = 0;
+    diff.pixels = static_cast<uint64_t>(width) * static_cast<uint64_t>(height);
+    for (size_t i = 0; i < diff.pixels; i++) {
+        int err = channel_error(golden, i, framebuffer[i], sq_sum);
+        diff.differing += (err > 0);
+        diff.mismatched += (err > tolerance);
+        diff.max_channel_error = std::max(diff.max_channel_error, err);
+    }
+
+    double mse = static_cast<double>(sq_sum) / (3.0 * static_cast<double>(diff.pixels));
+    diff.psnr_db = mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse)
+                             : std::numeric_limits<double>::infinity();
+    return diff;
+}
+
+std::vector<uint16_t> golden_diff_image(
+    const png_reader::RgbImage& golden, std::span<const uint16_t> framebuffer, int tolerance
+) {
+    std::vector<uint16_t> img(framebuffer.size());
+    uint64_t unused = 0;
+    for (size_t i = 0; i < img.size(); i++) {
+        int err = channel_error(golden, i, framebuffer[i], unused);
+        if (err > tolerance) {
+            img[i] = pack_rgb565(255, 0, 0);
+        } else if (err > 0) {
+            img[i] = pack_rgb565(255, 255, 0);
+        } else {
+            int luma = (77 * golden.rgb[i * 3] + 150 * golden.rgb[i * 3 + 1]
+                        + 29 * golden.rgb[i * 3 + 2]) >> 8;
+            img[i] = pack_rgb565(luma / 3, luma / 3, luma / 3);
+        }
+    }
+    return img;
+}
+
+std::string format_golden_diff(const GoldenDiff& diff) {
+    if (diff.size_mismatch()) {
+        return std::format(
+            "FAIL: rendered {}x{}, golden is {}x{}", diff.width, diff.height, diff.golden_width,
+            diff.golden_height
+        );
+    }
+    if (diff.differing == 0) {
+        return std::format("PASS: all {} pixels match", diff.pixels);
+    }
+    return std::format(
+        "{}: {} of {} pixels differ, {} beyond tolerance {} (max channel error {}, PSNR {:.1f} dB)",
+        diff.passed() ? "PASS" : "FAIL", diff.differing, diff.pixels, diff.mismatched,
+        diff.tolerance, diff.max_channel_error, diff.psnr_db
+    );
+}
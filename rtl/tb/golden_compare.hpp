@@ -0,0 +1,56 @@
+// Pixel-level golden image comparison for the integration harness.
+//
+// The rendered RGB565 framebuffer (extract_framebuffer()) is expanded to
+// RGB888 with the same MSB replication png_writer uses and compared with
+// the decoded golden PNG channel by channel, so a pass does not depend on
+// how either image was PNG-encoded.  A pixel mismatches when any channel
+// differs from the golden by more than the tolerance (0 = exact).
+//
+// On failure the harness writes a diff image: pixels that match exactly
+// are a dimmed grayscale copy of the golden, pixels within tolerance are
+// yellow, and mismatching pixels are red.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "png_reader.hpp"
+
+/// Result of comparing a rendered framebuffer with its golden image.
+struct GoldenDiff {
+    int width = 0;             ///< Rendered width
+    int height = 0;            ///< Rendered height
+    int golden_width = 0;
+    int golden_height = 0;
+    int tolerance = 0;         ///< Allowed per-channel error (8-bit units)
+    uint64_t pixels = 0;       ///< Pixels compared
+    uint64_t differing = 0;    ///< Pixels with any channel error
+    uint64_t mismatched = 0;   ///< Pixels with a channel error above tolerance
+    int max_channel_error = 0; ///< Largest per-channel error (8-bit units)
+    double psnr_db = 0.0;      ///< RGB PSNR; infinite when identical
+
+    bool size_mismatch() const {
+        return width != golden_width || height != golden_height;
+    }
+    bool passed() const {
+        return !size_mismatch() && mismatched == 0;
+    }
+};
+
+/// Compare `framebuffer` (width * height RGB565, row-major) with `golden`.
+GoldenDiff compare_to_golden(
+    const png_reader::RgbImage& golden, int width, int height,
+    std::span<const uint16_t> framebuffer, int tolerance = 0
+);
+
+/// Build the RGB565 diff image for a same-size comparison (see above).
+std::vector<uint16_t> golden_diff_image(
+    const png_reader::RgbImage& golden, std::span<const uint16_t> framebuffer, int tolerance
+);
+
+/// One-line summary, e.g. "FAIL: 312 of 245760 pixels differ (max channel
+/// error 24, PSNR 41.2 dB)".
+std::string format_golden_diff(const GoldenDiff& diff);
@@ -29,14 +29,24 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 // Verilator-generated header for the top-level GPU module.
@@ -48,12 +58,31 @@
 #include "Vgpu_top_rasterizer.h"
 #include "Vgpu_top_register_file.h"
 #include "Vgpu_top_pixel_pipeline.h"
+#include "Vgpu_top_sram_arbiter.h"
 #include "verilated.h"
 #include "verilated_fst_c.h"
+#include "verilated_save.h"
+
+#include "sim_checkpoint.hpp"
 #endif
 
+#include "cmd_fifo_stats.hpp"
+#include "fast_upload.hpp"
+#include "frame_budget.hpp"
+#include "frame_writer.hpp"
+#include "golden_compare.hpp"
+#include "perf_baseline.hpp"
+#include "perf_timestamps.hpp"
+#include "png_reader.hpp"
 #include "png_writer.hpp"
+#include "sdram_bus_stats.hpp"
+#include "sdram_image.hpp"
 #include "sdram_model.hpp"
+#include "sdram_pins.hpp"
+#include "spi_link.hpp"
+#include "synth_scene.hpp"
+#include "tri_trace.hpp"
+#include "unit_profile.hpp"
 
 // ---------------------------------------------------------------------------
 // Register-write command script entry
@@ -62,6 +91,7 @@
 // Hex file parser for shared test scripts (.hex format).
 // Test scripts are loaded from spi_gpu/tests/scripts/ver_NNN_*.hex files
 // which are shared between this Verilator harness and the digital twin.
+#include "cmd_stream.hpp"
 #include "hex_parser.hpp"
 
 // Use HexRegWrite from hex_parser.hpp as the register-write type.
@@ -82,31 +112,45 @@ using RegWrite = HexRegWrite;
 // Test name to hex file path mapping
 // ---------------------------------------------------------------------------
 
-/// Map test name to the corresponding .hex script file path.
+/// One golden-image scene: harness test name, hex script, and the golden
+/// PNG it is compared against (integration/golden/).
+struct SceneInfo {
+    std::string_view name;
+    std::string_view hex_path;
+    std::string_view golden_png;
+};
+
+/// All golden-image scenes, in VER order.
 /// Paths are relative to the harness executable's working directory;
 /// the Makefile runs from integration/ so scripts/ is a peer directory.
+static constexpr std::array<SceneInfo, 10> SCENES = {{
+    {"gouraud",           "scripts/ver_010_gouraud.hex",           "ver_010_gouraud_triangle.png"},
+    {"depth_test",        "scripts/ver_011_depth_test.hex",        "ver_011_depth_test.png"},
+    {"textured",          "scripts/ver_012_textured.hex",          "ver_012_textured_triangle.png"},
+    {"color_combined",    "scripts/ver_013_color_combined.hex",    "ver_013_color_combined.png"},
+    {"textured_cube",     "scripts/ver_014_textured_cube.hex",     "ver_014_textured_cube.png"},
+    {"size_grid",         "scripts/ver_015_size_grid.hex",         "ver_015_size_grid.png"},
+    {"perspective_road",  "scripts/ver_016_perspective_road.hex",  "ver_016_perspective_road.png"},
+    {"indexed_pixel_art", "scripts/ver_017_indexed_pixel_art.hex", "ver_017_indexed_pixel_art.png"},
+    {"stipple_test",      "scripts/ver_023_stipple_test.hex",      "ver_023_stipple_test.png"},
+    {"alpha_blend",       "scripts/ver_024_alpha_blend.hex",       "ver_024_alpha_blend.png"},
+}};
+
+/// Look up a scene by test name.
+/// @return Pointer into SCENES, or nullptr for an unknown name.
+static const SceneInfo* find_scene(std::string_view test_name) {
+    auto it = std::ranges::find(SCENES, test_name, &SceneInfo::name);
+    return it != SCENES.end() ? &*it : nullptr;
+}
+
+/// Map test name to the corresponding .hex script file path.
+/// Returns an empty string for an unknown test name.
 static std::string hex_file_for_test(const std::string& test_name) {
-    static const std::pair<std::string, std::string> mappings[] = {
-        {"gouraud",           "scripts/ver_010_gouraud.hex"},
-        {"depth_test",        "scripts/ver_011_depth_test.hex"},
-        {"textured",          "scripts/ver_012_textured.hex"},
-        {"color_combined",    "scripts/ver_013_color_combined.hex"},
-        {"textured_cube",     "scripts/ver_014_textured_cube.hex"},
-        {"size_grid",         "scripts/ver_015_size_grid.hex"},
-        {"perspective_road",  "scripts/ver_016_perspective_road.hex"},
-        {"indexed_pixel_art", "scripts/ver_017_indexed_pixel_art.hex"},
-        {"stipple_test",      "scripts/ver_023_stipple_test.hex"},
-        {"alpha_blend",       "scripts/ver_024_alpha_blend.hex"},
-    };
-    for (const auto& [name, path] : mappings) {
-        if (name == test_name) {
-            return path;
-        }
-    }
-    return {};
+    const SceneInfo* scene = find_scene(test_name);
+    return scene ? std::string(scene->hex_path) : std::string{};
 }
 
-/// Process any `## TEXTURE:` directives in the hex script.
+/// Process one `## TEXTURE:` directive from a hex script.
 ///
 /// All active INDEXED8_2X2 scripts upload palette blobs and index
 /// arrays through MEM_FILL / MEM_DATA writes during the `palette` phase
@@ -114,16 +158,22 @@ static std::string hex_file_for_test(const std::string& test_name) {
 /// required.  This function is retained as a hook for tests that want
 /// to pre-stage data directly into the SDRAM model and logs (then
 /// skips) any directive it sees so the absence of a generator is not
-/// silently masked.
-static void preload_textures(SdramModel& sdram, const HexScript& script) {
+/// silently masked.  To start a run with data already in SDRAM, map a
+/// staged image with --sdram-image instead.
+static void preload_texture(SdramModel& sdram, const TextureDirective& tex) {
     (void)sdram;
+    std::cerr << std::format(
+        "WARNING: '## TEXTURE: {}' is no longer wired to a host-side "
+        "generator (INDEXED8_2X2 scripts upload via MEM_DATA); "
+        "skipping directive at base 0x{:X}.\n",
+        tex.type, tex.base_word
+    );
+}
+
+/// Process every `## TEXTURE:` directive in the hex script.
+static void preload_textures(SdramModel& sdram, const ScriptView& script) {
     for (const auto& tex : script.textures) {
-        std::cerr << std::format(
-            "WARNING: '## TEXTURE: {}' is no longer wired to a host-side "
-            "generator (INDEXED8_2X2 scripts upload via MEM_DATA); "
-            "skipping directive at base 0x{:X}.\n",
-            tex.type, tex.base_word
-        );
+        preload_texture(sdram, tex);
     }
 }
 
@@ -139,6 +189,9 @@ static constexpr int FB_WIDTH_LOG2 = 9;
 /// SDRAM address space: 32 MB = 16M 16-bit words.
 static constexpr uint32_t SDRAM_WORDS = 16 * 1024 * 1024;
 
+/// Entries in the command FIFO (command_fifo.sv, UNIT-002).
+static constexpr uint32_t CMD_FIFO_DEPTH = 512;
+
 /// Maximum simulation cycles before timeout.
 static constexpr uint64_t MAX_SIM_CYCLES = 50'000'000;
 
@@ -192,222 +245,195 @@ static void reset(Vgpu_top* top, VerilatedFstC* trace, uint64_t& sim_time, int c
     top->rst_n = 1;
     tick(top, trace, sim_time);
 }
+
+/// Per-cycle observers enabled by --profile, --tri-trace and --sdram-stats
+/// (and always by the harness_fifo build).
+struct CycleProbes {
+    UnitProfile* profile = nullptr;       ///< Current phase's unit histograms
+    TriangleTracer* triangles = nullptr;  ///< Per-triangle stage tracker
+    SdramBusStats* sdram = nullptr;       ///< SDRAM command / bandwidth analyzer
+    CmdFifoStats* cmd_fifo = nullptr;     ///< Command FIFO occupancy (harness_fifo)
+    uint64_t* fragments = nullptr;        ///< Fragments accepted (--metrics / --baseline)
+};
+
+/// Sample the probed units after a tick().  No-op when `probes` is null,
+/// so unprobed runs pay one branch per cycle.
+static void probe_cycle(Vgpu_top* top, uint64_t sim_time, const CycleProbes* probes) {
+    if (!probes) {
+        return;
+    }
+    auto* g = top->rootp->gpu_top;
+    if (probes->profile) {
+        probes->profile->sample({
+            .rast_state = static_cast<uint8_t>(g->u_rasterizer->state),
+            .pp_state = static_cast<uint8_t>(g->u_pixel_pipeline->state),
+            .color_cache_state = static_cast<uint8_t>(g->__PVT__u_color_tile_cache__DOT__state),
+            .z_cache_state = static_cast<uint8_t>(g->__PVT__u_zbuf_tile_cache__DOT__state),
+            .frag_accepted = g->rast_frag_valid && g->rast_frag_ready,
+            .tri_valid = g->tri_valid != 0,
+        });
+    }
+    if (probes->triangles) {
+        probes->triangles->sample({
+            .cycle = sim_time / 2,
+            .tri_valid = g->tri_valid != 0,
+            .setup_state = static_cast<uint8_t>(g->u_rasterizer->setup_state),
+            .iter_state = static_cast<uint8_t>(g->u_rasterizer->iter_state),
+            .fifo_wr_en = g->u_rasterizer->fifo_wr_en != 0,
+            .frag_valid = g->rast_frag_valid != 0,
+            .frag_ready = g->rast_frag_ready != 0,
+            .pp_state = static_cast<uint8_t>(g->u_pixel_pipeline->state),
+            .hiz_rejected_tiles = g->hiz_rejected_tiles,
+        });
+    }
+    if (probes->sdram) {
+        auto* arb = g->u_sram_arbiter;
+        probes->sdram->sample(
+            sample_sdram_pins(top),
+            arb->grant_active ? static_cast<ArbiterPort>(arb->granted_port & 3)
+                              : ArbiterPort::CONTROLLER
+        );
+    }
+    if (probes->cmd_fifo) {
+        probes->cmd_fifo->sample(g->fifo_rd_count, g->fifo_wr_almost_full, g->fifo_wr_full);
+    }
+    if (probes->fragments) {
+        *probes->fragments += g->rast_frag_valid && g->rast_frag_ready;
+    }
+}
 #endif
 
 // ---------------------------------------------------------------------------
-// SDRAM model connection
+// Command script execution
 // ---------------------------------------------------------------------------
 
-#ifdef VERILATOR
-
-// SDRAM command encoding: {csn, rasn, casn, wen}
-// Matches sdram_controller.sv localparam definitions.
-static constexpr uint8_t SDRAM_CMD_NOP = 0b0111;
-static constexpr uint8_t SDRAM_CMD_ACTIVATE = 0b0011;
-static constexpr uint8_t SDRAM_CMD_READ = 0b0101;
-static constexpr uint8_t SDRAM_CMD_WRITE = 0b0100;
-static constexpr uint8_t SDRAM_CMD_PRECHARGE = 0b0010;
-static constexpr uint8_t SDRAM_CMD_AUTO_REFRESH = 0b0001;
-static constexpr uint8_t SDRAM_CMD_LOAD_MODE = 0b0000;
-
-/// Number of SDRAM banks.
-static constexpr int SDRAM_BANK_COUNT = 4;
-
-// CAS latency (CL=3, matching sdram_controller.sv)
-static constexpr int CAS_LATENCY = 3;
-
-// Maximum depth for the CAS latency read pipeline.
-// Must be >= CAS_LATENCY to allow pipelined reads.
-static constexpr int READ_PIPE_DEPTH = 8;
-
-/// Per-bank active row tracking for SDRAM model connection.
-struct SdramBankState {
-    bool row_active = false; ///< Whether a row is currently activated
-    uint32_t active_row = 0; ///< Row address of the activated row (13 bits)
-};
-
-/// Read pipeline entry for CAS latency modeling.
-/// Scheduled reads appear on the DQ bus CAS_LATENCY cycles after the READ
-/// command is issued.
-struct ReadPipeEntry {
-    bool valid = false;     ///< Entry is valid (data pending)
-    uint32_t word_addr = 0; ///< SDRAM word address to read from SdramModel
-    int countdown = 0;      ///< Cycles remaining before data appears on bus
+/// How execute_script() drives register writes into the GPU.
+struct ScriptInjection {
+    bool back_to_back = false;         ///< SIM_DIRECT_REG: one write per cycle (--back-to-back)
+    unsigned spi_sck_ratio = 4;        ///< SIM_SPI_LINK: core cycles per SCK period (--spi-ratio)
+    SpiLinkStats* spi_stats = nullptr; ///< SIM_SPI_LINK: link cycle accounting
+    unsigned cmd_interval = 1;         ///< SIM_DIRECT_CMD: min cycles between host writes (--cmd-interval)
+    CmdFifoStats* fifo_stats = nullptr; ///< SIM_DIRECT_CMD: host stall accounting
 };
 
-/// SDRAM connection state persisted across clock cycles.
-/// This struct is instantiated once and passed by reference to connect_sdram()
-/// on every tick().
-struct SdramConnState {
-    std::array<SdramBankState, SDRAM_BANK_COUNT> banks{};   ///< 4 SDRAM banks
-    std::array<ReadPipeEntry, READ_PIPE_DEPTH> read_pipe{}; ///< CAS latency delay FIFO
-    int read_pipe_head = 0;                                 ///< Next write slot in pipe
-    bool initialized = false;                               ///< Set after first call
-    uint64_t write_count = 0;                               ///< Diagnostic: total SDRAM WRITEs
-    uint64_t activate_count = 0;                            ///< Diagnostic: total ACTIVATEs
-    uint64_t read_count = 0;                                ///< Diagnostic: total READs
-};
+#if defined(VERILATOR) && defined(SIM_SPI_LINK)
+static bool pipeline_idle(Vgpu_top* top);
 
-/// Connect the behavioral SDRAM model to the Verilated memory controller ports.
-///
-/// This function is called once per clock cycle (after eval on rising edge) to:
-///   1. Sample the controller's SDRAM command outputs (csn, rasn, casn, wen,
-///      ba, addr, dq_out, dqm).
-///   2. Decode the SDRAM command (ACTIVATE, READ, WRITE, PRECHARGE, etc.).
-///   3. For ACTIVATE: record the row address for the selected bank.
-///   4. For WRITE: write data from the DQ bus into the SdramModel at the
-///      computed word address (bank | row | column).
-///   5. For READ: schedule data to appear on DQ bus after CAS_LATENCY cycles.
-///   6. Advance the read pipeline and drive any matured read data onto DQ in.
-///
-/// The SDRAM model faithfully implements the timing specified in INT-011:
-///   - CAS latency 3 (CL=3)
-///   - Sequential burst reads/writes (column auto-increment by controller)
-///
-/// Word address calculation from SDRAM signals:
-///   word_addr = (bank << 23) | (row << 9) | column
+/// Send a sequence of register writes over the SPI pins (harness_spi
+/// build: no SIM_DIRECT_REG, so writes pass through spi_slave.sv and the
+/// command FIFO as they do on hardware).
 ///
-/// With --pins-inout-enables, Verilator splits the inout sdram_dq port into:
-///   sdram_dq      — input  (testbench drives read data to controller)
-///   sdram_dq__out — output (controller drives write data from controller)
-///   sdram_dq__en  — output enable (1 = controller driving, 0 = tristate)
-static void connect_sdram(Vgpu_top* top, SdramModel& sdram, SdramConnState& state) {
-    // Step 1: Advance read pipeline — decrement countdowns, drive matured data
-    bool read_data_valid = false;
-    uint16_t read_data = 0;
-
-    for (auto& entry : state.read_pipe) {
-        if (entry.valid) {
-            entry.countdown--;
-            if (entry.countdown <= 0) {
-                // Data is ready — read from model and mark entry consumed
-                read_data = sdram.read_word(entry.word_addr);
-                read_data_valid = true;
-                entry.valid = false;
+/// Each write is bit-banged by SpiLink (spi_link.hpp) at
+/// `inject.spi_sck_ratio` core cycles per SCK period.  Like the host, the
+/// harness does not start a write while gpio_cmd_full is set.  Every
+/// cycle is accounted in `inject.spi_stats`: on the wire or stalled on
+/// CMD_FULL, and whether the GPU sat idle with nothing left to execute.
+static void execute_script(
+    Vgpu_top* top,
+    VerilatedFstC* trace,
+    uint64_t& sim_time,
+    SdramModel& sdram,
+    SdramPinAdapter& conn,
+    std::span<const RegWrite> script,
+    const ScriptInjection& inject,
+    const CycleProbes* probes = nullptr
+) {
+    SpiLink link(inject.spi_sck_ratio);
+    SpiLinkStats& stats = *inject.spi_stats;
+    auto step = [&](const SpiPins& pins) {
+        top->spi_cs_n = pins.cs_n;
+        top->spi_sck = pins.sck;
+        top->spi_mosi = pins.mosi;
+        tick(top, trace, sim_time);
+        connect_sdram(top, sdram, conn);
+        probe_cycle(top, sim_time, probes);
+        stats.script_cycles++;
+        stats.starved_cycles += pipeline_idle(top);
+    };
+
+    for (size_t i = 0; i < script.size(); i++) {
+        // Host-side backpressure: wait for the command FIFO to drain below
+        // its almost-full threshold.
+        uint64_t full_timeout = 0;
+        while (top->gpio_cmd_full) {
+            step({});
+            stats.full_cycles++;
+            if (++full_timeout > 10'000'000) {
+                std::cerr << std::format(
+                    "ERROR: execute_script CMD_FULL timeout at entry {} (addr=0x{:02x})\n",
+                    i,
+                    script[i].addr
+                );
+                return;
             }
         }
-    }
-
-    // Drive read data onto the DQ input bus.
-    // With --pins-inout-enables, the inout sdram_dq is split into:
-    //   sdram_dq      — input  (testbench drives read data to controller)
-    //   sdram_dq__out — output (controller drives write data)
-    //   sdram_dq__en  — output enable (1 = controller driving)
-    top->sdram_dq = read_data_valid ? read_data : 0;
-
-    // Step 2: Decode current-cycle SDRAM command
-    auto cmd = static_cast<uint8_t>(
-        ((top->sdram_csn & 1) << 3) | ((top->sdram_rasn & 1) << 2) | ((top->sdram_casn & 1) << 1) |
-        ((top->sdram_wen & 1) << 0)
-    );
 
-    auto bank = static_cast<uint8_t>(top->sdram_ba & 0x3);
-    auto addr = static_cast<uint16_t>(top->sdram_a & 0x1FFF);
-
-    switch (cmd) {
-        case SDRAM_CMD_ACTIVATE: {
-            // Record active row for the selected bank
-            state.banks[bank].row_active = true;
-            state.banks[bank].active_row = addr; // A[12:0] = row address
-            state.activate_count++;
-            break;
+        link.begin(script[i]);
+        while (!link.done()) {
+            step(link.next());
+            stats.link_cycles++;
         }
+        stats.writes++;
+    }
+}
+#elif defined(VERILATOR) && defined(SIM_DIRECT_CMD)
+/// Push a sequence of register writes into the command FIFO through the
+/// sim_cmd_* ports (harness_fifo build, SIM_DIRECT_CMD), as gpu_sim does.
+/// The FIFO, not the harness, then waits out gpu_busy, so its occupancy
+/// and wr_almost_full behave as they do behind the SPI slave.
+///
+/// The host offers one write every `inject.cmd_interval` cycles (1 = as
+/// fast as the FIFO accepts them) and holds a write back while
+/// wr_almost_full (CMD_FULL) is set; each held cycle is counted in
+/// `inject.fifo_stats`.
+static void execute_script(
+    Vgpu_top* top,
+    VerilatedFstC* trace,
+    uint64_t& sim_time,
+    SdramModel& sdram,
+    SdramPinAdapter& conn,
+    std::span<const RegWrite> script,
+    const ScriptInjection& inject,
+    const CycleProbes* probes = nullptr
+) {
+    auto* g = top->rootp->gpu_top;
+    auto idle_tick = [&] {
+        g->sim_cmd_valid = 0;
+        tick(top, trace, sim_time);
+        connect_sdram(top, sdram, conn);
+        probe_cycle(top, sim_time, probes);
+    };
 
-        case SDRAM_CMD_READ: {
-            // Schedule a read with CAS latency delay
-            // Column address is A[8:0] on the READ command
-            uint32_t col = addr & 0x1FF;
-            uint32_t row = state.banks[bank].active_row;
-            // word_addr = (bank << 23) | (row << 9) | column
-            // This matches the sdram_controller address decomposition:
-            //   bank = addr[23:22], row = addr[21:9], col = addr[8:1]
-            // But since the controller already decomposes byte addresses and
-            // drives column addresses directly, we reconstruct the flat word
-            // address that corresponds to the SdramModel's 16-bit word array.
-            uint32_t word_addr = (static_cast<uint32_t>(bank) << 23) | (row << 9) | col;
-
-            // Find an empty slot in the read pipeline
-            int slot = state.read_pipe_head;
-            for (int i = 0; i < READ_PIPE_DEPTH; i++) {
-                int idx = (state.read_pipe_head + i) % READ_PIPE_DEPTH;
-                if (!state.read_pipe[idx].valid) {
-                    slot = idx;
-                    break;
-                }
+    for (size_t i = 0; i < script.size(); i++) {
+        uint64_t full_timeout = 0;
+        while (g->fifo_wr_almost_full) {
+            idle_tick();
+            inject.fifo_stats->host_stall();
+            if (++full_timeout > 10'000'000) {
+                std::cerr << std::format(
+                    "ERROR: execute_script CMD_FULL timeout at entry {} (addr=0x{:02x})\n",
+                    i,
+                    script[i].addr
+                );
+                return;
             }
-            state.read_pipe[slot].valid = true;
-            state.read_pipe[slot].word_addr = word_addr;
-            // CAS_LATENCY - 1: connect_sdram() is called AFTER tick(), so
-            // read data driven after cycle N is sampled by the RTL on cycle
-            // N+1's rising edge.  Subtracting 1 from the pipeline delay
-            // compensates for this one-cycle offset, ensuring data appears
-            // on sdram_dq at the same rising edge the SDRAM controller
-            // expects it (CAS_LATENCY cycles after the READ command).
-            state.read_pipe[slot].countdown = CAS_LATENCY - 1;
-            state.read_pipe_head = (slot + 1) % READ_PIPE_DEPTH;
-            state.read_count++;
-            break;
         }
 
-        case SDRAM_CMD_WRITE: {
-            // Write data from DQ bus into SdramModel immediately
-            // (SDRAM captures write data on the same cycle as the WRITE command)
-            uint32_t col = addr & 0x1FF;
-            uint32_t row = state.banks[bank].active_row;
-            uint32_t word_addr = (static_cast<uint32_t>(bank) << 23) | (row << 9) | col;
-
-            auto wdata = static_cast<uint16_t>(top->sdram_dq__out & 0xFFFF);
-            auto dqm = static_cast<uint8_t>(top->sdram_dqm & 0x3);
-            state.write_count++;
-
-            // Apply byte mask (DQM): DQM[1] masks upper byte, DQM[0] masks lower byte
-            // DQM=0 means byte is written; DQM=1 means byte is masked (not written)
-            if (dqm == 0x00) {
-                // Both bytes written
-                sdram.write_word(word_addr, wdata);
-            } else {
-                // Partial write — read-modify-write with byte masking
-                uint16_t existing = sdram.read_word(word_addr);
-                if (!(dqm & 0x01)) {
-                    existing = (existing & 0xFF00) | (wdata & 0x00FF);
-                }
-                if (!(dqm & 0x02)) {
-                    existing = (existing & 0x00FF) | (wdata & 0xFF00);
-                }
-                sdram.write_word(word_addr, existing);
-            }
-            break;
-        }
+        g->sim_cmd_valid = 1;
+        g->sim_cmd_rw    = 0; // 0 = write
+        g->sim_cmd_addr  = script[i].addr;
+        g->sim_cmd_wdata = script[i].data;
+        tick(top, trace, sim_time);
+        connect_sdram(top, sdram, conn);
+        probe_cycle(top, sim_time, probes);
+        g->sim_cmd_valid = 0;
 
-        case SDRAM_CMD_PRECHARGE: {
-            // Close row(s). A10=1 means all banks, A10=0 means selected bank.
-            if (addr & (1 << 10)) {
-                // Precharge all banks
-                for (auto& b : state.banks) {
-                    b.row_active = false;
-                }
-            } else {
-                state.banks[bank].row_active = false;
-            }
-            break;
+        for (unsigned k = 1; k < inject.cmd_interval; k++) {
+            idle_tick();
         }
-
-        case SDRAM_CMD_NOP:
-        case SDRAM_CMD_AUTO_REFRESH:
-        case SDRAM_CMD_LOAD_MODE:
-        default:
-            // No action needed for the behavioral model
-            break;
     }
 }
-
-#endif
-
-// ---------------------------------------------------------------------------
-// Command script execution
-// ---------------------------------------------------------------------------
-
-#ifdef VERILATOR
+#elif defined(VERILATOR)
 /// Drive a sequence of register writes directly into the register file,
 /// bypassing both SPI and the command FIFO (SIM_DIRECT_REG mode).
 ///
@@ -416,15 +442,25 @@ static void connect_sdram(Vgpu_top* top, SdramModel& sdram, SdramConnState& stat
 /// gpu_busy (rasterizer backpressure) by spinning until the register file
 /// is ready to accept the next command.
 ///
+/// By default every write is followed by an idle cycle with sim_reg_valid
+/// deasserted, so a script runs at half the command rate.  With
+/// `inject.back_to_back`, sim_reg_valid stays high across consecutive
+/// writes while gpu_busy is low, one write per cycle, as the command FIFO
+/// path (fifo_rd_en = !empty && !gpu_busy) can deliver them.
+///
 /// connect_sdram() is called on every tick() to keep the behavioral SDRAM
-/// model synchronized with the SDRAM controller.
+/// model synchronized with the SDRAM controller.  With non-null `probes`,
+/// every cycle is also sampled into them (--profile, --tri-trace,
+/// --sdram-stats).
 static void execute_script(
     Vgpu_top* top,
     VerilatedFstC* trace,
     uint64_t& sim_time,
     SdramModel& sdram,
-    SdramConnState& conn,
-    std::span<const RegWrite> script
+    SdramPinAdapter& conn,
+    std::span<const RegWrite> script,
+    const ScriptInjection& inject,
+    const CycleProbes* probes = nullptr
 ) {
     for (size_t i = 0; i < script.size(); i++) {
         // Wait for gpu_busy to deassert (rasterizer ready for next command).
@@ -433,6 +469,7 @@ static void execute_script(
             top->rootp->gpu_top->sim_reg_valid = 0;
             tick(top, trace, sim_time);
             connect_sdram(top, sdram, conn);
+            probe_cycle(top, sim_time, probes);
             bp_timeout++;
             if (bp_timeout > 10'000'000) {
                 std::cerr << std::format(
@@ -452,11 +489,16 @@ static void execute_script(
         top->rootp->gpu_top->sim_reg_wdata = script[i].data;
         tick(top, trace, sim_time);
         connect_sdram(top, sdram, conn);
+        probe_cycle(top, sim_time, probes);
 
         // Deassert valid after the write cycle
         top->rootp->gpu_top->sim_reg_valid = 0;
+        if (inject.back_to_back) {
+            continue;
+        }
         tick(top, trace, sim_time);
         connect_sdram(top, sdram, conn);
+        probe_cycle(top, sim_time, probes);
     }
 }
 #endif
@@ -485,19 +527,192 @@ extract_framebuffer(const SdramModel& sdram, uint32_t base_word, int width_log2,
     return sdram.read_framebuffer(base_word, width_log2, height);
 }
 
+/// Auto-ranged grayscale of a Z-buffer readback for the --zbuf PNG.
+///
+/// Matches the DT's approach: find min/max non-zero z, then linearly map
+/// [z_min, z_max] to [0, 255].  z=0 (cleared) maps to black.  Both passes
+/// are branch-free so they vectorize, and the per-pixel division by the
+/// range is a multiply by a 2^40 fixed-point reciprocal, which is exact
+/// for every (z - z_min) * 255 with a 16-bit range.
+[[maybe_unused]]
+static std::vector<uint8_t> zbuf_to_gray(std::span<const uint16_t> zbuf) {
+    uint16_t z_min = 0xFFFF;
+    uint16_t z_max = 0;
+    for (uint16_t z : zbuf) {
+        z_min = std::min(z_min, z == 0 ? uint16_t{0xFFFF} : z);
+        z_max = std::max(z_max, z);
+    }
+    uint32_t range = (z_max > z_min) ? static_cast<uint32_t>(z_max - z_min) : 1;
+    uint64_t recip = (uint64_t{1} << 40) / range + 1;
+
+    std::vector<uint8_t> gray(zbuf.size());
+    for (size_t px = 0; px < zbuf.size(); px++) {
+        uint16_t z = zbuf[px];
+        uint64_t scaled = static_cast<uint64_t>(z == 0 ? 0 : z - z_min) * 255;
+        gray[px] = static_cast<uint8_t>((scaled * recip) >> 40);
+    }
+    return gray;
+}
+
+// ---------------------------------------------------------------------------
+// Backdoor tile-cache flush
+// ---------------------------------------------------------------------------
+
+#ifdef VERILATOR
+/// Geometry shared by the UNIT-012 Z and UNIT-013 color tile caches:
+/// 4 ways x 32 sets of 4x4 tiles, tile_idx = {tag[8:0], set[4:0]}, and a
+/// data BRAM addressed {way[1:0], set[4:0], pixel_off[3:0]}.
+static constexpr int TILE_CACHE_WAYS = 4;
+static constexpr int TILE_CACHE_SET_BITS = 5;
+static constexpr int TILE_CACHE_SETS = 1 << TILE_CACHE_SET_BITS;
+static constexpr int TILE_CACHE_PIXELS = 16;
+static constexpr uint32_t TILE_CACHE_TAG_MASK = 0x1FF;
+
+/// Verilator-exposed state of one write-back tile cache.
+struct TileCacheView {
+    using Flags = VlUnpacked<CData, TILE_CACHE_SETS>;
+    using Tags = VlUnpacked<SData, TILE_CACHE_SETS>;
+    using Data = VlUnpacked<SData, TILE_CACHE_WAYS * TILE_CACHE_SETS * TILE_CACHE_PIXELS>;
+
+    const char* name;                               ///< For diagnostics
+    std::array<const Flags*, TILE_CACHE_WAYS> valid; ///< valid_w0..3
+    std::array<const Flags*, TILE_CACHE_WAYS> dirty; ///< dirty_w0..3
+    std::array<const Tags*, TILE_CACHE_WAYS> tags;   ///< u_tag0..3 EBR contents
+    const Data* data;                               ///< cache_mem
+    uint32_t base_field;                            ///< FB_CONFIG base (512-byte units)
+};
+
+/// Indices into tile_cache_views().
+enum TileCacheIndex : size_t {
+    COLOR_TILE_CACHE,
+    Z_TILE_CACHE,
+};
+
+/// Both tile caches, with their surface bases taken from FB_CONFIG
+/// (color base in bits [15:0], Z base in bits [31:16], INT-010).
+static std::array<TileCacheView, 2> tile_cache_views(Vgpu_top* top) {
+    auto* g = top->rootp->gpu_top;
+    uint64_t fb_config = static_cast<uint64_t>(g->u_register_file->fb_config_reg);
+    return {{
+        {
+            "color",
+            {&g->__PVT__u_color_tile_cache__DOT__valid_w0,
+             &g->__PVT__u_color_tile_cache__DOT__valid_w1,
+             &g->__PVT__u_color_tile_cache__DOT__valid_w2,
+             &g->__PVT__u_color_tile_cache__DOT__valid_w3},
+            {&g->__PVT__u_color_tile_cache__DOT__dirty_w0,
+             &g->__PVT__u_color_tile_cache__DOT__dirty_w1,
+             &g->__PVT__u_color_tile_cache__DOT__dirty_w2,
+             &g->__PVT__u_color_tile_cache__DOT__dirty_w3},
+            {&g->__PVT__u_color_tile_cache__DOT__u_tag0__DOT__mem,
+             &g->__PVT__u_color_tile_cache__DOT__u_tag1__DOT__mem,
+             &g->__PVT__u_color_tile_cache__DOT__u_tag2__DOT__mem,
+             &g->__PVT__u_color_tile_cache__DOT__u_tag3__DOT__mem},
+            &g->__PVT__u_color_tile_cache__DOT__cache_mem,
+            static_cast<uint32_t>(fb_config & 0xFFFF),
+        },
+        {
+            "Z",
+            {&g->__PVT__u_zbuf_tile_cache__DOT__valid_w0,
+             &g->__PVT__u_zbuf_tile_cache__DOT__valid_w1,
+             &g->__PVT__u_zbuf_tile_cache__DOT__valid_w2,
+             &g->__PVT__u_zbuf_tile_cache__DOT__valid_w3},
+            {&g->__PVT__u_zbuf_tile_cache__DOT__dirty_w0,
+             &g->__PVT__u_zbuf_tile_cache__DOT__dirty_w1,
+             &g->__PVT__u_zbuf_tile_cache__DOT__dirty_w2,
+             &g->__PVT__u_zbuf_tile_cache__DOT__dirty_w3},
+            {&g->__PVT__u_zbuf_tile_cache__DOT__u_tag0__DOT__mem,
+             &g->__PVT__u_zbuf_tile_cache__DOT__u_tag1__DOT__mem,
+             &g->__PVT__u_zbuf_tile_cache__DOT__u_tag2__DOT__mem,
+             &g->__PVT__u_zbuf_tile_cache__DOT__u_tag3__DOT__mem},
+            &g->__PVT__u_zbuf_tile_cache__DOT__cache_mem,
+            static_cast<uint32_t>((fb_config >> 16) & 0xFFFF),
+        },
+    }};
+}
+
+/// Write every valid and dirty line of `cache` to the SDRAM model, as the
+/// RTL flush FSM (S_FLUSH_NEXT/S_FLUSH_WB) would, in zero simulated
+/// cycles.  The cache itself is not modified: lines stay dirty, so if
+/// simulation continues a later eviction writes back the same data.
+///
+/// @return Number of lines written.
+static int backdoor_flush_tile_cache(const TileCacheView& cache, SdramModel& sdram) {
+    // SDRAM byte address of a pixel = {base[14:0], 9'b0} + tile_idx * 32
+    // + pixel_off * 2 (tile_byte_addr() in the RTL).
+    uint32_t base_byte = (cache.base_field & 0x7FFF) << 9;
+    int flushed = 0;
+    for (int set = 0; set < TILE_CACHE_SETS; set++) {
+        for (int way = 0; way < TILE_CACHE_WAYS; way++) {
+            if (!(*cache.valid[way])[set] || !(*cache.dirty[way])[set]) {
+                continue;
+            }
+            uint32_t tag = (*cache.tags[way])[set] & TILE_CACHE_TAG_MASK;
+            uint32_t tile_idx = (tag << TILE_CACHE_SET_BITS) | static_cast<uint32_t>(set);
+            uint32_t tile_byte = base_byte + (tile_idx << 5);
+            int bram_base = (way << (TILE_CACHE_SET_BITS + 4)) | (set << 4);
+            for (int px = 0; px < TILE_CACHE_PIXELS; px++) {
+                sdram.write_word(tile_byte + (px << 1), (*cache.data)[bram_base + px]);
+            }
+            flushed++;
+        }
+    }
+    return flushed;
+}
+#endif
+
 // ---------------------------------------------------------------------------
 // Pipeline drain helper
 // ---------------------------------------------------------------------------
 
+/// Cycles from a register write leaving the command FIFO to the unit it
+/// triggers leaving IDLE: FIFO read latency, the pipelined reg_cmd_valid
+/// stage, and the register-file latch.  The direct-register path is shorter.
+static constexpr uint64_t CMD_TO_BUSY_CYCLES = 3;
+
+/// Longest burst any SDRAM client issues, in 16-bit words
+/// (display_controller.sv BURST_MAX; tile caches use 16, texture cache 8).
+static constexpr uint64_t SDRAM_MAX_BURST_WORDS = 128;
+
+/// sdram_controller.sv row timing around a burst: ACTIVATE-to-READ/WRITE
+/// (tRCD), write recovery (tWR) and PRECHARGE (tRP).
+static constexpr uint64_t SDRAM_T_RCD = 2;
+static constexpr uint64_t SDRAM_T_WR = 2;
+static constexpr uint64_t SDRAM_T_RP = 2;
+
+/// Number of consecutive idle cycles drain_pipeline() requires before it
+/// declares the pipeline drained.  pipeline_idle() can read true while a
+/// register write is still on its way to the unit it triggers, or while
+/// the controller finishes a burst a client has already handed off; the
+/// window covers the write-to-busy depth plus the longest such burst with
+/// its row open/close and CAS latency.
+static constexpr uint64_t PIPELINE_IDLE_SETTLE_CYCLES =
+    CMD_TO_BUSY_CYCLES + SDRAM_T_RCD + CAS_LATENCY + SDRAM_MAX_BURST_WORDS + SDRAM_T_WR
+    + SDRAM_T_RP;
+
+/// Upper bound on a single drain.  Only reached if the pipeline hangs.
+static constexpr uint64_t PIPELINE_DRAIN_MAX_CYCLES = 10'000'000;
+
+/// Cycle accounting for one executed script phase.
+struct PhaseStats {
+    std::string name;           ///< Phase name from '## PHASE:'
+    size_t commands = 0;        ///< Register writes issued
+    uint64_t script_cycles = 0; ///< Cycles spent in execute_script()
+    uint64_t drain_cycles = 0;  ///< Cycles spent in drain_pipeline()
+    size_t fast_uploads = 0;    ///< Writes applied by --fast-upload (no cycles)
+    UnitProfile profile{};      ///< Per-unit FSM histograms (--profile only)
+};
+
 #ifdef VERILATOR
-/// Run clock cycles to drain the rendering pipeline, calling
-/// connect_sdram() each cycle.
-static void drain_pipeline(
+/// Run a fixed number of clock cycles, calling connect_sdram() each cycle.
+/// Used where the wait is a timing requirement (SDRAM power-up) rather
+/// than a pipeline drain.
+static void run_cycles(
     Vgpu_top* top,
     VerilatedFstC* trace,
     uint64_t& sim_time,
     SdramModel& sdram,
-    SdramConnState& conn,
+    SdramPinAdapter& conn,
     uint64_t cycle_count
 ) {
     for (uint64_t c = 0; c < cycle_count; c++) {
@@ -505,201 +720,961 @@ static void drain_pipeline(
         connect_sdram(top, sdram, conn);
     }
 }
+
+/// Return true when no work is queued or in flight anywhere in the
+/// render path: command FIFO empty, no partial vertex or pending
+/// triangle, rasterizer setup FIFO empty, pixel pipeline empty
+/// (frag_done), DMA idle (gpu_busy), and both tile caches (UNIT-012,
+/// UNIT-013) back in S_IDLE with no Z uninit-flag sweep running.
+static bool pipeline_idle(Vgpu_top* top) {
+    auto* g = top->rootp->gpu_top;
+    return g->frag_done
+        && !g->gpu_busy
+        && top->gpio_cmd_empty
+        && g->u_rasterizer->fifo_empty
+        && g->u_register_file->vertex_count == 0
+        && !g->tri_valid
+        && g->__PVT__u_color_tile_cache__DOT__state == 0
+        && g->__PVT__u_zbuf_tile_cache__DOT__state == 0
+        && !g->__PVT__u_zbuf_tile_cache__DOT__uninit_clear_busy;
+}
+
+/// Run clock cycles until the rendering pipeline is drained, calling
+/// connect_sdram() each cycle.
+///
+/// Returns as soon as pipeline_idle() has held for
+/// PIPELINE_IDLE_SETTLE_CYCLES consecutive cycles, or after max_cycles.
+/// Cycles are sampled into `probes` when it is non-null.
+///
+/// @return Number of cycles run.
+static uint64_t drain_pipeline(
+    Vgpu_top* top,
+    VerilatedFstC* trace,
+    uint64_t& sim_time,
+    SdramModel& sdram,
+    SdramPinAdapter& conn,
+    uint64_t max_cycles,
+    const CycleProbes* probes = nullptr
+) {
+    uint64_t idle_run = 0;
+    uint64_t c = 0;
+    while (c < max_cycles && idle_run < PIPELINE_IDLE_SETTLE_CYCLES) {
+        tick(top, trace, sim_time);
+        connect_sdram(top, sdram, conn);
+        probe_cycle(top, sim_time, probes);
+        c++;
+        idle_run = pipeline_idle(top) ? idle_run + 1 : 0;
+    }
+    if (idle_run < PIPELINE_IDLE_SETTLE_CYCLES) {
+        std::cerr << std::format(
+            "WARNING: pipeline did not drain within {} cycles\n", max_cycles);
+    }
+    return c;
+}
+
+/// FB_DISPLAY register index (INT-010).
+static constexpr uint8_t REG_FB_DISPLAY = 0x41;
+
+/// Upper bound on a vsync wait: two display frames (800x525 pixels at
+/// clk_core / 4) plus margin.
+static constexpr uint64_t VSYNC_WAIT_MAX_CYCLES = 4'000'000;
+
+/// Present the color buffer FB_CONFIG currently renders to and wait for
+/// the vsync that latches it (--frames).  This re-presents the draw
+/// buffer rather than swapping to a second one.  The FB_DISPLAY write goes
+/// through the build's injection path; the wait lasts until the register
+/// file's pending FB_DISPLAY is applied.
+///
+/// @return Cycles from the FB_DISPLAY write to the vsync.
+static uint64_t present_frame(
+    Vgpu_top* top,
+    VerilatedFstC* trace,
+    uint64_t& sim_time,
+    SdramModel& sdram,
+    SdramPinAdapter& conn,
+    const ScriptInjection& inject,
+    const CycleProbes* probes = nullptr
+) {
+    auto* rf = top->rootp->gpu_top->u_register_file;
+    uint64_t fb_config = rf->fb_config_reg;
+    // FB_DISPLAY: [51:48] width_log2, [47:32] scanout base (FB_CONFIG units)
+    RegWrite present{
+        REG_FB_DISPLAY, ((fb_config >> 32) & 0xF) << 48 | (fb_config & 0xFFFF) << 32};
+
+    uint64_t start = sim_time;
+    execute_script(top, trace, sim_time, sdram, conn, std::span<const RegWrite>(&present, 1),
+                   inject, probes);
+    // The FIFO and SPI paths deliver the write a few cycles later.
+    bool seen_pending = false;
+    for (uint64_t c = 0; c < VSYNC_WAIT_MAX_CYCLES; c++) {
+        if (rf->fb_display_pending) {
+            seen_pending = true;
+        } else if (seen_pending) {
+            return (sim_time - start) / 2;
+        }
+        tick(top, trace, sim_time);
+        connect_sdram(top, sdram, conn);
+        probe_cycle(top, sim_time, probes);
+    }
+    std::cerr << std::format(
+        "WARNING: FB_DISPLAY not latched within {} cycles\n", VSYNC_WAIT_MAX_CYCLES);
+    return (sim_time - start) / 2;
+}
 #endif
 
 // ---------------------------------------------------------------------------
-// Main
+// Checkpoint save / restore
 // ---------------------------------------------------------------------------
+//
+// A post-init checkpoint (taken after reset and SDRAM_INIT_WAIT) lets each
+// render target skip ~25,100 cycles of identical start-up simulation.  A
+// phase checkpoint (taken just before a named script phase) additionally
+// skips every earlier phase, e.g. the palette/index upload of VER-017.
+// File layout: sim_checkpoint header, SdramPinAdapter, touched SDRAM pages,
+// Verilated model (see sim_checkpoint.hpp).
+//
+// Requires a --savable model; the Makefile defines SIM_SAVABLE for those
+// builds.  Other builds (e.g. the --threads variants) get stubs that
+// report checkpoints as unavailable.
 
-int main(int argc, char** argv) {
-#ifdef VERILATOR
-    // -----------------------------------------------------------------------
-    // 1. Initialize Verilator
-    // -----------------------------------------------------------------------
-    auto contextp = std::make_unique<VerilatedContext>();
-    contextp->commandArgs(argc, argv);
-    contextp->traceEverOn(true);
-
-    auto top = std::make_unique<Vgpu_top>(contextp.get());
-
-    // Optional FST trace file, enabled by the --trace command-line flag.
-    std::unique_ptr<VerilatedFstC> trace;
-    auto args = std::span(argv, static_cast<size_t>(argc));
-    bool trace_enabled = std::any_of(args.begin() + 1, args.end(), [](const char* arg) {
-        return std::string_view(arg) == "--trace";
+#if defined(VERILATOR) && defined(SIM_SAVABLE)
+static_assert(std::is_trivially_copyable_v<SdramPinAdapter>);
+
+/// Save the complete simulation state to `path`.
+/// Throws std::runtime_error if the file cannot be created.
+static void save_checkpoint(
+    const std::string& path,
+    Vgpu_top* top,
+    const SdramModel& sdram,
+    const SdramPinAdapter& conn,
+    const sim_checkpoint::Header& header
+) {
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+        throw std::runtime_error(std::format("cannot create checkpoint {}", path));
+    }
+    sim_checkpoint::write_header(os, header);
+    sim_checkpoint::write_pod(os, conn);
+    // SDRAM: model size, then (first_word, count, words) per touched-page
+    // run, terminated by count == 0.  Untouched pages are zero on restore.
+    sim_checkpoint::write_pod(os, static_cast<uint64_t>(sdram.size()));
+    sdram.for_each_dirty_range([&os](uint32_t first_word, std::span<const uint16_t> words) {
+        sim_checkpoint::write_pod(os, first_word);
+        sim_checkpoint::write_pod(os, static_cast<uint32_t>(words.size()));
+        os.write(words.data(), words.size_bytes());
     });
-    if (trace_enabled) {
-        trace = std::make_unique<VerilatedFstC>();
-        top->trace(trace.get(), 99);
-        trace->open("../build/sim_out/harness.fst");
+    sim_checkpoint::write_pod(os, uint32_t{0});
+    sim_checkpoint::write_pod(os, uint32_t{0});
+    os << *top;
+    os.close();
+}
+
+/// Restore simulation state saved by save_checkpoint().
+/// Must be called before the first eval() of a freshly constructed model.
+/// Throws std::runtime_error on a missing file or mismatched SDRAM size.
+///
+/// @return The checkpoint header (sim_time, resume phase, test name).
+static sim_checkpoint::Header restore_checkpoint(
+    const std::string& path,
+    Vgpu_top* top,
+    SdramModel& sdram,
+    SdramPinAdapter& conn
+) {
+    VerilatedRestore is;
+    is.open(path.c_str());
+    if (!is.isOpen()) {
+        throw std::runtime_error(std::format("cannot open checkpoint {}", path));
     }
+    auto header = sim_checkpoint::read_header(is);
+    sim_checkpoint::read_pod(is, conn);
+    uint64_t word_count = 0;
+    sim_checkpoint::read_pod(is, word_count);
+    if (word_count != sdram.size()) {
+        throw std::runtime_error(std::format(
+            "checkpoint {} holds {} SDRAM words, model has {}", path, word_count, sdram.size()));
+    }
+    for (;;) {
+        uint32_t first_word = 0;
+        uint32_t count = 0;
+        sim_checkpoint::read_pod(is, first_word);
+        sim_checkpoint::read_pod(is, count);
+        if (count == 0) {
+            break;
+        }
+        auto words = sdram.writable_range(first_word, count);
+        if (words.size() != count) {
+            throw std::runtime_error(std::format(
+                "checkpoint {}: SDRAM range 0x{:06X}+{} out of bounds", path, first_word, count));
+        }
+        is.read(words.data(), words.size_bytes());
+    }
+    is >> *top;
+    is.close();
+    return header;
+}
+#elif defined(VERILATOR)
+[[noreturn]] static void checkpoints_unavailable() {
+    throw std::runtime_error("checkpoints need a --savable build (SIM_SAVABLE)");
+}
 
-    uint64_t sim_time = 0;
+static void save_checkpoint(
+    const std::string&, Vgpu_top*, const SdramModel&, const SdramPinAdapter&,
+    const sim_checkpoint::Header&
+) {
+    checkpoints_unavailable();
+}
 
-    // -----------------------------------------------------------------------
-    // 2. Instantiate behavioral SDRAM model
-    // -----------------------------------------------------------------------
-    SdramModel sdram(SDRAM_WORDS);
+static sim_checkpoint::Header
+restore_checkpoint(const std::string&, Vgpu_top*, SdramModel&, SdramPinAdapter&) {
+    checkpoints_unavailable();
+}
+#endif
 
-    // -----------------------------------------------------------------------
-    // 3. Parse command-line arguments
-    // -----------------------------------------------------------------------
-    // Usage:
-    //   ./harness <test_name> [output.png]
-    //
-    // Where <test_name> is one of: gouraud, depth_test, textured,
-    // color_combined.  If [output.png] is not provided, the default is
-    // <test_name>.png in the current working directory.
-    //
-    // Additional flags:
-    //   --test <name>   — alternative way to specify test name
-    //   --trace         — enable FST waveform trace output
+// ---------------------------------------------------------------------------
+// Single test run
+// ---------------------------------------------------------------------------
 
-    std::string test_name;
-    std::string output_file;
-    std::string zbuf_file;
+/// Options for one harness run, parsed from the command line (or built
+/// per scene by run_regression()).
+struct HarnessOptions {
+    std::string test_name;    ///< Scene name; empty = save post-init checkpoint only
+    std::string output_file;  ///< Color image (.png/.qoi/.rgb565); empty = keep in memory only
+    std::string golden_file;  ///< Golden PNG to compare pixels with (--golden)
+    int tolerance = 0;        ///< Allowed per-channel golden error (--tolerance)
+    bool compare_only = false; ///< Write output_file only if the golden differs
+    bool metrics = false;     ///< Fill RunResult::metrics (--metrics / --baseline)
+    std::string zbuf_file;    ///< Z-buffer PNG path; empty = skip Z readback
+    bool backdoor_flush = false; ///< Copy dirty color/Z cache lines to SDRAM (--backdoor-flush)
+    bool fast_upload = false; ///< Apply MEM_* writes directly to the SDRAM model (--fast-upload)
+    std::string restore_file; ///< Checkpoint to resume from (--restore)
+    std::string save_file;    ///< Checkpoint to write (--save-checkpoint)
+    std::string save_phase;   ///< Phase to checkpoint before (--checkpoint-phase)
+    std::string script_file;  ///< Script override (--script): .hex or compiled .pgcmd
+    bool stream = false;      ///< Execute a .hex script while reading it (--stream)
+    bool back_to_back = false; ///< One register write per cycle, no idle tick (--back-to-back)
+    unsigned frames = 1;      ///< Frames to render (--frames)
+    std::string frame_phase;  ///< First phase replayed per frame (--frame-phase); empty = "main" or first
+    unsigned spi_sck_ratio = 4; ///< Core cycles per SCK period, harness_spi only (--spi-ratio)
+    unsigned cmd_interval = 1; ///< Min cycles between host writes, harness_fifo only (--cmd-interval)
+    std::string fifo_hist_file; ///< Command FIFO occupancy histogram CSV, harness_fifo only (--fifo-hist)
+    std::optional<SynthParams> synth; ///< Generated stress scene (--synth / --seed / --synth-count)
+    bool profile = false;     ///< Per-unit FSM cycle accounting (--profile)
+    std::string tri_trace_file; ///< Per-triangle CSV/JSON trace (--tri-trace)
+    std::string sdram_stats_file; ///< SDRAM bandwidth timeline CSV (--sdram-stats)
+    uint64_t sdram_window = SdramBusStats::DEFAULT_WINDOW_CYCLES; ///< --sdram-window
+    std::string sdram_image;  ///< SDRAM image file to map (--sdram-image)
+    SdramImageMode sdram_image_mode = SdramImageMode::COPY_ON_WRITE; ///< --sdram-image-mode
+    bool trace = false;       ///< Write ../build/sim_out/harness.fst
+    int argc = 0;             ///< Forwarded to VerilatedContext::commandArgs()
+    char** argv = nullptr;
+};
 
-    // Simple argument parsing: look for --test flag or positional args.
-    for (int i = 1; i < argc; i++) {
-        std::string_view arg(argv[i]);
-        if (arg == "--test" && i + 1 < argc) {
-            test_name = argv[++i];
-        } else if (arg == "--zbuf" && i + 1 < argc) {
-            zbuf_file = argv[++i];
-        } else if (arg == "--trace") {
-            // Already handled above; skip.
-        } else if (arg.find(".png") != std::string_view::npos) {
-            output_file = arg;
-        } else {
-            // Treat bare argument as test name if not a .png file
-            test_name = arg;
-        }
-    }
+/// Outcome of one harness run.
+struct RunResult {
+    int exit_code = 1;                 ///< Process exit code for this run
+    uint64_t cycles = 0;               ///< Total simulated clock cycles
+    int fb_width = 0;                  ///< Framebuffer width from the script
+    int fb_height = 0;                 ///< Framebuffer height from the script
+    std::vector<uint16_t> framebuffer; ///< Extracted RGB565 color buffer
+    std::optional<GoldenDiff> golden;  ///< Set when a golden was compared
+    SceneMetrics metrics;              ///< Performance figures (opt.metrics only)
+};
 
-    // Test name is required.
-    if (test_name.empty()) {
-        std::cerr << std::format(
-            "Usage: {} <test_name> [output.png] [--zbuf zbuf.png] [--trace]\n"
-            "  test_name: gouraud, depth_test, textured, color_combined, textured_cube,\n"
-            "             size_grid, perspective_road, indexed_pixel_art,\n"
-            "             stipple_test, alpha_blend\n",
-            argv[0]
-        );
-        return 1;
-    }
+#ifdef VERILATOR
+/// Command FIFO occupancy is sampled every cycle in the harness_fifo build.
+#ifdef SIM_DIRECT_CMD
+static constexpr bool FIFO_TELEMETRY = true;
+#else
+static constexpr bool FIFO_TELEMETRY = false;
+#endif
 
-    // Default output path: <test_name>.png in the current working directory.
-    // The Makefile runs the harness from build/sim_out/, so the default
-    // output lands there alongside any waveform traces.
-    if (output_file.empty()) {
-        output_file = std::format("{}.png", test_name);
+/// State shared by the stages of one run_test() call.
+///
+/// SceneRun owns the run's Verilator context, model and FST trace.  Its
+/// destructor runs the model's final blocks and closes the trace, so a
+/// stage that fails only reports the error and returns false.
+struct SceneRun {
+    const HarnessOptions& opt;
+    std::ostream& out;
+    std::ostream& err;
+
+    std::unique_ptr<VerilatedContext> contextp;
+    std::unique_ptr<Vgpu_top> top;
+    std::unique_ptr<VerilatedFstC> trace; ///< --trace only
+    uint64_t sim_time = 0;
+
+    std::optional<SdramModel> sdram_storage; ///< Set by open_sdram()
+    SdramPinAdapter conn;
+
+    // Script, set by load_script().  A compiled command stream (.pgcmd,
+    // see cmd_stream.hpp) is mapped and viewed in place; a .hex script is
+    // parsed.  Either way the run works on a ScriptView whose phases are
+    // spans over the owner's records.  With --stream a .hex script is
+    // instead read incrementally by run_streamed(), and `script` only
+    // collects its framebuffer size.  A --synth scene is generated
+    // straight into hex_script.
+    HexScript hex_script;
+    uint64_t synth_triangles = 0; ///< Triangles per pass of a --synth draw phase
+    std::optional<CmdStream> cmd_stream;
+    std::optional<HexStreamReader> stream_reader;
+    ScriptView script;
+    std::string hex_path;
+
+    size_t first_phase = 0;   ///< First phase to run (a restored checkpoint's)
+    std::string resume_phase; ///< Phase name a streamed restore must resume at
+    bool done = false;        ///< Post-init checkpoint written; nothing left to run
+
+    std::vector<PhaseStats> phase_stats;
+    std::vector<FrameCycles> frame_cycles; ///< One entry per frame (--frames)
+    std::vector<TimestampDirective> streamed_timestamps; ///< Backs script.timestamps
+
+    // Per-cycle probes for --profile / --tri-trace / --sdram-stats /
+    // --metrics, and command FIFO occupancy in the harness_fifo build.
+    // `probing` is false when none is enabled so the cycle loops skip
+    // sampling altogether.
+    TriangleTracer tri_tracer;
+    SdramBusStats bus_stats{opt.sdram_window};
+    CmdFifoStats fifo_stats{CMD_FIFO_DEPTH};
+    uint64_t fragment_count = 0;
+    bool count_fragments = opt.metrics || opt.synth.has_value();
+    bool probing = opt.profile || !opt.tri_trace_file.empty() || !opt.sdram_stats_file.empty()
+        || FIFO_TELEMETRY || count_fragments;
+
+    /// --fast-upload backdoor; start_model() seeds its pointer from the
+    /// register file so a restored checkpoint continues where it left off.
+    FastUpload uploader;
+    SpiLinkStats spi_stats;
+    ScriptInjection inject{
+        opt.back_to_back, opt.spi_sck_ratio, &spi_stats, std::max(opt.cmd_interval, 1u),
+        &fifo_stats};
+
+    SceneRun(const HarnessOptions& options, std::ostream& out_stream, std::ostream& err_stream)
+        : opt(options), out(out_stream), err(err_stream),
+          contextp(std::make_unique<VerilatedContext>()) {
+        if (opt.argc > 0) {
+            contextp->commandArgs(opt.argc, opt.argv);
+        }
+        contextp->traceEverOn(true);
+        top = std::make_unique<Vgpu_top>(contextp.get());
+
+        // Optional FST trace file, enabled by the --trace command-line flag.
+        if (opt.trace) {
+            trace = std::make_unique<VerilatedFstC>();
+            top->trace(trace.get(), 99);
+            trace->open("../build/sim_out/harness.fst");
+        }
     }
 
-    // Load the hex script for this test.
-    std::string hex_path = hex_file_for_test(test_name);
-    if (hex_path.empty()) {
-        std::cerr << std::format("Unknown test: {}\n", test_name);
+    ~SceneRun() {
         top->final();
         if (trace) {
             trace->close();
         }
-        return 1;
     }
 
-    HexScript script = parse_hex_file(hex_path);
-    std::cout << std::format(
-        "Loaded {} ({} phases, {} commands, fb={}x{})\n",
-        hex_path, script.phases.size(),
-        script.all_commands().size(),
-        script.fb_width, script.fb_height
-    );
-
-    // Pre-load textures from ## TEXTURE: directives.
-    preload_textures(sdram, script);
+    SceneRun(const SceneRun&) = delete;
+    SceneRun& operator=(const SceneRun&) = delete;
 
-    // -----------------------------------------------------------------------
-    // 4. Reset the GPU
-    // -----------------------------------------------------------------------
-    SdramConnState conn;
-
-    // Initialize direct register injection signals to idle
-    top->rootp->gpu_top->sim_reg_valid = 0;
-
-    reset(top.get(), trace.get(), sim_time, 100);
-
-    // -----------------------------------------------------------------------
-    // 4b. Wait for SDRAM controller initialization
-    // -----------------------------------------------------------------------
-    // The SDRAM controller starts in ST_INIT after reset and takes ~20,000+
-    // cycles (200 us at 100 MHz) to complete the power-up sequence.  During
-    // init, the controller's ready signal is deasserted, preventing any
-    // memory access.  We wait here so the rendering pipeline can access
-    // SDRAM as soon as triangles are emitted.
-    //
-    // The boot command FIFO entries are consumed during this wait (they
-    // process quickly and produce no SDRAM writes since mode_color_write=0
-    // at boot time).
-    {
-        static constexpr uint64_t SDRAM_INIT_WAIT = 25'000;
-        std::cout << std::format(
-            "Waiting {} cycles for SDRAM controller init...\n", SDRAM_INIT_WAIT
-        );
-        drain_pipeline(top.get(), trace.get(), sim_time, sdram, conn, SDRAM_INIT_WAIT);
+    SdramModel& sdram() {
+        return *sdram_storage;
     }
 
-    // -----------------------------------------------------------------------
-    // 5. Drive command script
-    // -----------------------------------------------------------------------
+    /// Probes attributing per-unit profile cycles to `stats` (none if null).
+    CycleProbes probes_for(PhaseStats* stats) {
+        return CycleProbes{
+            (opt.profile && stats) ? &stats->profile : nullptr,
+            opt.tri_trace_file.empty() ? nullptr : &tri_tracer,
+            opt.sdram_stats_file.empty() ? nullptr : &bus_stats,
+            FIFO_TELEMETRY ? &fifo_stats : nullptr,
+            count_fragments ? &fragment_count : nullptr,
+        };
+    }
 
-    /// Number of idle cycles to run between sequential script phases to
-    /// ensure the rendering pipeline has fully drained.  This is a
-    /// conservative value; the actual pipeline latency is much shorter.
-    static constexpr uint64_t PIPELINE_DRAIN_CYCLES = 10'000'000;
+    /// Phase checkpoint: state after the previous phase drained.  Returns
+    /// false (error already reported) if the checkpoint cannot be written.
+    bool checkpoint_phase(size_t pi, std::string_view name) {
+        if (opt.save_file.empty() || name != opt.save_phase) {
+            return true;
+        }
+        try {
+            save_checkpoint(opt.save_file, top.get(), sdram(), conn,
+                            {sim_time, pi, opt.test_name, std::string(name)});
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}\n", e.what());
+            return false;
+        }
+        out << std::format("Phase checkpoint written to: {}\n", opt.save_file);
+        return true;
+    }
+};
 
-    // Execute phases from the hex script.
-    // Multi-phase tests (e.g. VER-011, VER-014) get pipeline drains between
-    // phases; single-phase tests execute all commands in one batch.
-    std::cout << std::format("Running {} ({} phase(s)).\n", test_name, script.phases.size());
+// ---------------------------------------------------------------------------
+// 1. Instantiate behavioral SDRAM model
+// ---------------------------------------------------------------------------
 
-    for (size_t pi = 0; pi < script.phases.size(); pi++) {
-        const auto& phase = script.phases[pi];
-        std::cout << std::format("  Phase '{}': {} commands\n", phase.name, phase.commands.size());
+/// Create the run's SDRAM model.  With --sdram-image the model is backed
+/// by a mapped image file, so staged data is present from cycle 0; a
+/// restored checkpoint's SDRAM contents are applied on top of it.
+static bool open_sdram(SceneRun& run) {
+    const HarnessOptions& opt = run.opt;
+    try {
+        if (opt.sdram_image.empty()) {
+            run.sdram_storage.emplace(SDRAM_WORDS);
+        } else {
+            run.sdram_storage.emplace(SDRAM_WORDS, opt.sdram_image, opt.sdram_image_mode);
+            run.out << std::format(
+                "Mapped SDRAM image {} ({}, {} pages with data)\n", opt.sdram_image,
+                opt.sdram_image_mode == SdramImageMode::SHARED ? "shared" : "copy-on-write",
+                run.sdram_storage->touched_pages()
+            );
+        }
+    } catch (const std::runtime_error& e) {
+        run.err << std::format("ERROR: {}\n", e.what());
+        return false;
+    }
+    return true;
+}
 
-        execute_script(top.get(), trace.get(), sim_time, sdram, conn,
-                       std::span<const RegWrite>(phase.commands));
+// ---------------------------------------------------------------------------
+// 2. Load the test script
+// ---------------------------------------------------------------------------
 
-        // Drain pipeline between phases (not after the last phase —
-        // the main drain loop handles that).
-        if (pi + 1 < script.phases.size()) {
-            drain_pipeline(top.get(), trace.get(), sim_time, sdram, conn, PIPELINE_DRAIN_CYCLES);
-        }
+/// Load, map, generate or open (--stream) the scene's script.  A run with
+/// no test name only writes the post-init checkpoint and has no script.
+static bool load_script(SceneRun& run) {
+    const HarnessOptions& opt = run.opt;
+    std::ostream& out = run.out;
+    std::ostream& err = run.err;
+    if (opt.test_name.empty()) {
+        return true;
     }
 
-    // -----------------------------------------------------------------------
-    // 5b. Diagnostic: check state right after script execution
-    // -----------------------------------------------------------------------
-    std::cout << std::format(
+    run.hex_path =
+        opt.script_file.empty() ? hex_file_for_test(opt.test_name) : opt.script_file;
+    if (opt.synth) {
+        run.hex_path = std::format("synth:{}", synth_kind_name(opt.synth->kind));
+    }
+    const std::string& hex_path = run.hex_path;
+    if (hex_path.empty()) {
+        err << std::format("Unknown test: {}\n", opt.test_name);
+        return false;
+    }
+
+    ScriptView& script = run.script;
+    try {
+        if (opt.synth) {
+            SynthScene synth = synthesize_scene(*opt.synth);
+            out << std::format("Synthesized {}\n", synth.description);
+            run.hex_script = std::move(synth.script);
+            script = view_script(run.hex_script);
+            run.synth_triangles = synth.triangles;
+        } else if (is_cmd_stream(hex_path)) {
+            script = run.cmd_stream.emplace(hex_path).view();
+        } else if (opt.stream) {
+            run.stream_reader.emplace(hex_path);
+        } else {
+            run.hex_script = parse_hex_file(hex_path);
+            script = view_script(run.hex_script);
+        }
+    } catch (const std::runtime_error& e) {
+        err << std::format("ERROR: {}\n", e.what());
+        return false;
+    }
+    if (run.stream_reader && opt.frames > 1) {
+        err << "--frames needs the whole script; it cannot be combined with --stream\n";
+        return false;
+    }
+    if (run.stream_reader) {
+        out << std::format("Streaming {}\n", hex_path);
+    } else {
+        out << std::format(
+            "Loaded {} ({} phases, {} commands, fb={}x{})\n",
+            hex_path, script.phases.size(),
+            script.command_count(),
+            script.fb_width, script.fb_height
+        );
+    }
+
+    // A streamed script is only checked for the phase once it ends.
+    if (!run.stream_reader && !opt.save_phase.empty()
+        && std::ranges::none_of(script.phases, [&](const ScriptPhaseView& p) {
+               return p.name == opt.save_phase;
+           })) {
+        err << std::format("No phase '{}' in {}\n", opt.save_phase, hex_path);
+        return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 3. Restore from checkpoint, or reset and wait for SDRAM init
+// ---------------------------------------------------------------------------
+
+/// Bring the model to the first phase to run, then pre-load textures,
+/// arm PERF_TIMESTAMP slots and seed the fast-upload pointer.  Sets
+/// run.done when the post-init checkpoint was the whole job.
+static bool start_model(SceneRun& run) {
+    const HarnessOptions& opt = run.opt;
+    std::ostream& out = run.out;
+    std::ostream& err = run.err;
+    Vgpu_top* top = run.top.get();
+    VerilatedFstC* trace = run.trace.get();
+    uint64_t& sim_time = run.sim_time;
+    SdramModel& sdram = run.sdram();
+    const ScriptView& script = run.script;
+
+    if (!opt.restore_file.empty()) {
+        // A post-init checkpoint has an empty test name and resumes at
+        // phase 0 of any test; a phase checkpoint only resumes the test
+        // and phase it was taken from.
+        try {
+            auto header = restore_checkpoint(opt.restore_file, top, sdram, run.conn);
+            if (!header.test_name.empty()) {
+                if (header.test_name != opt.test_name) {
+                    throw std::runtime_error(std::format(
+                        "checkpoint was taken from test '{}'", header.test_name));
+                }
+                if (run.stream_reader) {
+                    run.resume_phase = header.phase_name; // checked when reached
+                } else if (header.next_phase >= script.phases.size()
+                    || script.phases[header.next_phase].name != header.phase_name) {
+                    throw std::runtime_error(std::format(
+                        "checkpoint phase '{}' does not match the script", header.phase_name));
+                }
+            }
+            sim_time = header.sim_time;
+            run.first_phase = header.next_phase;
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}: {}\n", opt.restore_file, e.what());
+            return false;
+        }
+        out << std::format(
+            "Restored {} at cycle {} (resuming at phase {})\n",
+            opt.restore_file, sim_time / 2, run.first_phase
+        );
+    } else {
+        // Initialize the injection signals to idle
+#if defined(SIM_SPI_LINK)
+        top->spi_cs_n = 1;
+        top->spi_sck = 0;
+        top->spi_mosi = 0;
+#elif defined(SIM_DIRECT_CMD)
+        top->rootp->gpu_top->sim_cmd_valid = 0;
+#else
+        top->rootp->gpu_top->sim_reg_valid = 0;
+#endif
+
+        reset(top, trace, sim_time, 100);
+
+        // The SDRAM controller starts in ST_INIT after reset and takes
+        // ~20,000+ cycles (200 us at 100 MHz) to complete the power-up
+        // sequence.  During init, the controller's ready signal is
+        // deasserted, preventing any memory access.  We wait here so the
+        // rendering pipeline can access SDRAM as soon as triangles are
+        // emitted.
+        //
+        // The boot command FIFO entries are consumed during this wait (they
+        // process quickly and produce no SDRAM writes since
+        // mode_color_write=0 at boot time).
+        static constexpr uint64_t SDRAM_INIT_WAIT = 25'000;
+        out << std::format(
+            "Waiting {} cycles for SDRAM controller init...\n", SDRAM_INIT_WAIT
+        );
+        run_cycles(top, trace, sim_time, sdram, run.conn, SDRAM_INIT_WAIT);
+
+        // Optional post-init checkpoint
+        if (!opt.save_file.empty() && opt.save_phase.empty()) {
+            try {
+                save_checkpoint(opt.save_file, top, sdram, run.conn, {sim_time, 0, {}, {}});
+            } catch (const std::runtime_error& e) {
+                err << std::format("ERROR: {}\n", e.what());
+                return false;
+            }
+            out << std::format("Post-init checkpoint written to: {}\n", opt.save_file);
+            if (opt.test_name.empty()) {
+                run.done = true;
+                return true;
+            }
+        }
+    }
+
+    // Pre-load textures from ## TEXTURE: directives.  A phase checkpoint
+    // already holds whatever an earlier run pre-loaded.
+    if (run.first_phase == 0) {
+        preload_textures(sdram, script);
+    }
+
+    // Arm the PERF_TIMESTAMP slots of the phases about to run, so a marker
+    // the GPU never reaches is reported as such (perf_timestamps.hpp).
+    // Streamed markers are armed as they are read.
+    for (const auto& ts : script.timestamps) {
+        if (ts.phase_index >= run.first_phase) {
+            arm_perf_timestamp(sdram, ts.word_addr);
+        }
+    }
+
+    run.uploader = FastUpload(top->rootp->gpu_top->u_register_file->mem_addr_reg);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 4. Drive command script
+// ---------------------------------------------------------------------------
+//
+// Multi-phase tests (e.g. VER-011, VER-014) drain the pipeline between
+// phases; the drain ends as soon as every unit is idle, so the cost of
+// each phase tracks the work it actually does.
+
+/// Run a loaded script's phases, once or for every --frames frame.
+static bool run_phases(SceneRun& run) {
+    const HarnessOptions& opt = run.opt;
+    std::ostream& out = run.out;
+    Vgpu_top* top = run.top.get();
+    VerilatedFstC* trace = run.trace.get();
+    uint64_t& sim_time = run.sim_time;
+    SdramModel& sdram = run.sdram();
+    SdramPinAdapter& conn = run.conn;
+    const ScriptView& script = run.script;
+    const size_t first_phase = run.first_phase;
+    std::vector<PhaseStats>& phase_stats = run.phase_stats;
+    FastUpload& uploader = run.uploader;
+    const bool probing = run.probing;
+
+    out << std::format("Running {} ({} phase(s)).\n", opt.test_name, script.phases.size());
+    phase_stats.reserve(script.phases.size());
+
+    // --frames: frame 0 runs every phase (so its render cycles include
+    // any setup phases); later frames replay the phases from
+    // --frame-phase on, or from "main" when the script has one (the
+    // VER scripts upload palettes and indices in phases before it),
+    // else from the first phase.  Each frame is drained, presented and
+    // synced to vsync; a phase's stats accumulate over frames.  Every
+    // frame renders into the same buffer (present_frame re-presents it,
+    // it does not swap), and the report keeps frame 0 out of the
+    // steady-state statistics.
+    unsigned frames = std::max(opt.frames, 1u);
+    auto find_phase = [&](std::string_view name) {
+        auto it = std::ranges::find_if(script.phases, [&](const ScriptPhaseView& p) {
+            return p.name == name;
+        });
+        return static_cast<size_t>(it - script.phases.begin());
+    };
+    size_t frame_begin = first_phase;
+    if (opt.frame_phase.empty()) {
+        size_t main_phase = find_phase("main");
+        if (main_phase < script.phases.size() && main_phase >= first_phase) {
+            frame_begin = main_phase;
+        }
+    } else {
+        frame_begin = find_phase(opt.frame_phase);
+        if (frame_begin == script.phases.size() || frame_begin < first_phase) {
+            run.err << std::format(
+                "No phase '{}' at or after the resume phase in {}\n", opt.frame_phase,
+                run.hex_path);
+            return false;
+        }
+    }
+    if (frames > 1 && frame_begin < script.phases.size()) {
+        out << std::format(
+            "Frames 1-{} replay from phase '{}'.\n", frames - 1, script.phases[frame_begin].name);
+    }
+
+    for (unsigned frame = 0; frame < frames; frame++) {
+        uint64_t frame_start = sim_time;
+        for (size_t pi = frame == 0 ? first_phase : frame_begin; pi < script.phases.size();
+             pi++) {
+            const auto& phase = script.phases[pi];
+
+            if (frame == 0) {
+                if (!run.checkpoint_phase(pi, phase.name)) {
+                    return false;
+                }
+                out << std::format(
+                    "  Phase '{}': {} commands\n", phase.name, phase.commands.size());
+                phase_stats.push_back(PhaseStats{std::string(phase.name), 0});
+            }
+
+            PhaseStats& stats = phase_stats[pi - first_phase];
+            stats.commands += phase.commands.size();
+            CycleProbes probes = run.probes_for(&stats);
+            run.tri_tracer.set_phase(stats.name);
+            std::span<const RegWrite> commands = phase.commands;
+            if (!opt.fast_upload) {
+                uint64_t start = sim_time;
+                execute_script(top, trace, sim_time, sdram, conn, commands,
+                               run.inject, probing ? &probes : nullptr);
+                stats.script_cycles += (sim_time - start) / 2;
+            }
+            // --fast-upload: alternate backdoor upload runs with the
+            // writes between them, draining before every run but the
+            // first (the phase starts drained).
+            while (opt.fast_upload && !commands.empty()) {
+                size_t fast = uploader.apply_prefix(sdram, commands);
+                stats.fast_uploads += fast;
+                commands = commands.subspan(fast);
+                std::span<const RegWrite> rtl = commands.first(FastUpload::rtl_prefix(commands));
+                commands = commands.subspan(rtl.size());
+
+                uint64_t start = sim_time;
+                if (uploader.needs_sync()) {
+                    RegWrite sync = uploader.sync_write();
+                    execute_script(top, trace, sim_time, sdram, conn,
+                                   std::span<const RegWrite>(&sync, 1), run.inject,
+                                   probing ? &probes : nullptr);
+                }
+                execute_script(top, trace, sim_time, sdram, conn, rtl, run.inject,
+                               probing ? &probes : nullptr);
+                stats.script_cycles += (sim_time - start) / 2;
+                if (!commands.empty()) {
+                    stats.drain_cycles += drain_pipeline(
+                        top, trace, sim_time, sdram, conn,
+                        PIPELINE_DRAIN_MAX_CYCLES, probing ? &probes : nullptr);
+                }
+            }
+
+            // Drain pipeline between phases and at the end of every
+            // frame of a multi-frame run.  A single-frame run leaves
+            // its last phase to the main drain loop.
+            if (pi + 1 < script.phases.size() || frames > 1) {
+                stats.drain_cycles += drain_pipeline(
+                    top, trace, sim_time, sdram, conn,
+                    PIPELINE_DRAIN_MAX_CYCLES, probing ? &probes : nullptr);
+            }
+        }
+
+        if (frames > 1) {
+            FrameCycles fc{(sim_time - frame_start) / 2, 0};
+            CycleProbes probes = run.probes_for(nullptr);
+            fc.vsync_wait = present_frame(top, trace, sim_time, sdram, conn,
+                                          run.inject, probing ? &probes : nullptr);
+            run.frame_cycles.push_back(fc);
+        }
+    }
+    return true;
+}
+
+/// Run a --stream script.  Commands are injected in fixed-size batches as
+/// they are read, so memory use does not grow with the script and the
+/// GPU starts on the first command.  Phases are numbered as
+/// parse_hex_file() would number them (an implicit "main" phase exists
+/// only once it has a command), so checkpoints taken from a streamed run
+/// and a parsed run are interchangeable.  Phases before a restored
+/// checkpoint's phase are read and discarded.
+static bool run_streamed(SceneRun& run) {
+    const HarnessOptions& opt = run.opt;
+    std::ostream& out = run.out;
+    std::ostream& err = run.err;
+    Vgpu_top* top = run.top.get();
+    VerilatedFstC* trace = run.trace.get();
+    uint64_t& sim_time = run.sim_time;
+    SdramModel& sdram = run.sdram();
+    SdramPinAdapter& conn = run.conn;
+    const size_t first_phase = run.first_phase;
+    FastUpload& uploader = run.uploader;
+    const bool probing = run.probing;
+
+    out << std::format("Running {} (streamed).\n", opt.test_name);
+
+    static constexpr size_t STREAM_BATCH = 1024;
+    std::array<RegWrite, STREAM_BATCH> batch;
+    size_t batch_len = 0;
+    size_t phase_count = 0; // phases opened so far
+    bool phase_open = false;
+    bool save_phase_seen = false;
+    bool fast_phase = false; // --fast-upload applies to the current phase
+    bool upload_run = false; // pipeline drained: upload writes take the backdoor
+    PhaseStats stats;
+    CycleProbes probes = run.probes_for(&stats);
+
+    auto flush_batch = [&] {
+        if (batch_len > 0 && phase_count > first_phase) {
+            uint64_t start = sim_time;
+            execute_script(top, trace, sim_time, sdram, conn,
+                           std::span<const RegWrite>(batch.data(), batch_len),
+                           run.inject, probing ? &probes : nullptr);
+            stats.script_cycles += (sim_time - start) / 2;
+        }
+        batch_len = 0;
+    };
+    // End an upload run: queue the MEM_ADDR write that syncs the RTL
+    // pointer with the backdoor's.  The batch is never full between
+    // commands, so there is room for it.
+    auto end_upload_run = [&] {
+        upload_run = false;
+        if (uploader.needs_sync()) {
+            batch[batch_len++] = uploader.sync_write();
+        }
+    };
+    // Close the current phase; drains unless it is the last one.
+    auto end_phase = [&](bool last) {
+        end_upload_run();
+        flush_batch();
+        if (phase_count > first_phase) {
+            out << std::format("  Phase '{}': {} commands\n", stats.name, stats.commands);
+            if (!last) {
+                stats.drain_cycles += drain_pipeline(
+                    top, trace, sim_time, sdram, conn, PIPELINE_DRAIN_MAX_CYCLES,
+                    probing ? &probes : nullptr);
+            }
+            run.phase_stats.push_back(std::move(stats));
+        }
+        phase_open = false;
+    };
+    auto begin_phase = [&](std::string_view name) {
+        if (phase_open) {
+            end_phase(false);
+        }
+        size_t pi = phase_count++;
+        phase_open = true;
+        fast_phase = opt.fast_upload && pi >= first_phase;
+        upload_run = fast_phase;
+        stats = PhaseStats{std::string(name), 0};
+        run.tri_tracer.set_phase(stats.name);
+        save_phase_seen = save_phase_seen || name == opt.save_phase;
+        if (pi < first_phase) {
+            return true;
+        }
+        if (pi == first_phase && !run.resume_phase.empty() && name != run.resume_phase) {
+            err << std::format(
+                "ERROR: {}: checkpoint phase '{}' does not match the script\n",
+                opt.restore_file, run.resume_phase);
+            return false;
+        }
+        return run.checkpoint_phase(pi, name);
+    };
+
+    bool ok = true;
+    try {
+        HexEvent ev;
+        while (ok && run.stream_reader->next(ev)) {
+            switch (ev.kind) {
+                case HexEventKind::TIMESTAMP:
+                    // Record the label, then inject the marker write
+                    // like any other command.
+                    if (!phase_open) {
+                        ok = begin_phase("main");
+                    }
+                    run.streamed_timestamps.push_back({
+                        std::string(ev.name),
+                        static_cast<uint32_t>(ev.command.data),
+                        stats.name,
+                        phase_count - 1,
+                    });
+                    if (phase_count > first_phase) {
+                        arm_perf_timestamp(sdram, run.streamed_timestamps.back().word_addr);
+                    }
+                    [[fallthrough]];
+                case HexEventKind::COMMAND:
+                    if (!phase_open) {
+                        ok = begin_phase("main");
+                    }
+                    stats.commands++;
+                    if (fast_phase && FastUpload::is_upload(ev.command.addr)) {
+                        if (!upload_run) {
+                            // Writes since the last run may still have
+                            // SDRAM traffic in flight: run and drain them
+                            // before the backdoor touches SDRAM.
+                            flush_batch();
+                            stats.drain_cycles += drain_pipeline(
+                                top, trace, sim_time, sdram, conn,
+                                PIPELINE_DRAIN_MAX_CYCLES, probing ? &probes : nullptr);
+                            upload_run = true;
+                        }
+                        uploader.apply(sdram, ev.command);
+                        stats.fast_uploads++;
+                        break;
+                    }
+                    if (upload_run) {
+                        end_upload_run();
+                    }
+                    batch[batch_len++] = {ev.command.addr, ev.command.data};
+                    if (batch_len == STREAM_BATCH) {
+                        flush_batch();
+                    }
+                    break;
+                case HexEventKind::PHASE:
+                    ok = begin_phase(ev.name);
+                    break;
+                case HexEventKind::FRAMEBUFFER:
+                    if (ev.fb_width > 0) {
+                        run.script.fb_width = ev.fb_width;
+                    }
+                    if (ev.fb_height > 0) {
+                        run.script.fb_height = ev.fb_height;
+                    }
+                    break;
+                case HexEventKind::TEXTURE:
+                    if (first_phase == 0) {
+                        preload_texture(sdram, ev.texture);
+                    }
+                    break;
+                case HexEventKind::INCLUDE:
+                    break;
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        err << std::format("ERROR: {}: {}\n", run.hex_path, e.what());
+        ok = false;
+    }
+    if (ok && phase_open) {
+        end_phase(true);
+    }
+    if (ok && first_phase > 0 && phase_count <= first_phase) {
+        err << std::format(
+            "ERROR: {}: script has no phase {} to resume at\n", opt.restore_file, first_phase);
+        ok = false;
+    }
+    if (ok && !opt.save_phase.empty() && !save_phase_seen) {
+        err << std::format("No phase '{}' in {}\n", opt.save_phase, run.hex_path);
+        ok = false;
+    }
+    if (!ok) {
+        return false;
+    }
+    out << std::format("Streamed {} phase(s).\n", phase_count);
+    run.script.timestamps = run.streamed_timestamps;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 5. Run clock until rendering completes
+// ---------------------------------------------------------------------------
+
+/// Drain the last phase with per-cycle diagnostics and log the state
+/// right after the script and after the drain.
+static void drain_with_diagnostics(SceneRun& run) {
+    std::ostream& out = run.out;
+    Vgpu_top* top = run.top.get();
+    VerilatedFstC* trace = run.trace.get();
+    uint64_t& sim_time = run.sim_time;
+    SdramModel& sdram = run.sdram();
+    SdramPinAdapter& conn = run.conn;
+    std::vector<PhaseStats>& phase_stats = run.phase_stats;
+
+    // Diagnostic: check state right after script execution
+    out << std::format(
         "DIAG (post-script): rast state={}, tri_valid={}, vertex_count={}\n",
         static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->state),
         static_cast<unsigned>(top->rootp->gpu_top->tri_valid),
         static_cast<unsigned>(top->rootp->gpu_top->u_register_file->vertex_count)
     );
-    std::cout << std::format(
+    out << std::format(
         "DIAG (post-script): render_mode=0x{:x}\n",
         static_cast<uint64_t>(top->rootp->gpu_top->u_register_file->render_mode_reg)
     );
-    std::cout << std::format(
+    out << std::format(
         "DIAG (post-script): ccache_state={}\n",
         static_cast<unsigned>(top->rootp->gpu_top->__PVT__u_color_tile_cache__DOT__state)
     );
 
-    // -----------------------------------------------------------------------
-    // 6. Run clock until rendering completes
-    // -----------------------------------------------------------------------
-    // Run a fixed cycle budget after the last script entry to allow the
-    // rendering pipeline to drain.  connect_sdram() is called each cycle
-    // to keep the behavioral SDRAM model synchronized.
+    // Same event-driven drain as drain_pipeline(), with per-cycle
+    // diagnostics.  connect_sdram() is called each cycle to keep the
+    // behavioral SDRAM model synchronized.  Under --profile the drain is
+    // accounted to the last phase, as its drain_cycles are.
     {
+        CycleProbes drain_probes =
+            run.probes_for(phase_stats.empty() ? nullptr : &phase_stats.back());
         uint64_t tri_valid_seen = 0;
         uint64_t write_pixel_count = 0;
         uint64_t edge_test_count = 0;
@@ -707,29 +1682,32 @@ int main(int argc, char** argv) {
         uint64_t port1_req_count = 0;
         bool rast_started = false;
         bool diag_printed = false;
-        for (uint64_t i = 0; i < PIPELINE_DRAIN_CYCLES && !contextp->gotFinish(); i++) {
-            tick(top.get(), trace.get(), sim_time);
-            connect_sdram(top.get(), sdram, conn);
+        uint64_t idle_run = 0;
+        uint64_t drain_cycles = PIPELINE_DRAIN_MAX_CYCLES;
+        for (uint64_t i = 0; i < PIPELINE_DRAIN_MAX_CYCLES && !run.contextp->gotFinish(); i++) {
+            tick(top, trace, sim_time);
+            connect_sdram(top, sdram, conn);
+            probe_cycle(top, sim_time, run.probing ? &drain_probes : nullptr);
 
             unsigned rast_state = top->rootp->gpu_top->u_rasterizer->state;
             unsigned pp_state = top->rootp->gpu_top->u_pixel_pipeline->state;
 
             // Print pixel pipeline state when rasterizer is stuck
             if (rast_state == 5 && i < 5) {
-                std::cout << std::format(
+                out << std::format(
                     "DIAG: drain cycle {} — rast=INTERPOLATE, pp_state={}\n", i, pp_state);
             }
 
             if (top->rootp->gpu_top->tri_valid) {
                 tri_valid_seen++;
                 if (tri_valid_seen <= 5) {
-                    std::cout << std::format("DIAG: tri_valid pulse at drain cycle {}\n", i);
+                    out << std::format("DIAG: tri_valid pulse at drain cycle {}\n", i);
                 }
             }
 
             if (rast_state != 0 && !rast_started) {
                 rast_started = true;
-                std::cout << std::format(
+                out << std::format(
                     "DIAG: Rasterizer started at drain cycle {}, state={}\n", i, rast_state
                 );
             }
@@ -737,7 +1715,7 @@ int main(int argc, char** argv) {
             // Print bbox and vertex data once after SETUP
             if (rast_state == 1 && !diag_printed) { // SETUP = 1
                 diag_printed = true;
-                std::cout << std::format(
+                out << std::format(
                     "DIAG: SETUP — vertices: ({},{}) ({},{}) ({},{})\n",
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->x0),
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->y0),
@@ -750,8 +1728,8 @@ int main(int argc, char** argv) {
                 // from the rasterizer after the incremental interpolation
                 // redesign.  Vertex colors are now latched internally as
                 // v0_color0..v2_color0 and not exposed via verilator public.
-                std::cout << "DIAG: SETUP — vertex colors latched (not exposed)\n";
-                std::cout << std::format(
+                out << "DIAG: SETUP — vertex colors latched (not exposed)\n";
+                out << std::format(
                     "DIAG: SETUP — inv_area=0x{:05x} area_shift={}\n",
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->inv_area),
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->area_shift));
@@ -759,14 +1737,14 @@ int main(int argc, char** argv) {
 
             // Print bbox once after SETUP completes
             if (rast_state == 2 && edge_test_count == 0) { // ITER_START = 2
-                std::cout << std::format(
+                out << std::format(
                     "DIAG: ITER_START — bbox: x[{}..{}] y[{}..{}]\n",
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->bbox_min_x),
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->bbox_max_x),
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->bbox_min_y),
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->bbox_max_y)
                 );
-                std::cout << std::format(
+                out << std::format(
                     "DIAG: ITER_START — inv_area=0x{:05x} area_shift={}\n",
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->inv_area),
                     static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->area_shift));
@@ -794,41 +1772,26 @@ int main(int argc, char** argv) {
                 port1_req_count++;
             }
 
-            // Once the rasterizer returns to IDLE and we've started, we can
-            // stop early — but only when the command FIFO is also empty,
-            // no more vertices are pending, and no triangle is being
-            // submitted (tri_valid).  With serialized setup/iteration,
-            // the rasterizer returns to IDLE between every triangle pair;
-            // checking tri_valid prevents premature exit when a new
-            // triangle is being accepted on the same cycle.
-            bool fifo_empty = top->gpio_cmd_empty;
-            unsigned vtx_count = top->rootp->gpu_top->u_register_file->vertex_count;
-            bool setup_fifo_empty = top->rootp->gpu_top->u_rasterizer->fifo_empty;
-            bool tri_valid_now = top->rootp->gpu_top->tri_valid;
-            // UNIT-013 color tile cache must also be idle (not mid-flush
-            // from FB_CACHE_CTRL.FLUSH_TRIGGER) before extraction is safe.
-            // The flush FSM exits to S_IDLE (state=0) after the last dirty
-            // line is written back; checking state here prevents premature
-            // extraction with stale SDRAM contents for the resident cache
-            // lines.
-            unsigned ccache_state = top->rootp->gpu_top->__PVT__u_color_tile_cache__DOT__state;
-            if (rast_started && rast_state == 0 && fifo_empty && setup_fifo_empty && vtx_count == 0 && !tri_valid_now && ccache_state == 0 && i > 100) {
-                std::cout << std::format(
-                    "DIAG: Rasterizer returned to IDLE at drain cycle {}\n", i
+            // Stop once every unit has been idle for the settle window
+            // (see pipeline_idle()).  With serialized setup/iteration the
+            // rasterizer returns to IDLE between every triangle pair, and
+            // the UNIT-013 color tile cache runs its FB_CACHE_CTRL flush
+            // after the last fragment, so a single idle sample is not
+            // enough to make extraction safe.
+            idle_run = pipeline_idle(top) ? idle_run + 1 : 0;
+            if (idle_run >= PIPELINE_IDLE_SETTLE_CYCLES) {
+                out << std::format(
+                    "DIAG: Pipeline idle at drain cycle {}\n", i - idle_run + 1
                 );
-                // Continue for a short period to drain any pending writes
-                for (uint64_t j = 0; j < 1000; j++) {
-                    tick(top.get(), trace.get(), sim_time);
-                    connect_sdram(top.get(), sdram, conn);
-                    if (top->rootp->gpu_top->arb_port1_req) {
-                        port1_req_count++;
-                    }
-                }
+                drain_cycles = i + 1;
                 break;
             }
         }
-        std::cout << std::format("DIAG: tri_valid seen {} times during drain\n", tri_valid_seen);
-        std::cout << std::format(
+        if (!phase_stats.empty()) {
+            phase_stats.back().drain_cycles += drain_cycles;
+        }
+        out << std::format("DIAG: tri_valid seen {} times during drain\n", tri_valid_seen);
+        out << std::format(
             "DIAG: edge_test={}, edge_pass={}, write_pixel={}, "
             "port1_req={}\n",
             edge_test_count,
@@ -839,114 +1802,300 @@ int main(int argc, char** argv) {
         // Z-buffer and write-pixel diagnostics are now in pixel_pipeline.
     }
 
-    // -----------------------------------------------------------------------
-    // 6b. Diagnostic: Rasterizer state check
-    // -----------------------------------------------------------------------
-    std::cout << std::format(
+    // Diagnostic: Rasterizer state check
+    out << std::format(
         "DIAG: Rasterizer state after drain: {}\n",
         static_cast<unsigned>(top->rootp->gpu_top->u_rasterizer->state)
     );
-    std::cout << std::format(
+    out << std::format(
         "DIAG: ccache_state after drain: {}\n",
         static_cast<unsigned>(top->rootp->gpu_top->__PVT__u_color_tile_cache__DOT__state)
     );
-    std::cout << std::format(
+    out << std::format(
         "DIAG: tri_valid={}, vertex_count={}\n",
         static_cast<unsigned>(top->rootp->gpu_top->tri_valid),
         static_cast<unsigned>(top->rootp->gpu_top->u_register_file->vertex_count)
     );
-    std::cout << std::format(
+    out << std::format(
         "DIAG: render_mode=0x{:x}\n",
         static_cast<uint64_t>(top->rootp->gpu_top->u_register_file->render_mode_reg)
     );
-    std::cout << std::format(
+    out << std::format(
         "DIAG: fb_config=0x{:x}\n",
         static_cast<uint64_t>(top->rootp->gpu_top->u_register_file->fb_config_reg)
     );
 
-    // -----------------------------------------------------------------------
-    // 6c. Diagnostic: SDRAM command counts
-    // -----------------------------------------------------------------------
-    std::cout << std::format(
+    // Diagnostic: SDRAM command counts
+    out << std::format(
         "DIAG: SDRAM commands: {} ACTIVATEs, {} WRITEs, {} READs\n",
         conn.activate_count,
         conn.write_count,
         conn.read_count
     );
-    std::cout << std::format("DIAG: Total sim cycles: {}\n", sim_time / 2);
+}
 
-    // -----------------------------------------------------------------------
-    // 6d. Hi-Z tile rejection counter (VER-011 step 11)
-    // -----------------------------------------------------------------------
+// ---------------------------------------------------------------------------
+// 6. Reports
+// ---------------------------------------------------------------------------
+
+/// Log the run's cycle, SDRAM, link, frame, throughput and profile
+/// reports, write the optional report files, fill result.cycles and
+/// result.metrics, and apply the depth_test Hi-Z check.
+static bool report_run(SceneRun& run, RunResult& result) {
+    const HarnessOptions& opt = run.opt;
+    std::ostream& out = run.out;
+    std::ostream& err = run.err;
+    Vgpu_top* top = run.top.get();
+    const SdramPinAdapter& conn = run.conn;
+    const ScriptView& script = run.script;
+    const std::vector<PhaseStats>& phase_stats = run.phase_stats;
+    const uint64_t fragment_count = run.fragment_count;
+
+    // Row locality, per-port traffic and bandwidth timeline (--sdram-stats).
+    if (!opt.sdram_stats_file.empty()) {
+        out << run.bus_stats.report();
+        try {
+            run.bus_stats.write_timeline_csv(opt.sdram_stats_file);
+            out << std::format("SDRAM timeline written to: {}\n", opt.sdram_stats_file);
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}\n", e.what());
+            return false;
+        }
+    }
+    out << std::format("DIAG: Total sim cycles: {}\n", run.sim_time / 2);
+    result.cycles = run.sim_time / 2;
+
+    // Machine-readable figures for --metrics / --baseline; the caller
+    // adds the simulation rate.
+    if (opt.metrics) {
+        SceneMetrics& m = result.metrics;
+        m.scene = opt.test_name;
+        m.cycles = result.cycles;
+        for (const auto& ps : phase_stats) {
+            m.phase_cycles.emplace_back(ps.name, ps.script_cycles + ps.drain_cycles);
+        }
+        m.sdram_activates = conn.activate_count;
+        m.sdram_reads = conn.read_count;
+        m.sdram_writes = conn.write_count;
+        m.hiz_rejected_tiles = top->rootp->gpu_top->hiz_rejected_tiles;
+        m.fragments = fragment_count;
+    }
+
+    // Per-phase cycle report: script injection vs. drain-to-idle.
+    out << "Phase cycles:\n";
+    size_t injected = 0;
+    uint64_t injected_cycles = 0;
+    for (const auto& ps : phase_stats) {
+        injected += ps.commands - ps.fast_uploads;
+        injected_cycles += ps.script_cycles;
+        out << std::format(
+            "  {:<20} {:>6} cmds  {:>10} script  {:>10} drain  {:>10} total{}\n",
+            ps.name, ps.commands, ps.script_cycles, ps.drain_cycles,
+            ps.script_cycles + ps.drain_cycles,
+            ps.fast_uploads ? std::format("  ({} fast-uploaded)", ps.fast_uploads) : ""
+        );
+    }
+    // Register writes driven through RTL vs. the cycles spent driving
+    // them (gpu_busy stalls included); 1.0 is the command-bound limit.
+#if defined(SIM_SPI_LINK)
+    std::string injection = std::format("SPI link, {} cycles/SCK", opt.spi_sck_ratio);
+#elif defined(SIM_DIRECT_CMD)
+    std::string injection =
+        std::format("command FIFO, 1 write per {} cycles", run.inject.cmd_interval);
+#else
+    std::string injection = opt.back_to_back ? "back-to-back" : "valid every other cycle";
+#endif
+    if (injected > 0) {
+        out << std::format(
+            "Command rate: {} writes in {} script cycles ({:.2f} cycles/write, {})\n",
+            injected, injected_cycles, static_cast<double>(injected_cycles) / injected,
+            injection);
+    }
+#ifdef SIM_SPI_LINK
+    // End-to-end frame cycles (script + drain of every phase run) and the
+    // part of them the GPU spent idle with an empty command FIFO while the
+    // host was still sending: the cost of the link.
+    {
+        const SpiLinkStats& spi_stats = run.spi_stats;
+        uint64_t frame_cycles = 0;
+        for (const auto& ps : phase_stats) {
+            frame_cycles += ps.script_cycles + ps.drain_cycles;
+        }
+        out << std::format(
+            "SPI link: {} writes, {} cycles on the wire, {} stalled on CMD_FULL\n"
+            "SPI link: frame {} cycles end to end, GPU idle waiting on the link "
+            "{} cycles ({:.1f}%)\n",
+            spi_stats.writes, spi_stats.link_cycles, spi_stats.full_cycles, frame_cycles,
+            spi_stats.starved_cycles,
+            frame_cycles > 0 ? 100.0 * spi_stats.starved_cycles / frame_cycles : 0.0);
+    }
+#endif
+#ifdef SIM_DIRECT_CMD
+    // Command FIFO occupancy over the whole run (scripts and drains).
+    out << run.fifo_stats.report();
+    if (!opt.fifo_hist_file.empty()) {
+        try {
+            run.fifo_stats.write_histogram_csv(opt.fifo_hist_file);
+            out << std::format("FIFO histogram written to: {}\n", opt.fifo_hist_file);
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}\n", e.what());
+            return false;
+        }
+    }
+#endif
+    if (opt.fast_upload) {
+        out << std::format(
+            "Fast upload: {} MEM_ADDR/MEM_DATA/MEM_FILL writes ({} words) applied to "
+            "the SDRAM model\n",
+            run.uploader.writes(), run.uploader.words());
+    }
+
+    // Per-frame render / vsync cycles against the 60 Hz budget (--frames).
+    out << format_frame_report(run.frame_cycles);
+
+    // Throughput of a generated scene's draw phase (--synth): script plus
+    // drain cycles of every pass, projected at the core clock.
+    if (opt.synth) {
+        auto draw = std::ranges::find(phase_stats, std::string("draw"), &PhaseStats::name);
+        auto phase = std::ranges::find_if(script.phases, [](const ScriptPhaseView& p) {
+            return p.name == "draw";
+        });
+        if (draw != phase_stats.end() && phase != script.phases.end()
+            && !phase->commands.empty()) {
+            uint64_t passes = draw->commands / phase->commands.size();
+            uint64_t triangles = run.synth_triangles * passes;
+            uint64_t cycles = draw->script_cycles + draw->drain_cycles;
+            double seconds = static_cast<double>(cycles) / CORE_CLOCK_HZ;
+            out << std::format(
+                "Synth throughput: {} triangles, {} fragments ({:.2f} per framebuffer pixel) "
+                "in {} draw cycles\n"
+                "  {:.1f} cycles/triangle, {:.2f} cycles/fragment; at {} MHz: {:.2f} Mtri/s, "
+                "{:.2f} Mfrag/s\n",
+                triangles, fragment_count,
+                static_cast<double>(fragment_count)
+                    / (static_cast<double>(script.fb_width) * script.fb_height * passes),
+                cycles, triangles ? static_cast<double>(cycles) / triangles : 0.0,
+                fragment_count ? static_cast<double>(cycles) / fragment_count : 0.0,
+                CORE_CLOCK_HZ / 1'000'000,
+                seconds > 0.0 ? triangles / seconds / 1e6 : 0.0,
+                seconds > 0.0 ? fragment_count / seconds / 1e6 : 0.0);
+        }
+    }
+
+    // PERF_TIMESTAMP markers ('## TIMESTAMP:'), read back from SDRAM.
+    if (!script.timestamps.empty()) {
+        out << format_perf_timeline(run.sdram(), script.timestamps);
+    }
+
+    // Per-unit cycle accounting (--profile): each phase, then the run.
+    if (opt.profile) {
+        UnitProfile total;
+        for (const auto& ps : phase_stats) {
+            out << format_unit_profile(std::format("phase '{}'", ps.name), ps.profile);
+            total.merge(ps.profile);
+        }
+        if (phase_stats.size() > 1) {
+            out << format_unit_profile(opt.test_name, total);
+        }
+    }
+
+    // Per-triangle stage timing (--tri-trace).
+    if (!opt.tri_trace_file.empty()) {
+        out << run.tri_tracer.summary() << "\n";
+        try {
+            run.tri_tracer.write(opt.tri_trace_file);
+            out << std::format("Triangle trace written to: {}\n", opt.tri_trace_file);
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}\n", e.what());
+            return false;
+        }
+    }
+
+    // Hi-Z tile rejection counter (VER-011 step 11).
     // Read the Hi-Z rejected_tiles counter from raster_hiz_meta via gpu_top.
     // For the depth_test scene (VER-011) with GEQUAL/reverse-Z:
     // Triangle A (far, Z=0x4000) is drawn first, Triangle B (near, Z=0x8000)
     // second.  Since Triangle B is nearer, its frag_z[15:8]=0x80 >= min_z=0x40
     // so Hi-Z never rejects — the counter should be 0.
-    {
-        auto hiz_rejects = static_cast<uint32_t>(
-            top->rootp->gpu_top->hiz_rejected_tiles);
-        std::cout << std::format(
-            "DIAG: Hi-Z rejected tiles: {}\n", hiz_rejects);
-
-        if (test_name == "depth_test") {
-            if (hiz_rejects != 0) {
-                std::cerr << std::format(
-                    "ERROR: Hi-Z rejection counter is {} for depth_test "
-                    "scene, expected 0 (nearer Triangle B should not be "
-                    "rejected by further Triangle A metadata).\n",
-                    hiz_rejects);
-                top->final();
-                if (trace) {
-                    trace->close();
-                }
-                return 1;
-            }
-            std::cout << "PASS: Hi-Z rejection counter = 0 (nearer triangle "
-                         "not rejected, VER-011 step 11)\n";
+    auto hiz_rejects = static_cast<uint32_t>(top->rootp->gpu_top->hiz_rejected_tiles);
+    out << std::format("DIAG: Hi-Z rejected tiles: {}\n", hiz_rejects);
+
+    if (opt.test_name == "depth_test") {
+        if (hiz_rejects != 0) {
+            err << std::format(
+                "ERROR: Hi-Z rejection counter is {} for depth_test "
+                "scene, expected 0 (nearer Triangle B should not be "
+                "rejected by further Triangle A metadata).\n",
+                hiz_rejects);
+            return false;
         }
+        out << "PASS: Hi-Z rejection counter = 0 (nearer triangle "
+                     "not rejected, VER-011 step 11)\n";
     }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 7. Framebuffer readback and output
+// ---------------------------------------------------------------------------
 
-    // -----------------------------------------------------------------------
-    // 7. Diagnostic: count non-zero words in the SDRAM model
-    // -----------------------------------------------------------------------
+/// Read back the color buffer into result, compare it with the golden,
+/// and write the image, diff, Z-buffer and shared SDRAM image outputs.
+static bool read_back(SceneRun& run, RunResult& result) {
+    const HarnessOptions& opt = run.opt;
+    std::ostream& out = run.out;
+    std::ostream& err = run.err;
+    Vgpu_top* top = run.top.get();
+    SdramModel& sdram = run.sdram();
+    const std::string& output_file = opt.output_file;
+
+    // Diagnostic: count non-zero words in the SDRAM model.  Only touched
+    // pages can hold non-zero data, so scan just those.
     {
         uint32_t non_zero = 0;
         uint32_t first_nz_addr = 0;
         uint16_t first_nz_val = 0;
-        for (uint32_t a = 0; a < SDRAM_WORDS; a++) {
-            uint16_t w = sdram.read_word(a);
-            if (w != 0) {
-                if (non_zero == 0) {
-                    first_nz_addr = a;
-                    first_nz_val = w;
+        sdram.for_each_dirty_range([&](uint32_t first_word, std::span<const uint16_t> words) {
+            for (size_t i = 0; i < words.size(); i++) {
+                if (words[i] != 0) {
+                    if (non_zero == 0) {
+                        first_nz_addr = first_word + static_cast<uint32_t>(i);
+                        first_nz_val = words[i];
+                    }
+                    non_zero++;
                 }
-                non_zero++;
             }
-        }
-        std::cout << std::format(
-            "DIAG: Non-zero SDRAM words (full scan): {} / {}\n", non_zero, SDRAM_WORDS
+        });
+        out << std::format(
+            "DIAG: Non-zero SDRAM words: {} / {} ({} of {} pages touched)\n", non_zero,
+            SDRAM_WORDS, sdram.touched_pages(), SDRAM_WORDS / SdramModel::PAGE_WORDS
         );
         if (non_zero > 0) {
-            std::cout << std::format(
+            out << std::format(
                 "DIAG: First non-zero at word 0x{:06X} = 0x{:04X}\n", first_nz_addr, first_nz_val
             );
         }
     }
 
-    // -----------------------------------------------------------------------
-    // 7b. Extract framebuffer and write PNG
-    // -----------------------------------------------------------------------
     // The color tile cache (UNIT-013) is write-back, but the test hex
     // scripts terminate with FB_CACHE_CTRL.FLUSH_TRIGGER which drains all
-    // dirty tiles to SDRAM via the RTL flush FSM before extraction.  No
-    // C++-side flush hack is required for color (in contrast with the
-    // Z-cache flush below, which is needed only when --zbuf is requested).
+    // dirty tiles to SDRAM via the RTL flush FSM before extraction.  With
+    // --backdoor-flush, both tile caches are instead copied into the SDRAM
+    // model directly, so long perf scripts can omit the flush phase (and
+    // its cycles) and still read back a complete frame.
+    if (opt.backdoor_flush) {
+        for (const TileCacheView& cache : tile_cache_views(top)) {
+            int flushed = backdoor_flush_tile_cache(cache, sdram);
+            out << std::format(
+                "DIAG: {} cache backdoor flush: {} dirty lines written to SDRAM\n",
+                cache.name, flushed);
+        }
+    }
     // Framebuffer A base word address (INT-011): 0x000000 / 2 = 0
     // Dimensions come from the ## FRAMEBUFFER: directive in the hex script.
     uint32_t fb_base_word = 0;
-    int fb_height = script.fb_height;
-    int fb_width = script.fb_width;
+    int fb_height = run.script.fb_height;
+    int fb_width = run.script.fb_width;
     // Width must match FB_CONFIG.WIDTH_LOG2 programmed into the pipeline,
     // since the tiled addressing formula depends on it. Derive log2 from
     // script.fb_width (must be a power of two).
@@ -956,91 +2105,62 @@ int main(int argc, char** argv) {
     }
     auto fb = extract_framebuffer(sdram, fb_base_word, fb_width_log2, fb_height);
 
-    try {
-        png_writer::write_png(output_file.c_str(), fb_width, fb_height, fb);
-    } catch (const std::runtime_error& e) {
-        std::cerr << std::format("ERROR: {}: {}\n", e.what(), output_file);
-        top->final();
-        if (trace) {
-            trace->close();
+    // Golden comparison (--golden) works on decoded pixels, so it does not
+    // depend on PNG encoder output.  With --compare-only a matching image
+    // is never PNG-encoded; a failing one is written with a diff image.
+    bool golden_passed = false;
+    if (!opt.golden_file.empty()) {
+        png_reader::RgbImage golden;
+        try {
+            golden = png_reader::read_png(opt.golden_file);
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}\n", e.what());
+            return false;
+        }
+        result.golden = compare_to_golden(golden, fb_width, fb_height, fb, opt.tolerance);
+        golden_passed = result.golden->passed();
+        out << std::format("Golden {}: {}\n", opt.golden_file, format_golden_diff(*result.golden));
+
+        if (!golden_passed && !result.golden->size_mismatch()) {
+            std::filesystem::path diff_path = output_file.empty()
+                ? std::filesystem::path(opt.golden_file).filename()
+                : std::filesystem::path(output_file);
+            diff_path.replace_filename(diff_path.stem().string() + "_diff.png");
+            try {
+                png_writer::write_png(diff_path.string().c_str(), fb_width, fb_height,
+                                      golden_diff_image(golden, fb, opt.tolerance));
+            } catch (const std::runtime_error& e) {
+                err << std::format("ERROR: {}: {}\n", e.what(), diff_path.string());
+                return false;
+            }
+            out << std::format("Diff image written to: {}\n", diff_path.string());
         }
-        return 1;
     }
 
-    std::cout << std::format("Golden image written to: {}\n", output_file);
-
-    // -----------------------------------------------------------------------
-    // 7c. Z-buffer PNG output (optional)
-    // -----------------------------------------------------------------------
-    if (!zbuf_file.empty()) {
-        // Flush the Z-buffer tile cache by directly copying dirty cache lines
-        // into the SDRAM model.  The cache is write-back, so without this step
-        // SDRAM still contains stale zeros for tiles resident in the cache.
-        //
-        // We bypass the RTL flush FSM entirely (it would compete with the
-        // display controller for SDRAM arbiter grants) and instead read the
-        // Verilator-exposed cache BRAM, valid/dirty FF arrays, and tag EBR
-        // memories to perform the writeback in C++.
-        {
-            auto* g = top->rootp->gpu_top;
-
-            // Alias the per-way valid/dirty arrays [0..127] and tag mems [0..127]
-            const auto& valid_w0 = g->__PVT__u_zbuf_tile_cache__DOT__valid_w0;
-            const auto& valid_w1 = g->__PVT__u_zbuf_tile_cache__DOT__valid_w1;
-            const auto& valid_w2 = g->__PVT__u_zbuf_tile_cache__DOT__valid_w2;
-            const auto& valid_w3 = g->__PVT__u_zbuf_tile_cache__DOT__valid_w3;
-            const auto& dirty_w0 = g->__PVT__u_zbuf_tile_cache__DOT__dirty_w0;
-            const auto& dirty_w1 = g->__PVT__u_zbuf_tile_cache__DOT__dirty_w1;
-            const auto& dirty_w2 = g->__PVT__u_zbuf_tile_cache__DOT__dirty_w2;
-            const auto& dirty_w3 = g->__PVT__u_zbuf_tile_cache__DOT__dirty_w3;
-            const auto& tag0_mem = g->__PVT__u_zbuf_tile_cache__DOT__u_tag0__DOT__mem;
-            const auto& tag1_mem = g->__PVT__u_zbuf_tile_cache__DOT__u_tag1__DOT__mem;
-            const auto& tag2_mem = g->__PVT__u_zbuf_tile_cache__DOT__u_tag2__DOT__mem;
-            const auto& tag3_mem = g->__PVT__u_zbuf_tile_cache__DOT__u_tag3__DOT__mem;
-            const auto& cache_mem = g->__PVT__u_zbuf_tile_cache__DOT__cache_mem;
-
-            // Read fb_z_base from the register file
-            uint64_t fb_config = static_cast<uint64_t>(g->u_register_file->fb_config_reg);
-            uint32_t z_base_field = static_cast<uint32_t>((fb_config >> 16) & 0xFFFF);
-            // SDRAM byte address = {z_base[14:0], 9'b0}
-            uint32_t z_base_byte = (z_base_field & 0x7FFF) << 9;
-
-            constexpr int NUM_SETS = 128;
-            constexpr int NUM_WAYS = 4;
-            constexpr int PIXELS_PER_TILE = 16;
-            int flushed = 0;
-
-            for (int set = 0; set < NUM_SETS; set++) {
-                for (int way = 0; way < NUM_WAYS; way++) {
-                    bool valid = false, dirty = false;
-                    uint8_t tag = 0;
-                    switch (way) {
-                        case 0: valid = valid_w0[set]; dirty = dirty_w0[set]; tag = tag0_mem[set]; break;
-                        case 1: valid = valid_w1[set]; dirty = dirty_w1[set]; tag = tag1_mem[set]; break;
-                        case 2: valid = valid_w2[set]; dirty = dirty_w2[set]; tag = tag2_mem[set]; break;
-                        case 3: valid = valid_w3[set]; dirty = dirty_w3[set]; tag = tag3_mem[set]; break;
-                    }
-                    if (!valid) continue;
-
-                    // Reconstruct 14-bit tile_idx = {tag[6:0], set[6:0]}
-                    uint32_t tile_idx = (static_cast<uint32_t>(tag & 0x7F) << 7) | (set & 0x7F);
-
-                    // BRAM address: {way[1:0], set[6:0], pixel_off[3:0]}
-                    int bram_base = (way << 11) | (set << 4);
-
-                    // SDRAM byte address for this tile: base + tile_idx * 32
-                    uint32_t tile_base_byte = z_base_byte + (tile_idx << 5);
-
-                    for (int px = 0; px < PIXELS_PER_TILE; px++) {
-                        uint16_t z_val = cache_mem[bram_base + px];
-                        uint32_t byte_addr = tile_base_byte + (px << 1);
-                        sdram.write_word(byte_addr, z_val);
-                    }
-                    flushed++;
-                }
-            }
-            std::cout << std::format("DIAG: Z-cache flush: {} valid lines written to SDRAM\n", flushed);
+    if (!output_file.empty() && !(opt.compare_only && golden_passed)) {
+        try {
+            frame_writer::write_frame(output_file, fb_width, fb_height, fb);
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}: {}\n", e.what(), output_file);
+            return false;
+        }
+        out << std::format("Golden image written to: {}\n", output_file);
+    }
 
+    result.fb_width = fb_width;
+    result.fb_height = fb_height;
+    result.framebuffer = std::move(fb);
+
+    // Z-buffer PNG output (optional)
+    if (!opt.zbuf_file.empty()) {
+        // The Z tile cache (UNIT-012) is write-back and the scripts never
+        // flush it, so copy its dirty lines into the SDRAM model first
+        // (unless --backdoor-flush already did).  Running the RTL flush FSM
+        // instead would compete with the display controller for SDRAM
+        // arbiter grants.
+        if (!opt.backdoor_flush) {
+            int flushed = backdoor_flush_tile_cache(tile_cache_views(top)[Z_TILE_CACHE], sdram);
+            out << std::format("DIAG: Z-cache flush: {} dirty lines written to SDRAM\n", flushed);
         }
 
         // Read the Z-buffer base address from fb_config_reg[31:16].
@@ -1050,43 +2170,568 @@ int main(int argc, char** argv) {
             top->rootp->gpu_top->u_register_file->fb_config_reg);
         uint32_t z_base_word = static_cast<uint32_t>(((fb_config >> 16) & 0xFFFF) << 9);
         auto zbuf = extract_framebuffer(sdram, z_base_word, FB_WIDTH_LOG2, fb_height);
+        std::vector<uint8_t> zbuf_gray = zbuf_to_gray(zbuf);
 
-        // Convert 16-bit Z values to auto-ranged grayscale for PNG.
-        // Matches the DT's approach: find min/max non-zero z, then linearly
-        // map [z_min, z_max] to [1, 255] grayscale.  z=0 (cleared) maps to black.
-        uint16_t z_min = 0xFFFF, z_max = 0;
-        for (uint16_t z : zbuf) {
-            if (z == 0) continue;
-            if (z < z_min) z_min = z;
-            if (z > z_max) z_max = z;
+        try {
+            png_writer::write_png_gray(opt.zbuf_file.c_str(), fb_width, fb_height, zbuf_gray);
+        } catch (const std::runtime_error& e) {
+            err << std::format("ERROR: {}: {}\n", e.what(), opt.zbuf_file);
         }
-        uint32_t range = (z_max > z_min) ? static_cast<uint32_t>(z_max - z_min) : 1;
+        out << std::format("Z-buffer image written to: {}\n", opt.zbuf_file);
+    }
 
-        std::vector<uint8_t> zbuf_gray(zbuf.size());
-        for (size_t px = 0; px < zbuf.size(); px++) {
-            uint16_t z = zbuf[px];
-            zbuf_gray[px] = (z == 0) ? 0
-                : static_cast<uint8_t>(static_cast<uint32_t>(z - z_min) * 255 / range);
-        }
+    if (const SdramImage* image = sdram.image(); image && image->mode() == SdramImageMode::SHARED) {
+        image->sync();
+        out << std::format("SDRAM image written to: {}\n", image->path());
+    }
+    return true;
+}
 
-        try {
-            png_writer::write_png_gray(zbuf_file.c_str(), fb_width, fb_height, zbuf_gray);
-        } catch (const std::runtime_error& e) {
-            std::cerr << std::format("ERROR: {}: {}\n", e.what(), zbuf_file);
+/// Run one scene end to end on a private VerilatedContext, Vgpu_top and
+/// SdramModel, so several runs can proceed concurrently on different
+/// threads.  Progress and diagnostics go to `out`, errors to `err`.
+///
+/// Each stage reports its own errors; SceneRun's destructor finalizes
+/// the model and closes the trace on every return path.
+static RunResult run_test(const HarnessOptions& opt, std::ostream& out, std::ostream& err) {
+    RunResult result;
+    SceneRun run(opt, out, err);
+
+    if (!open_sdram(run) || !load_script(run) || !start_model(run)) {
+        return result;
+    }
+    if (run.done) {
+        result.exit_code = 0;
+        return result;
+    }
+    if (!(run.stream_reader ? run_streamed(run) : run_phases(run))) {
+        return result;
+    }
+    drain_with_diagnostics(run);
+    if (!report_run(run, result) || !read_back(run, result)) {
+        return result;
+    }
+
+    result.exit_code = 0;
+    return result;
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// In-process regression runner
+// ---------------------------------------------------------------------------
+//
+// `--all` / `--tests a,b,c` run several scenes concurrently, each on its
+// own VerilatedContext + Vgpu_top + SdramModel (see run_test()), and
+// compare the rendered pixels against the decoded integration/golden/
+// PNGs (golden_compare.hpp), exactly unless --tolerance is given.
+
+#ifdef VERILATOR
+/// Split a comma-separated list, dropping empty entries.
+static std::vector<std::string> split_list(std::string_view list) {
+    std::vector<std::string> items;
+    while (!list.empty()) {
+        size_t comma = list.find(',');
+        std::string_view item = list.substr(0, comma);
+        if (!item.empty()) {
+            items.emplace_back(item);
         }
-        std::cout << std::format("Z-buffer image written to: {}\n", zbuf_file);
+        list = (comma == std::string_view::npos) ? std::string_view{} : list.substr(comma + 1);
     }
+    return items;
+}
 
-    // -----------------------------------------------------------------------
-    // 8. Cleanup
-    // -----------------------------------------------------------------------
-    top->final();
-    if (trace) {
-        trace->close();
+/// Per-scene outcome of a regression run.
+struct RegressionEntry {
+    std::string name;
+    std::string status = "ERROR"; ///< PASS, FAIL, SKIP (no golden), ERROR (run failed)
+    std::string detail;           ///< Golden comparison summary
+    uint64_t cycles = 0;
+    double wall_seconds = 0.0;
+    SceneMetrics metrics; ///< Performance figures (--metrics / --baseline)
+    std::string log; ///< Captured stdout/stderr of the run
+};
+
+/// Performance metrics output and baseline gating
+/// (--metrics / --baseline / --max-regression).
+struct PerfGateOptions {
+    std::string metrics_file;        ///< Write scene,metric,value rows here
+    std::string baseline_file;       ///< Compare total cycles against this file
+    double max_regression_pct = 5.0; ///< Fail when cycles grow by more than this
+    bool require_baseline = false;   ///< Fail scenes with no baseline row (--require-baseline)
+
+    bool enabled() const {
+        return !metrics_file.empty() || !baseline_file.empty();
     }
-    // Smart pointers handle deallocation automatically.
+};
 
+/// Write and/or gate `metrics` as `gate` asks.  Returns 1 when a file
+/// cannot be read or written, a scene regressed, or (--require-baseline) a
+/// scene has no baseline row, else 0.
+static int apply_perf_gate(std::span<const SceneMetrics> metrics, const PerfGateOptions& gate) {
+    try {
+        if (!gate.metrics_file.empty()) {
+            write_metrics_csv(gate.metrics_file, metrics);
+            std::cout << std::format("Performance metrics written to: {}\n", gate.metrics_file);
+        }
+        if (!gate.baseline_file.empty()) {
+            BaselineCheck check = compare_to_baseline(
+                metrics, read_metrics_csv(gate.baseline_file), gate.max_regression_pct,
+                gate.require_baseline);
+            std::cout << check.report;
+            if (check.missing > 0) {
+                std::cerr << std::format(
+                    "ERROR: {} scene(s) have no cycle count in {}; record one with "
+                    "`make perf-baseline` on a Verilator host\n",
+                    check.missing, gate.baseline_file);
+            }
+            if (check.regressions > 0) {
+                std::cerr << std::format(
+                    "ERROR: {} scene(s) slower than {} by more than {:.1f}%\n",
+                    check.regressions, gate.baseline_file, gate.max_regression_pct);
+            }
+            if (check.missing > 0 || check.regressions > 0) {
+                return 1;
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << std::format("ERROR: {}\n", e.what());
+        return 1;
+    }
     return 0;
+}
+
+/// Run one regression scene and compare it against its golden PNG.
+static void run_regression_entry(
+    RegressionEntry& entry,
+    const HarnessOptions& base,
+    const std::filesystem::path& golden_dir,
+    const std::filesystem::path& out_dir
+) {
+    const SceneInfo* scene = find_scene(entry.name);
+    std::ostringstream log;
+
+    HarnessOptions opt = base;
+    opt.test_name = entry.name;
+    opt.output_file = out_dir.empty() ? std::string{} : (out_dir / scene->golden_png).string();
+    auto golden_path = golden_dir / scene->golden_png;
+    opt.golden_file = std::filesystem::exists(golden_path) ? golden_path.string() : std::string{};
+    opt.zbuf_file.clear();
+    opt.tri_trace_file.clear();
+    opt.sdram_stats_file.clear();
+    opt.save_file.clear();
+    opt.save_phase.clear();
+    opt.trace = false;
+
+    auto start = std::chrono::steady_clock::now();
+    RunResult run = run_test(opt, log, log);
+    entry.wall_seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    entry.cycles = run.cycles;
+    entry.metrics = std::move(run.metrics);
+    entry.metrics.cycles_per_second =
+        entry.wall_seconds > 0.0 ? static_cast<double>(run.cycles) / entry.wall_seconds : 0.0;
+
+    if (run.exit_code == 0) {
+        if (!run.golden) {
+            entry.status = "SKIP";
+        } else {
+            entry.status = run.golden->passed() ? "PASS" : "FAIL";
+            entry.detail = format_golden_diff(*run.golden);
+        }
+    }
+    entry.log = std::move(log).str();
+}
+
+/// Run `tests` on a pool of `jobs` worker threads (0 = one per core),
+/// print a summary table, and return the process exit code (0 when no
+/// scene failed or errored).
+static int run_regression(
+    std::span<const std::string> tests,
+    const HarnessOptions& base,
+    unsigned jobs,
+    const std::string& golden_dir,
+    const std::string& out_dir,
+    const PerfGateOptions& gate
+) {
+    for (const auto& name : tests) {
+        if (!find_scene(name)) {
+            std::cerr << std::format("Unknown test: {}\n", name);
+            return 1;
+        }
+    }
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+    jobs = std::min(jobs, static_cast<unsigned>(tests.size()));
+
+    std::vector<RegressionEntry> entries(tests.size());
+    for (size_t i = 0; i < tests.size(); i++) {
+        entries[i].name = tests[i];
+    }
+
+    std::cout << std::format("Running {} scene(s) on {} thread(s)...\n", tests.size(), jobs);
+    auto start = std::chrono::steady_clock::now();
+
+    // Workers pull the next unclaimed scene until the list is exhausted.
+    std::atomic<size_t> next{0};
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(jobs);
+        for (unsigned w = 0; w < jobs; w++) {
+            workers.emplace_back([&] {
+                for (size_t i = next++; i < entries.size(); i = next++) {
+                    run_regression_entry(entries[i], base, golden_dir, out_dir);
+                }
+            });
+        }
+    }
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Full logs only for scenes that did not run cleanly; pixel
+    // statistics for scenes that ran but differ from their golden.
+    for (const auto& e : entries) {
+        if (e.status == "ERROR") {
+            std::cout << std::format("---- {} log ----\n{}", e.name, e.log);
+        } else if (e.status == "FAIL") {
+            std::cout << std::format("{}: {}\n", e.name, e.detail);
+        }
+    }
+
+    // Simulation rate per scene (simulated cycles per wall-second) is the
+    // figure of merit for comparing --threads build variants.
+    size_t passed = 0;
+    size_t failed = 0;
+    uint64_t total_cycles = 0;
+    double total_scene_wall = 0.0;
+    std::cout << std::format(
+        "\n  {:<20} {:>6} {:>12} {:>9} {:>9}\n", "scene", "result", "cycles", "wall (s)", "kcyc/s");
+    for (const auto& e : entries) {
+        std::cout << std::format(
+            "  {:<20} {:>6} {:>12} {:>9.2f} {:>9.1f}\n", e.name, e.status, e.cycles,
+            e.wall_seconds, e.wall_seconds > 0.0 ? e.cycles / e.wall_seconds / 1e3 : 0.0);
+        passed += (e.status == "PASS");
+        failed += (e.status == "FAIL" || e.status == "ERROR");
+        total_cycles += e.cycles;
+        total_scene_wall += e.wall_seconds;
+    }
+    std::cout << std::format(
+        "{} passed, {} failed, {} skipped in {:.2f} s wall ({:.1f} kcyc/s per scene)\n",
+        passed, failed, entries.size() - passed - failed, wall,
+        total_scene_wall > 0.0 ? total_cycles / total_scene_wall / 1e3 : 0.0
+    );
+
+    // Metrics of scenes that did not run to completion would read as
+    // huge improvements or regressions; gate only the ones that did.
+    int perf_status = 0;
+    if (gate.enabled()) {
+        std::vector<SceneMetrics> metrics;
+        for (const auto& e : entries) {
+            if (e.status != "ERROR") {
+                metrics.push_back(e.metrics);
+            }
+        }
+        perf_status = apply_perf_gate(metrics, gate);
+    }
+    return failed == 0 ? perf_status : 1;
+}
+#endif
+
+#ifndef VERILATOR
+// ---------------------------------------------------------------------------
+// Scaffold helpers
+//
+// The harness modules have their own host-side tests (test_*.cpp, `make
+// test-harness-units`); the scaffold main only smoke-tests the build.
+// ---------------------------------------------------------------------------
+
+/// Path for a scaffold artifact under the system temp directory.
+static std::string scaffold_temp_path(std::string_view name) {
+    return (std::filesystem::temp_directory_path() / std::format("harness_scaffold_{}", name))
+        .string();
+}
+
+#endif
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+int main(int argc, char** argv) {
+#ifdef VERILATOR
+    // Usage:
+    //   ./harness <test_name> [output.png|.qoi|.rgb565]
+    //   ./harness --all | --tests a,b,c [--jobs N] [--golden-dir dir]
+    //             [--out-dir dir]
+    //
+    // Where <test_name> is one of the SCENES names.  If no output file is
+    // provided, the default is <test_name>.png in the current working
+    // directory.  PNGs are written by the striped parallel encoder; .qoi
+    // and raw .rgb565 outputs skip deflate entirely (see frame_writer.hpp).
+    //
+    // Additional flags:
+    //   --test <name>             — alternative way to specify test name
+    //   --trace                   — enable FST waveform trace output
+    //   --backdoor-flush          — copy dirty color and Z tile-cache lines
+    //                               into the SDRAM model before readback
+    //                               (no FB_CACHE_CTRL flush phase needed)
+    //   --fast-upload             — apply MEM_ADDR / MEM_DATA / MEM_FILL
+    //                               writes straight to the SDRAM model
+    //                               instead of through RTL, draining the
+    //                               pipeline before each run of them
+    //   --restore <file>          — resume from a checkpoint instead of
+    //                               running reset + SDRAM init
+    //   --save-checkpoint <file>  — save a checkpoint after SDRAM init
+    //                               (exits if no test name is given)
+    //   --checkpoint-phase <name> — with --save-checkpoint, save just
+    //                               before phase <name> instead
+    //   --script <file>           — run this script instead of the scene's
+    //                               own (.hex, or .pgcmd from hex_compile)
+    //   --stream                  — execute a .hex script while reading it
+    //                               (constant memory for huge captures)
+    //   --back-to-back            — hold sim_reg_valid across consecutive
+    //                               writes (one per cycle) instead of one
+    //                               write every other cycle
+    //   --frames <n>              — render n frames, each drained, presented
+    //                               (FB_DISPLAY, same buffer) and synced to
+    //                               vsync, then report per-frame cycles vs.
+    //                               60 Hz with frame 0 as warm-up
+    //   --frame-phase <name>      — first phase replayed per frame (earlier
+    //                               phases run once as setup; default
+    //                               "main" if present, else the first)
+    //   --synth <kind>            — run a generated stress scene instead of
+    //                               a script (synth_scene.hpp: tiny_tris,
+    //                               overdraw_blend, texture_thrash,
+    //                               hiz_sorted, hiz_reverse, strips) and
+    //                               report draw-phase throughput
+    //   --seed <n>                — --synth PRNG seed (default 1)
+    //   --synth-count <n>         — --synth primitive count (0 = default)
+    //   --spi-ratio <n>           — harness_spi only: core cycles per SPI
+    //                               SCK period (default 4 = 25 MHz link)
+    //   --cmd-interval <n>        — harness_fifo only: min cycles between
+    //                               host writes into the command FIFO
+    //   --fifo-hist <file.csv>    — harness_fifo only: write the command
+    //                               FIFO occupancy histogram
+    //   --profile                 — per-phase FSM state histograms, stall
+    //                               reasons and cycles per fragment
+    //   --tri-trace <file>        — per-triangle setup/iteration/retire
+    //                               timing as CSV (or JSON for *.json)
+    //   --sdram-stats <file>      — SDRAM row-locality / per-port report
+    //                               and bandwidth timeline CSV
+    //   --sdram-window <cycles>   — timeline window (default 10000)
+    //   --sdram-image <file>      — back the SDRAM model with a mapped
+    //                               image file (pre-staged contents)
+    //   --sdram-image-mode <m>    — cow (default: file is read-only) or
+    //                               shared (final SDRAM state is left in
+    //                               the file)
+    //   --golden <file>           — compare pixels with a golden PNG; on
+    //                               mismatch also write <output>_diff.png
+    //   --tolerance <N>           — allowed per-channel error (default 0)
+    //   --compare-only            — skip writing the PNG when the golden
+    //                               matches
+    //   --all / --tests a,b,c     — run scenes concurrently and compare
+    //                               each against its golden PNG
+    //   --jobs <N>                — worker threads (default: all cores)
+    //   --golden-dir <dir>        — golden PNG directory (default: golden)
+    //   --out-dir <dir>           — also write each rendered PNG there
+    //                               (with --compare-only: failing ones)
+    //   --metrics <file.csv>      — write per-scene cycles, phase cycles,
+    //                               SDRAM commands, Hi-Z rejects, fragments
+    //                               and sim rate (perf_baseline.hpp)
+    //   --baseline <file.csv>     — fail if a scene's cycles exceed its
+    //                               baseline entry by more than
+    //                               --max-regression <pct> (default 5)
+    //   --require-baseline        — also fail scenes with no (or a
+    //                               zero-cycle) baseline entry
+
+    HarnessOptions opt;
+    opt.argc = argc;
+    opt.argv = argv;
+    std::vector<std::string> regression_tests;
+    unsigned jobs = 0;
+    std::string golden_dir = "golden";
+    std::string out_dir;
+    PerfGateOptions perf_gate;
+    SynthParams synth;
+    bool use_synth = false;
+
+    // Simple argument parsing: look for --test flag or positional args.
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg(argv[i]);
+        if (arg == "--test" && i + 1 < argc) {
+            opt.test_name = argv[++i];
+        } else if (arg == "--zbuf" && i + 1 < argc) {
+            opt.zbuf_file = argv[++i];
+        } else if (arg == "--backdoor-flush") {
+            opt.backdoor_flush = true;
+        } else if (arg == "--fast-upload") {
+            opt.fast_upload = true;
+        } else if (arg == "--restore" && i + 1 < argc) {
+            opt.restore_file = argv[++i];
+        } else if (arg == "--save-checkpoint" && i + 1 < argc) {
+            opt.save_file = argv[++i];
+        } else if (arg == "--checkpoint-phase" && i + 1 < argc) {
+            opt.save_phase = argv[++i];
+        } else if (arg == "--script" && i + 1 < argc) {
+            opt.script_file = argv[++i];
+        } else if (arg == "--stream") {
+            opt.stream = true;
+        } else if (arg == "--back-to-back") {
+            opt.back_to_back = true;
+        } else if (arg == "--synth" && i + 1 < argc) {
+            try {
+                synth.kind = parse_synth_kind(argv[++i]);
+                use_synth = true;
+            } catch (const std::invalid_argument& e) {
+                std::cerr << std::format("ERROR: {}\n", e.what());
+                return 1;
+            }
+        } else if (arg == "--seed" && i + 1 < argc) {
+            synth.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--synth-count" && i + 1 < argc) {
+            synth.count = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--frames" && i + 1 < argc) {
+            opt.frames = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--frame-phase" && i + 1 < argc) {
+            opt.frame_phase = argv[++i];
+        } else if (arg == "--spi-ratio" && i + 1 < argc) {
+            opt.spi_sck_ratio = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--cmd-interval" && i + 1 < argc) {
+            opt.cmd_interval = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--fifo-hist" && i + 1 < argc) {
+            opt.fifo_hist_file = argv[++i];
+        } else if (arg == "--profile") {
+            opt.profile = true;
+        } else if (arg == "--tri-trace" && i + 1 < argc) {
+            opt.tri_trace_file = argv[++i];
+        } else if (arg == "--sdram-stats" && i + 1 < argc) {
+            opt.sdram_stats_file = argv[++i];
+        } else if (arg == "--sdram-window" && i + 1 < argc) {
+            opt.sdram_window = std::stoull(argv[++i]);
+        } else if (arg == "--sdram-image" && i + 1 < argc) {
+            opt.sdram_image = argv[++i];
+        } else if (arg == "--sdram-image-mode" && i + 1 < argc) {
+            try {
+                opt.sdram_image_mode = parse_sdram_image_mode(argv[++i]);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << std::format("ERROR: {}\n", e.what());
+                return 1;
+            }
+        } else if (arg == "--golden" && i + 1 < argc) {
+            opt.golden_file = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            opt.tolerance = std::stoi(argv[++i]);
+        } else if (arg == "--compare-only") {
+            opt.compare_only = true;
+        } else if (arg == "--all") {
+            regression_tests.clear();
+            for (const auto& scene : SCENES) {
+                regression_tests.emplace_back(scene.name);
+            }
+        } else if (arg == "--tests" && i + 1 < argc) {
+            regression_tests = split_list(argv[++i]);
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--golden-dir" && i + 1 < argc) {
+            golden_dir = argv[++i];
+        } else if (arg == "--out-dir" && i + 1 < argc) {
+            out_dir = argv[++i];
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            perf_gate.metrics_file = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            perf_gate.baseline_file = argv[++i];
+        } else if (arg == "--max-regression" && i + 1 < argc) {
+            perf_gate.max_regression_pct = std::stod(argv[++i]);
+        } else if (arg == "--require-baseline") {
+            perf_gate.require_baseline = true;
+        } else if (arg == "--trace") {
+            opt.trace = true;
+        } else if (arg.find(".png") != std::string_view::npos || arg.ends_with(".qoi")
+                   || arg.ends_with(".rgb565")) {
+            opt.output_file = arg;
+        } else {
+            // Treat bare argument as test name if not an image file
+            opt.test_name = arg;
+        }
+    }
+
+    opt.metrics = perf_gate.enabled();
+    if (use_synth) {
+        if (!opt.script_file.empty()) {
+            std::cerr << "ERROR: --synth cannot be combined with --script\n";
+            return 1;
+        }
+        opt.synth = synth;
+        if (opt.test_name.empty()) {
+            opt.test_name = std::format("synth_{}", synth_kind_name(synth.kind));
+        }
+    }
+
+    if (!regression_tests.empty()) {
+        if (!opt.script_file.empty() || opt.synth) {
+            std::cerr << "ERROR: --script and --synth cannot be used with --all/--tests\n";
+            return 1;
+        }
+        // Concurrent scenes cannot all write the same shared image.
+        if (!opt.sdram_image.empty() && opt.sdram_image_mode == SdramImageMode::SHARED) {
+            std::cerr << "ERROR: --sdram-image-mode shared cannot be used with --all/--tests\n";
+            return 1;
+        }
+        return run_regression(regression_tests, opt, jobs, golden_dir, out_dir, perf_gate);
+    }
+
+    // A --script run without a scene name is named after the script file.
+    if (opt.test_name.empty() && !opt.script_file.empty()) {
+        opt.test_name = std::filesystem::path(opt.script_file).stem().string();
+    }
+
+    // Test name is required, except when only saving a post-init checkpoint.
+    bool init_only = opt.test_name.empty() && !opt.save_file.empty() && opt.save_phase.empty();
+    if (opt.test_name.empty() && !init_only) {
+        std::cerr << std::format(
+            "Usage: {} <test_name> [output.png|.qoi|.rgb565] [--zbuf zbuf.png] [--trace]\n"
+            "          [--backdoor-flush] [--fast-upload]\n"
+            "          [--restore ckpt] [--save-checkpoint ckpt [--checkpoint-phase name]]\n"
+            "          [--sdram-image file [--sdram-image-mode cow|shared]]\n"
+            "          [--script file.hex|file.pgcmd] [--stream] [--back-to-back] [--spi-ratio n] [--profile]\n"
+            "          [--cmd-interval n] [--fifo-hist file.csv]\n"
+            "          [--frames n [--frame-phase name]]\n"
+            "          [--synth kind [--seed n] [--synth-count n]]\n"
+            "          [--tri-trace file.csv|file.json]\n"
+            "          [--sdram-stats timeline.csv [--sdram-window cycles]]\n"
+            "          [--golden golden.png [--tolerance N] [--compare-only]]\n"
+            "       {} --save-checkpoint ckpt\n"
+            "       {} --all | --tests a,b,c [--jobs N] [--golden-dir dir] [--out-dir dir]\n"
+            "          [--tolerance N] [--compare-only]\n"
+            "  either form: [--metrics file.csv]\n"
+            "               [--baseline file.csv [--max-regression pct] [--require-baseline]]\n"
+            "  test_name: gouraud, depth_test, textured, color_combined, textured_cube,\n"
+            "             size_grid, perspective_road, indexed_pixel_art,\n"
+            "             stipple_test, alpha_blend\n",
+            argv[0], argv[0], argv[0]
+        );
+        return 1;
+    }
+
+    // Default output path: <test_name>.png in the current working directory.
+    // The Makefile runs the harness from build/sim_out/, so the default
+    // output lands there alongside any waveform traces.
+    if (!init_only && opt.output_file.empty()) {
+        opt.output_file = std::format("{}.png", opt.test_name);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    RunResult run = run_test(opt, std::cout, std::cerr);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (run.exit_code == 0 && run.golden && !run.golden->passed()) {
+        return 1;
+    }
+    if (run.exit_code == 0 && perf_gate.enabled()) {
+        run.metrics.cycles_per_second = wall > 0.0 ? static_cast<double>(run.cycles) / wall : 0.0;
+        return apply_perf_gate(std::span<const SceneMetrics>(&run.metrics, 1), perf_gate);
+    }
+    return run.exit_code;
 
 #else
     // Non-Verilator build: just verify that the harness scaffolding compiles.
@@ -1101,15 +2746,29 @@ int main(int argc, char** argv) {
     sdram.write_word(0, 0xF800); // Red pixel (RGB565)
     sdram.write_word(1, 0x07E0); // Green pixel
     sdram.write_word(2, 0x001F); // Blue pixel
+    if (sdram.touched_pages() != 1 || sdram.page_touched(SdramModel::PAGE_WORDS)) {
+        std::cerr << "ERROR: SDRAM dirty-page tracking smoke test failed\n";
+        return 1;
+    }
+
+    // The smoke PNG goes to the temp directory and is removed on exit.
+    std::string png_path = scaffold_temp_path("smoke.png");
+    struct Cleanup {
+        std::string path;
+        ~Cleanup() {
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+    } cleanup{png_path};
 
     std::array<uint16_t, 4> test_fb = {0xF800, 0x07E0, 0x001F, 0xFFFF};
     try {
-        png_writer::write_png("test_scaffold.png", 2, 2, test_fb);
+        png_writer::write_png(png_path.c_str(), 2, 2, test_fb);
     } catch (const std::runtime_error& e) {
         std::cerr << std::format("ERROR: PNG writer smoke test failed: {}\n", e.what());
         return 1;
     }
-    std::cout << "PNG writer smoke test passed (test_scaffold.png).\n";
+    std::cout << std::format("PNG writer smoke test passed ({}).\n", png_path);
 
     return 0;
 #endif
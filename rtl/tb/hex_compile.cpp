@@ -0,0 +1,55 @@
+// Compile a GPU test script (.hex) into a binary command stream (.pgcmd).
+//
+// Usage: hex_compile <script.hex> <script.pgcmd>
+//
+// The output is read by `harness --script <file.pgcmd>` via mmap with no
+// parsing; see cmd_stream.hpp for the format.  ## INCLUDE: directives are
+// resolved at compile time, and ## TEXTURE: directives and ## TIMESTAMP:
+// labels are dropped with a warning (the marker writes themselves are kept).
+
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "cmd_stream.hpp"
+#include "hex_parser.hpp"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << std::format("Usage: {} <script.hex> <script.pgcmd>\n", argv[0]);
+        return 1;
+    }
+
+    try {
+        HexScript script = parse_hex_file(argv[1]);
+        if (!script.textures.empty()) {
+            std::cerr << std::format(
+                "WARNING: {}: {} '## TEXTURE:' directive(s) not carried into the command stream\n",
+                argv[1], script.textures.size()
+            );
+        }
+        if (!script.timestamps.empty()) {
+            std::cerr << std::format(
+                "WARNING: {}: {} '## TIMESTAMP:' label(s) not carried into the command stream\n",
+                argv[1], script.timestamps.size()
+            );
+        }
+
+        auto bytes = compile_cmd_stream(script);
+        std::ofstream out(argv[2], std::ios::binary);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out) {
+            throw std::runtime_error(std::format("cannot write {}", argv[2]));
+        }
+
+        std::cout << std::format(
+            "{} -> {}: {} phase(s), {} command(s), {} bytes\n", argv[1], argv[2],
+            script.phases.size(), script.all_commands().size(), bytes.size()
+        );
+    } catch (const std::exception& e) {
+        std::cerr << std::format("ERROR: {}\n", e.what());
+        return 1;
+    }
+    return 0;
+}
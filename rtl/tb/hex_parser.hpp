@@ -11,17 +11,30 @@
 //   - '## FRAMEBUFFER: <width> <height>' declares output dimensions
 //   - '## TEXTURE: <type> base=<hex> format=<fmt> width_log2=<n>'
 //   - '## INCLUDE: <relative-path>' includes another hex file
+//   - '## TIMESTAMP: <label> <hex-addr>' emits a PERF_TIMESTAMP (0x50)
+//     write of the 32-bit-word SDRAM address and records its label
+//
+// HexStreamReader is the pull-based core: it reads through a fixed-size
+// buffer and yields one command or directive at a time, so memory stays
+// constant for arbitrarily long captured traces and a consumer can start
+// simulating on the first command.  parse_hex_file() / parse_hex_string()
+// collect its events into a HexScript for callers that want the whole
+// script up front.
 
 #ifndef HEX_PARSER_HPP
 #define HEX_PARSER_HPP
 
 #include <algorithm>
+#include <charconv>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /// A single register write: 7-bit address + 64-bit data.
@@ -39,6 +52,22 @@ struct TextureDirective {
     uint8_t width_log2;     // log2 of texture width (e.g. 4 for 16px)
 };
 
+/// A PERF_TIMESTAMP marker parsed from a '## TIMESTAMP:' line.  The
+/// marker's register write is part of its phase's commands; this records
+/// where to read the value back and what to call it (perf_timestamps.hpp).
+struct TimestampDirective {
+    std::string label;      // e.g. "frame_start"
+    uint32_t word_addr = 0; // 32-bit-word SDRAM address (PERF_TIMESTAMP DATA[22:0])
+    std::string phase;      // Name of the phase the marker is in
+    size_t phase_index = 0; // Index of that phase in HexScript::phases
+};
+
+/// PERF_TIMESTAMP register index (INT-010).
+inline constexpr uint8_t REG_PERF_TIMESTAMP = 0x50;
+
+/// PERF_TIMESTAMP DATA bits holding the SDRAM word address.
+inline constexpr uint32_t PERF_TIMESTAMP_ADDR_MASK = 0x7F'FFFF;
+
 /// A named phase containing a sequence of register writes.
 struct HexPhase {
     std::string name;
@@ -51,6 +80,7 @@ struct HexScript {
     int fb_height = 0;
     std::vector<HexPhase> phases;
     std::vector<TextureDirective> textures;
+    std::vector<TimestampDirective> timestamps;
 
     /// Convenience: get all commands across all phases, flattened.
     [[nodiscard]] std::vector<HexRegWrite> all_commands() const {
@@ -76,11 +106,6 @@ inline std::string strip_underscores(const std::string& s) {
     return result;
 }
 
-/// Parse a hex string to uint64_t.
-inline uint64_t parse_hex64(const std::string& s) {
-    return std::stoull(strip_underscores(s), nullptr, 16);
-}
-
 /// Parse a hex string to uint32_t.
 inline uint32_t parse_hex32(const std::string& s) {
     return static_cast<uint32_t>(std::stoul(strip_underscores(s), nullptr, 16));
@@ -119,169 +144,354 @@ inline TextureDirective parse_texture_directive(const std::string& line) {
     return td;
 }
 
-} // namespace hex_parser_detail
+/// Trim spaces, tabs and CR/LF from both ends.
+inline std::string_view trim(std::string_view s) {
+    constexpr std::string_view WS = " \t\r\n";
+    auto first = s.find_first_not_of(WS);
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return s.substr(first, s.find_last_not_of(WS) - first + 1);
+}
 
-// Forward declaration for parse_hex_string_with_base
-inline HexScript parse_hex_string_with_base(
-    const std::string& content,
-    const std::string& base_dir);
+/// Split off the next whitespace-delimited token from `s`.
+inline std::string_view next_token(std::string_view& s) {
+    s = trim(s);
+    auto end = s.find_first_of(" \t");
+    std::string_view tok = s.substr(0, end);
+    s = (end == std::string_view::npos) ? std::string_view{} : s.substr(end);
+    return tok;
+}
 
-/// Parse a hex script from a string (no ## INCLUDE: support).
-inline HexScript parse_hex_string(const std::string& content) {
-    return parse_hex_string_with_base(content, "");
+/// Parse a hex token ('_' separators and an optional 0x prefix allowed)
+/// with std::from_chars, without allocating.
+inline uint64_t parse_hex_token(std::string_view tok, size_t line_no) {
+    if (tok.size() > 2 && tok[0] == '0' && (tok[1] == 'x' || tok[1] == 'X')) {
+        tok.remove_prefix(2);
+    }
+    char digits[32];
+    size_t n = 0;
+    for (char c : tok) {
+        if (c == '_') {
+            continue;
+        }
+        if (n == sizeof(digits)) {
+            n = 0; // too long: fall through to the error below
+            break;
+        }
+        digits[n++] = c;
+    }
+    uint64_t value = 0;
+    auto [ptr, ec] = std::from_chars(digits, digits + n, value, 16);
+    if (n == 0 || ec != std::errc{} || ptr != digits + n) {
+        throw std::runtime_error(
+            "hex script line " + std::to_string(line_no) + ": bad hex value '"
+            + std::string(tok) + "'");
+    }
+    return value;
 }
 
-/// Parse a hex script from a string, resolving ## INCLUDE: directives
-/// relative to base_dir.  If base_dir is empty, includes are silently
-/// ignored.
-inline HexScript parse_hex_string_with_base(
-    const std::string& content,
-    const std::string& base_dir)
-{
-    HexScript script;
-    HexPhase current_phase;
-    current_phase.name = "main"; // default phase name
-    bool has_explicit_phase = false;
+/// Parse a decimal int token; returns 0 if the token is not a number.
+inline int parse_int_token(std::string_view tok) {
+    int value = 0;
+    std::from_chars(tok.data(), tok.data() + tok.size(), value);
+    return value;
+}
 
-    std::istringstream stream(content);
-    std::string line;
+} // namespace hex_parser_detail
 
-    while (std::getline(stream, line)) {
-        // Strip trailing whitespace
-        while (!line.empty() && (line.back() == ' ' || line.back() == '\t' ||
-                                  line.back() == '\r' || line.back() == '\n')) {
-            line.pop_back();
-        }
+/// Kind of item yielded by HexStreamReader::next().
+enum class HexEventKind : uint8_t {
+    COMMAND,     ///< Register write (data line)
+    PHASE,       ///< '## PHASE: <name>'
+    FRAMEBUFFER, ///< '## FRAMEBUFFER: <width> <height>'
+    TEXTURE,     ///< '## TEXTURE: ...'
+    INCLUDE,     ///< '## INCLUDE: <path>' (before the included items)
+    TIMESTAMP,   ///< '## TIMESTAMP: <label> <addr>' (marker write + label)
+};
 
-        // Check for directives (## lines) before stripping comments
-        if (line.size() >= 2 && line[0] == '#' && line[1] == '#') {
-            if (line.find("## PHASE:") == 0) {
-                // Save current phase if it has commands
-                if (!current_phase.commands.empty() || has_explicit_phase) {
-                    script.phases.push_back(std::move(current_phase));
-                    current_phase = HexPhase{};
-                }
-                current_phase.name = line.substr(9);
-                // Trim leading whitespace from phase name
-                auto start = current_phase.name.find_first_not_of(" \t");
-                if (start != std::string::npos) {
-                    current_phase.name = current_phase.name.substr(start);
+/// One item from HexStreamReader.  `name` points into the reader's buffer
+/// and is only valid until the next call to next().
+struct HexEvent {
+    HexEventKind kind = HexEventKind::COMMAND;
+    HexRegWrite command{};      ///< COMMAND, or TIMESTAMP's marker write
+    std::string_view name;      ///< PHASE name, INCLUDE path or TIMESTAMP label
+    int fb_width = 0;           ///< FRAMEBUFFER
+    int fb_height = 0;          ///< FRAMEBUFFER
+    TextureDirective texture{}; ///< TEXTURE
+};
+
+/// Pull-based hex script reader over a fixed-size buffer.
+///
+/// ## INCLUDE: directives are followed relative to `base_dir` (a no-op when
+/// base_dir is empty, matching parse_hex_string()).  The included file's
+/// commands, FRAMEBUFFER, TEXTURE and TIMESTAMP items are yielded in place
+/// after the INCLUDE event; its own PHASE and INCLUDE directives are dropped, so its
+/// commands land in the including phase.
+class HexStreamReader {
+public:
+    /// Read buffer size; also the longest accepted line.
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    /// Stream a script file; includes resolve against its directory.
+    /// @throws std::runtime_error if the file cannot be opened.
+    explicit HexStreamReader(const std::string& filepath)
+        : HexStreamReader(open_file(filepath),
+                          std::filesystem::path(filepath).parent_path().string()) {}
+
+    /// Stream from `in`, resolving includes against `base_dir`.
+    HexStreamReader(std::unique_ptr<std::istream> in, std::string base_dir, bool nested = false)
+        : in_(std::move(in)), base_dir_(std::move(base_dir)), nested_(nested),
+          buf_(std::make_unique<char[]>(BUFFER_SIZE)) {}
+
+    /// Fetch the next item.
+    ///
+    /// @return false at end of input.
+    /// @throws std::runtime_error on a malformed value, an over-long line
+    ///         or a missing include file.
+    bool next(HexEvent& ev) {
+        using namespace hex_parser_detail;
+        for (;;) {
+            if (include_) {
+                if (include_->next(ev)) {
+                    return true;
                 }
-                has_explicit_phase = true;
-                continue;
+                include_.reset();
             }
-            if (line.find("## FRAMEBUFFER:") == 0) {
-                std::string dims = line.substr(15);
-                std::istringstream diss(dims);
-                diss >> script.fb_width >> script.fb_height;
-                continue;
+
+            std::string_view line;
+            if (!next_line(line)) {
+                return false;
             }
-            if (line.find("## TEXTURE:") == 0) {
-                script.textures.push_back(
-                    hex_parser_detail::parse_texture_directive(line));
-                continue;
+            // Strip trailing whitespace
+            while (!line.empty() && (line.back() == ' ' || line.back() == '\t'
+                                     || line.back() == '\r')) {
+                line.remove_suffix(1);
             }
-            if (line.find("## INCLUDE:") == 0) {
-                if (!base_dir.empty()) {
-                    std::string rel_path = line.substr(11);
-                    // Trim leading whitespace
-                    auto start = rel_path.find_first_not_of(" \t");
-                    if (start != std::string::npos) {
-                        rel_path = rel_path.substr(start);
+
+            // Directives (## lines) are recognized before stripping comments
+            if (line.starts_with("##")) {
+                if (line.starts_with("## PHASE:")) {
+                    if (nested_) {
+                        continue;
                     }
-                    auto full_path =
-                        std::filesystem::path(base_dir) / rel_path;
-                    std::ifstream inc_file(full_path);
-                    if (!inc_file.is_open()) {
+                    ev = HexEvent{};
+                    ev.kind = HexEventKind::PHASE;
+                    ev.name = trim(line.substr(9));
+                    return true;
+                }
+                if (line.starts_with("## FRAMEBUFFER:")) {
+                    std::string_view dims = line.substr(15);
+                    ev = HexEvent{};
+                    ev.kind = HexEventKind::FRAMEBUFFER;
+                    ev.fb_width = parse_int_token(next_token(dims));
+                    ev.fb_height = parse_int_token(next_token(dims));
+                    return true;
+                }
+                if (line.starts_with("## TEXTURE:")) {
+                    ev = HexEvent{};
+                    ev.kind = HexEventKind::TEXTURE;
+                    ev.texture = parse_texture_directive(std::string(line));
+                    return true;
+                }
+                if (line.starts_with("## TIMESTAMP:")) {
+                    std::string_view args = line.substr(13);
+                    ev = HexEvent{};
+                    ev.kind = HexEventKind::TIMESTAMP;
+                    ev.name = next_token(args);
+                    std::string_view addr_tok = next_token(args);
+                    if (ev.name.empty() || addr_tok.empty()) {
                         throw std::runtime_error(
-                            "Cannot include: " + full_path.string());
-                    }
-                    std::string inc_content(
-                        (std::istreambuf_iterator<char>(inc_file)),
-                        std::istreambuf_iterator<char>());
-                    // Parse included file (non-recursive)
-                    auto inc_script = parse_hex_string(inc_content);
-                    // Splice included commands into current phase
-                    for (const auto& phase : inc_script.phases) {
-                        current_phase.commands.insert(
-                            current_phase.commands.end(),
-                            phase.commands.begin(),
-                            phase.commands.end());
+                            "hex script line " + std::to_string(line_no_)
+                            + ": expected '## TIMESTAMP: <label> <addr>'");
                     }
-                    // Merge textures and framebuffer directives
-                    script.textures.insert(
-                        script.textures.end(),
-                        inc_script.textures.begin(),
-                        inc_script.textures.end());
-                    if (inc_script.fb_width > 0) {
-                        script.fb_width = inc_script.fb_width;
+                    ev.command.addr = REG_PERF_TIMESTAMP;
+                    ev.command.data = parse_hex_token(addr_tok, line_no_) & PERF_TIMESTAMP_ADDR_MASK;
+                    return true;
+                }
+                if (line.starts_with("## INCLUDE:")) {
+                    if (nested_) {
+                        continue;
                     }
-                    if (inc_script.fb_height > 0) {
-                        script.fb_height = inc_script.fb_height;
+                    ev = HexEvent{};
+                    ev.kind = HexEventKind::INCLUDE;
+                    ev.name = trim(line.substr(11));
+                    if (!base_dir_.empty()) {
+                        auto full_path = std::filesystem::path(base_dir_) / ev.name;
+                        include_ = std::make_unique<HexStreamReader>(
+                            open_file(full_path.string(), "Cannot include: "), std::string{},
+                            true);
                     }
+                    return true;
                 }
+                // Other ## directives: ignore
                 continue;
             }
-            // Other ## directives: ignore
-            continue;
-        }
 
-        // Strip comments (# to end of line)
-        auto comment_pos = line.find('#');
-        if (comment_pos != std::string::npos) {
-            line = line.substr(0, comment_pos);
-        }
+            // Strip comments (# to end of line)
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) {
+                continue;
+            }
 
-        // Strip whitespace
-        while (!line.empty() && (line.front() == ' ' || line.front() == '\t')) {
-            line.erase(line.begin());
+            // Parse data line: <addr_hex> <data_hex>
+            std::string_view addr_tok = next_token(line);
+            std::string_view data_tok = next_token(line);
+            if (addr_tok.empty() || data_tok.empty()) {
+                continue; // Malformed line, skip
+            }
+            ev = HexEvent{};
+            ev.kind = HexEventKind::COMMAND;
+            ev.command.addr = static_cast<uint8_t>(parse_hex_token(addr_tok, line_no_) & 0x7F);
+            ev.command.data = parse_hex_token(data_tok, line_no_);
+            return true;
         }
-        while (!line.empty() && (line.back() == ' ' || line.back() == '\t')) {
-            line.pop_back();
+    }
+
+    /// 1-based number of the last line read from this stream.
+    size_t line_number() const {
+        return line_no_;
+    }
+
+private:
+    static std::unique_ptr<std::istream> open_file(
+        const std::string& path, const char* what = "Cannot open hex script: ") {
+        auto file = std::make_unique<std::ifstream>(path, std::ios::binary);
+        if (!file->is_open()) {
+            throw std::runtime_error(what + path);
         }
+        return file;
+    }
 
-        // Skip empty lines
-        if (line.empty()) {
-            continue;
+    /// Return the next line (without its '\n') from the buffer, refilling
+    /// it from the stream as needed.
+    bool next_line(std::string_view& line) {
+        for (;;) {
+            const char* begin = buf_.get() + begin_;
+            if (const void* nl = std::memchr(begin, '\n', end_ - begin_)) {
+                const char* nlc = static_cast<const char*>(nl);
+                line = std::string_view(begin, static_cast<size_t>(nlc - begin));
+                begin_ += line.size() + 1;
+                line_no_++;
+                return true;
+            }
+            if (eof_) {
+                if (begin_ == end_) {
+                    return false;
+                }
+                line = std::string_view(begin, end_ - begin_); // last line, no '\n'
+                begin_ = end_;
+                line_no_++;
+                return true;
+            }
+            // Compact the partial line to the front and refill.
+            std::memmove(buf_.get(), begin, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+            if (end_ == BUFFER_SIZE) {
+                throw std::runtime_error(
+                    "hex script line " + std::to_string(line_no_ + 1) + ": line too long");
+            }
+            in_->read(buf_.get() + end_, static_cast<std::streamsize>(BUFFER_SIZE - end_));
+            end_ += static_cast<size_t>(in_->gcount());
+            if (!*in_) {
+                eof_ = true;
+            }
         }
+    }
 
-        // Parse data line: <addr_hex> <data_hex>
-        std::istringstream liss(line);
-        std::string addr_str;
-        std::string data_str;
-        liss >> addr_str >> data_str;
+    std::unique_ptr<std::istream> in_;
+    std::string base_dir_;
+    bool nested_ = false;            ///< Inside an include: drop PHASE/INCLUDE
+    std::unique_ptr<char[]> buf_;    ///< Fixed read buffer
+    size_t begin_ = 0;               ///< Start of unread data in buf_
+    size_t end_ = 0;                 ///< End of valid data in buf_
+    bool eof_ = false;
+    size_t line_no_ = 0;
+    std::unique_ptr<HexStreamReader> include_; ///< Active ## INCLUDE:
+};
 
-        if (addr_str.empty() || data_str.empty()) {
-            continue; // Malformed line, skip
-        }
+/// Collect every item of `reader` into a HexScript.
+///
+/// Commands before the first '## PHASE:' form an implicit "main" phase
+/// (dropped if empty); an explicit phase is kept even when empty.
+inline HexScript collect_hex_script(HexStreamReader& reader) {
+    HexScript script;
+    HexPhase current_phase;
+    current_phase.name = "main"; // default phase name
+    bool has_explicit_phase = false;
 
-        HexRegWrite rw{};
-        rw.addr = static_cast<uint8_t>(
-            hex_parser_detail::parse_hex64(addr_str) & 0x7F);
-        rw.data = hex_parser_detail::parse_hex64(data_str);
-        current_phase.commands.push_back(rw);
+    HexEvent ev;
+    while (reader.next(ev)) {
+        switch (ev.kind) {
+            case HexEventKind::COMMAND:
+                current_phase.commands.push_back(ev.command);
+                break;
+            case HexEventKind::PHASE:
+                // Save current phase if it has commands
+                if (!current_phase.commands.empty() || has_explicit_phase) {
+                    script.phases.push_back(std::move(current_phase));
+                    current_phase = HexPhase{};
+                }
+                current_phase.name = std::string(ev.name);
+                has_explicit_phase = true;
+                break;
+            case HexEventKind::FRAMEBUFFER:
+                if (ev.fb_width > 0) {
+                    script.fb_width = ev.fb_width;
+                }
+                if (ev.fb_height > 0) {
+                    script.fb_height = ev.fb_height;
+                }
+                break;
+            case HexEventKind::TEXTURE:
+                script.textures.push_back(std::move(ev.texture));
+                break;
+            case HexEventKind::INCLUDE:
+                break; // included items follow as ordinary events
+            case HexEventKind::TIMESTAMP:
+                // The marker lands in the phase like any command; a phase
+                // it opens implicitly is pushed at index phases.size().
+                current_phase.commands.push_back(ev.command);
+                script.timestamps.push_back({
+                    std::string(ev.name),
+                    static_cast<uint32_t>(ev.command.data),
+                    current_phase.name,
+                    script.phases.size(),
+                });
+                break;
+        }
     }
 
     // Push final phase
     if (!current_phase.commands.empty() || has_explicit_phase) {
         script.phases.push_back(std::move(current_phase));
     }
-
     return script;
 }
 
+/// Parse a hex script from a string, resolving ## INCLUDE: directives
+/// relative to base_dir.  If base_dir is empty, includes are silently
+/// ignored.
+inline HexScript parse_hex_string_with_base(
+    const std::string& content,
+    const std::string& base_dir)
+{
+    HexStreamReader reader(std::make_unique<std::istringstream>(content), base_dir);
+    return collect_hex_script(reader);
+}
+
+/// Parse a hex script from a string (no ## INCLUDE: support).
+inline HexScript parse_hex_string(const std::string& content) {
+    return parse_hex_string_with_base(content, "");
+}
+
 /// Parse a hex script from a file path.
 /// Supports ## INCLUDE: directives resolved relative to the file's directory.
+/// Thin wrapper over HexStreamReader for callers that want the whole script.
 inline HexScript parse_hex_file(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open hex script: " + filepath);
-    }
-    std::string content(
-        (std::istreambuf_iterator<char>(file)),
-        std::istreambuf_iterator<char>());
-    auto base_dir = std::filesystem::path(filepath).parent_path().string();
-    return parse_hex_string_with_base(content, base_dir);
+    HexStreamReader reader(filepath);
+    return collect_hex_script(reader);
 }
 
 #endif // HEX_PARSER_HPP
@@ -0,0 +1,169 @@
+// Per-scene performance metrics and baseline comparison implementation.
+//
+// See perf_baseline.hpp for the file format and what is gated.
+
+#include "perf_baseline.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view PHASE_PREFIX = "phase:";
+
+/// Signed percentage change from `base` to `now`.
+double delta_pct(uint64_t now, uint64_t base) {
+    return base ? 100.0 * (static_cast<double>(now) - static_cast<double>(base))
+                      / static_cast<double>(base)
+                : 0.0;
+}
+
+const SceneMetrics* find_metrics(std::span<const SceneMetrics> list, const std::string& scene) {
+    auto it = std::ranges::find(list, scene, &SceneMetrics::scene);
+    return it == list.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+void write_metrics_csv(const std::string& path, std::span<const SceneMetrics> metrics) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error(std::format("cannot write metrics file {}", path));
+    }
+    out << "scene,metric,value\n";
+    for (const auto& m : metrics) {
+        out << std::format("{},cycles,{}\n", m.scene, m.cycles);
+        for (const auto& [phase, cycles] : m.phase_cycles) {
+            out << std::format("{},{}{},{}\n", m.scene, PHASE_PREFIX, phase, cycles);
+        }
+        out << std::format("{},sdram_activates,{}\n", m.scene, m.sdram_activates);
+        out << std::format("{},sdram_reads,{}\n", m.scene, m.sdram_reads);
+        out << std::format("{},sdram_writes,{}\n", m.scene, m.sdram_writes);
+        out << std::format("{},hiz_rejected_tiles,{}\n", m.scene, m.hiz_rejected_tiles);
+        out << std::format("{},fragments,{}\n", m.scene, m.fragments);
+        out << std::format("{},cycles_per_second,{:.0f}\n", m.scene, m.cycles_per_second);
+    }
+    if (!out) {
+        throw std::runtime_error(std::format("error writing metrics file {}", path));
+    }
+}
+
+std::vector<SceneMetrics> read_metrics_csv(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error(std::format("cannot read metrics file {}", path));
+    }
+    std::vector<SceneMetrics> metrics;
+    std::string line;
+    for (size_t line_no = 1; std::getline(in, line); line_no++) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line.front() == '#' || line == "scene,metric,value") {
+            continue;
+        }
+        // Scene up to the first comma, value after the last; the metric
+        // (a phase name may contain commas) is everything in between.
+        size_t first = line.find(',');
+        size_t last = line.rfind(',');
+        if (first == std::string::npos || first == last) {
+            throw std::runtime_error(
+                std::format("{}:{}: expected scene,metric,value", path, line_no));
+        }
+        std::string scene = line.substr(0, first);
+        std::string metric = line.substr(first + 1, last - first - 1);
+        std::string_view text = std::string_view(line).substr(last + 1);
+        double value = 0.0;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{} || end != text.data() + text.size()) {
+            throw std::runtime_error(
+                std::format("{}:{}: bad value '{}'", path, line_no, text));
+        }
+
+        if (metrics.empty() || metrics.back().scene != scene) {
+            metrics.emplace_back().scene = scene;
+        }
+        SceneMetrics& m = metrics.back();
+        auto count = static_cast<uint64_t>(value);
+        if (metric == "cycles") {
+            m.cycles = count;
+        } else if (metric.starts_with(PHASE_PREFIX)) {
+            m.phase_cycles.emplace_back(metric.substr(PHASE_PREFIX.size()), count);
+        } else if (metric == "sdram_activates") {
+            m.sdram_activates = count;
+        } else if (metric == "sdram_reads") {
+            m.sdram_reads = count;
+        } else if (metric == "sdram_writes") {
+            m.sdram_writes = count;
+        } else if (metric == "hiz_rejected_tiles") {
+            m.hiz_rejected_tiles = count;
+        } else if (metric == "fragments") {
+            m.fragments = count;
+        } else if (metric == "cycles_per_second") {
+            m.cycles_per_second = value;
+        }
+    }
+    return metrics;
+}
+
+BaselineCheck compare_to_baseline(
+    std::span<const SceneMetrics> current,
+    std::span<const SceneMetrics> baseline,
+    double max_regression_pct,
+    bool require_baseline
+) {
+    BaselineCheck check;
+    check.report = std::format(
+        "Performance vs. baseline (fail above +{:.1f}% cycles):\n"
+        "  {:<20} {:>12} {:>12} {:>8} {:>8} {:>8}  {}\n",
+        max_regression_pct, "scene", "baseline", "cycles", "delta", "frags", "ACTs", "result");
+    size_t improved = 0;
+    for (const auto& m : current) {
+        const SceneMetrics* base = find_metrics(baseline, m.scene);
+        if (!base || base->cycles == 0) {
+            check.report += std::format(
+                "  {:<20} {:>12} {:>12} {:>8} {:>8} {:>8}  {}\n", m.scene, "-", m.cycles, "-",
+                "-", "-", require_baseline ? "MISSING" : "new");
+            if (require_baseline) {
+                check.missing++;
+            }
+            continue;
+        }
+        double delta = delta_pct(m.cycles, base->cycles);
+        const char* verdict = "ok";
+        if (delta > max_regression_pct) {
+            verdict = "REGRESSED";
+            check.regressions++;
+        } else if (delta < -max_regression_pct) {
+            verdict = "improved";
+            improved++;
+        }
+        // Fragment and ACTIVATE deltas show whether the scene now does
+        // different work or the same work more slowly.
+        check.report += std::format(
+            "  {:<20} {:>12} {:>12} {:>+7.1f}% {:>+7.1f}% {:>+7.1f}%  {}\n", m.scene, base->cycles,
+            m.cycles, delta, delta_pct(m.fragments, base->fragments),
+            delta_pct(m.sdram_activates, base->sdram_activates), verdict);
+        if (delta > max_regression_pct) {
+            for (const auto& [phase, cycles] : m.phase_cycles) {
+                auto it = std::ranges::find(base->phase_cycles, phase,
+                                            &std::pair<std::string, uint64_t>::first);
+                if (it != base->phase_cycles.end()) {
+                    check.report += std::format(
+                        "    phase {:<12} {:>12} {:>12} {:>+7.1f}%\n", phase, it->second, cycles,
+                        delta_pct(cycles, it->second));
+                }
+            }
+        }
+    }
+    check.report += std::format(
+        "{} scene(s) regressed, {} improved beyond {:.1f}%{}{}\n", check.regressions, improved,
+        max_regression_pct,
+        check.missing ? std::format(", {} without a baseline row", check.missing) : "",
+        improved || check.missing ? "; refresh the baseline with `make perf-baseline`" : "");
+    return check;
+}
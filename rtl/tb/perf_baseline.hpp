@@ -0,0 +1,71 @@
+// Per-scene performance metrics and baseline regression gating.
+//
+// Golden PNGs only catch pixel changes: an RTL change that costs 20%
+// throughput still passes `make test` as long as the image matches.
+// Regression runs (harness --all / --tests) therefore record a
+// SceneMetrics per scene and can write them to a metrics file and compare
+// them against a checked-in baseline (integration/golden/perf_baseline.csv).
+//
+// The file is long-format CSV, one `scene,metric,value` row per number,
+// so scenes with different phase lists share one file and a diff of the
+// baseline shows exactly which figure moved:
+//
+//   gouraud,cycles,123456
+//   gouraud,phase:setup,2345
+//   gouraud,sdram_activates,321
+//
+// Only total cycles are gated.  The other metrics are reported alongside
+// to explain a change; simulated cycles per second depends on the host, is
+// recorded for reference only and left out of the checked-in baseline.
+// With require_baseline (`make test` once the baseline has rows), a scene
+// with no baseline row or a zero-cycle one fails, so deleting a row cannot
+// turn its gate off unnoticed.
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Performance figures for one scene run.
+struct SceneMetrics {
+    std::string scene;
+    uint64_t cycles = 0;                                       ///< Total simulated cycles
+    std::vector<std::pair<std::string, uint64_t>> phase_cycles; ///< Script + drain per phase
+    uint64_t sdram_activates = 0;
+    uint64_t sdram_reads = 0;
+    uint64_t sdram_writes = 0;
+    uint64_t hiz_rejected_tiles = 0;
+    uint64_t fragments = 0;          ///< Fragments accepted by the pixel pipeline
+    double cycles_per_second = 0.0;  ///< Simulation rate (host dependent, not gated)
+};
+
+/// Outcome of compare_to_baseline().
+struct BaselineCheck {
+    std::string report;      ///< Multi-line per-scene comparison
+    size_t regressions = 0;  ///< Scenes whose cycles grew by more than the threshold
+    size_t missing = 0;      ///< Scenes without a usable baseline row (require_baseline only)
+};
+
+/// Write `metrics` as scene,metric,value rows.
+/// @throws std::runtime_error if the file cannot be written.
+void write_metrics_csv(const std::string& path, std::span<const SceneMetrics> metrics);
+
+/// Read a file written by write_metrics_csv().  Blank lines and lines
+/// starting with '#' are skipped; unknown metric names are ignored.
+/// @throws std::runtime_error if the file cannot be read or a row is malformed.
+std::vector<SceneMetrics> read_metrics_csv(const std::string& path);
+
+/// Compare each scene's total cycles with its baseline entry.  A scene
+/// regresses when its cycles exceed the baseline by more than
+/// `max_regression_pct` percent.  A scene with no baseline row, or a
+/// zero-cycle one, is counted as missing when `require_baseline` is set
+/// and listed as new otherwise.
+BaselineCheck compare_to_baseline(
+    std::span<const SceneMetrics> current,
+    std::span<const SceneMetrics> baseline,
+    double max_regression_pct,
+    bool require_baseline = false
+);
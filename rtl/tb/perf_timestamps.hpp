@@ -0,0 +1,92 @@
+// Header-only PERF_TIMESTAMP readback for the simulators.
+//
+// Writing PERF_TIMESTAMP (register 0x50) with a 32-bit-word SDRAM address
+// in DATA[22:0] makes gpu_top store the frame-relative cycle counter
+// (cleared at vsync) at that address once the write reaches the command
+// FIFO head, so a marker records when the GPU got to it rather than when
+// the host sent it.  The value lands in 16-bit words 2*addr (bits 15:0)
+// and 2*addr+1 (bits 31:16).  Back-to-back markers coalesce in gpu_top
+// (UNIT-007); the later one wins.
+//
+// The host arms each slot with PERF_TIMESTAMP_UNWRITTEN before its marker
+// is sent, so a marker the GPU never executed reads back as such instead
+// of as a plausible 0 or a stale value.  The counter restarts every frame,
+// so it never reaches that value in practice.
+//
+// Shared by the integration harness (rtl/tb/harness.cpp, '## TIMESTAMP:'
+// directives) and the interactive simulator (integration/sim/gpu_sim.cpp,
+// gpu.timestamp()).  Both SDRAM models provide read_word() / write_word()
+// on 16-bit word addresses.
+
+#ifndef PERF_TIMESTAMPS_HPP
+#define PERF_TIMESTAMPS_HPP
+
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "hex_parser.hpp"
+
+/// Slot contents of an armed marker that has not been written yet.
+inline constexpr uint32_t PERF_TIMESTAMP_UNWRITTEN = 0xFFFF'FFFF;
+
+/// Fill the slot of the marker at `word_addr` with PERF_TIMESTAMP_UNWRITTEN.
+template <typename Memory>
+void arm_perf_timestamp(Memory& sdram, uint32_t word_addr) {
+    uint32_t word = (word_addr & PERF_TIMESTAMP_ADDR_MASK) * 2;
+    sdram.write_word(word, 0xFFFF);
+    sdram.write_word(word + 1, 0xFFFF);
+}
+
+/// Read the 32-bit value of the marker at `word_addr`.
+template <typename Memory>
+uint32_t read_perf_timestamp(const Memory& sdram, uint32_t word_addr) {
+    uint32_t word = (word_addr & PERF_TIMESTAMP_ADDR_MASK) * 2;
+    return static_cast<uint32_t>(sdram.read_word(word))
+        | (static_cast<uint32_t>(sdram.read_word(word + 1)) << 16);
+}
+
+/// Multi-line timeline of `marks` in order: phase, label, cycle, and the
+/// delta from the previous marker that was written.  A marker reading
+/// below its predecessor was taken after a vsync restarted the counter.
+/// A marker whose slot a later marker reuses shows no value, since only
+/// the later one survives in SDRAM.
+template <typename Memory>
+std::string format_perf_timeline(const Memory& sdram, std::span<const TimestampDirective> marks) {
+    std::string r = "PERF_TIMESTAMP timeline (frame-relative cycles):\n";
+    std::unordered_set<uint32_t> later_addrs;
+    std::vector<bool> reused(marks.size());
+    for (size_t i = marks.size(); i-- > 0;) {
+        reused[i] = !later_addrs.insert(marks[i].word_addr).second;
+    }
+
+    bool have_prev = false;
+    uint32_t prev = 0;
+    for (size_t i = 0; i < marks.size(); i++) {
+        const auto& m = marks[i];
+        r += std::format("  {:<20} {:<24} ", m.phase, m.label);
+        if (reused[i]) {
+            r += std::format("{:>10}  (slot 0x{:06X} reused later)\n", "-", m.word_addr);
+            continue;
+        }
+        uint32_t value = read_perf_timestamp(sdram, m.word_addr);
+        if (value == PERF_TIMESTAMP_UNWRITTEN) {
+            r += std::format("{:>10}  (not written)\n", "-");
+            continue;
+        }
+        r += std::format("{:>10}", value);
+        if (have_prev) {
+            r += value >= prev ? std::format("  {:>+10}", static_cast<int64_t>(value - prev))
+                               : std::string("  (after vsync)");
+        }
+        r += "\n";
+        have_prev = true;
+        prev = value;
+    }
+    return r;
+}
+
+#endif // PERF_TIMESTAMPS_HPP
@@ -0,0 +1,181 @@
+// PNG image reader implementation for the integration test harness.
+//
+// zlib inflates the IDAT stream; PNG structure and row filters follow
+// the PNG specification (ISO/IEC 15948).
+
+#include "png_reader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+#include <zlib.h>
+
+namespace png_reader {
+
+namespace {
+
+[[noreturn]] void fail(const char* what) {
+    throw std::runtime_error(std::format("PNG decode: {}", what));
+}
+
+// ---------------------------------------------------------------------------
+// Inflate (zlib)
+// ---------------------------------------------------------------------------
+
+/// Inflate a zlib stream into exactly `size` bytes; zlib checks the
+/// header and, when the stream ends there, its Adler-32.  Data past
+/// `size` is ignored.
+std::vector<uint8_t> inflate_zlib(std::span<const uint8_t> z, size_t size) {
+    std::vector<uint8_t> out(size);
+    z_stream zs{};
+    if (inflateInit(&zs) != Z_OK) {
+        fail("inflateInit failed");
+    }
+    zs.next_in = const_cast<Bytef*>(z.data());
+    zs.avail_in = static_cast<uInt>(z.size());
+    zs.next_out = out.data();
+    zs.avail_out = static_cast<uInt>(out.size());
+    int ret = inflate(&zs, Z_FINISH);
+    uInt missing = zs.avail_out;
+    inflateEnd(&zs);
+    if (ret == Z_DATA_ERROR || ret == Z_NEED_DICT || ret == Z_MEM_ERROR) {
+        fail("corrupt zlib stream");
+    }
+    if (missing != 0) {
+        fail("image data too short");
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// PNG
+// ---------------------------------------------------------------------------
+
+uint32_t be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+        | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+} // namespace
+
+RgbImage decode_png(std::span<const uint8_t> png) {
+    static constexpr std::array<uint8_t, 8> SIGNATURE = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (png.size() < SIGNATURE.size() || !std::equal(SIGNATURE.begin(), SIGNATURE.end(), png.begin())) {
+        fail("not a PNG file");
+    }
+
+    RgbImage img;
+    int channels = 0;
+    std::vector<uint8_t> idat;
+    bool have_header = false;
+    bool have_end = false;
+    for (size_t pos = SIGNATURE.size(); pos + 12 <= png.size() && !have_end;) {
+        uint32_t len = be32(&png[pos]);
+        std::string_view type(reinterpret_cast<const char*>(&png[pos + 4]), 4);
+        if (len > png.size() - pos - 12) {
+            fail("truncated chunk");
+        }
+        const uint8_t* data = &png[pos + 8];
+        if (type == "IHDR") {
+            if (len != 13) {
+                fail("bad IHDR");
+            }
+            img.width = static_cast<int>(be32(data));
+            img.height = static_cast<int>(be32(data + 4));
+            uint8_t depth = data[8];
+            uint8_t color = data[9];
+            if (depth != 8 || data[10] != 0 || data[11] != 0 || data[12] != 0) {
+                fail("only 8-bit, non-interlaced images are supported");
+            }
+            switch (color) {
+                case 0: channels = 1; break; // gray
+                case 2: channels = 3; break; // RGB
+                case 4: channels = 2; break; // gray + alpha
+                case 6: channels = 4; break; // RGBA
+                default: fail("unsupported color type");
+            }
+            if (img.width <= 0 || img.height <= 0 || img.width > (1 << 16) || img.height > (1 << 16)) {
+                fail("bad image size");
+            }
+            have_header = true;
+        } else if (type == "IDAT") {
+            idat.insert(idat.end(), data, data + len);
+        } else if (type == "IEND") {
+            have_end = true;
+        }
+        pos += 12 + len; // length, type, data, CRC (not verified)
+    }
+    if (!have_header || idat.empty()) {
+        fail("missing IHDR or IDAT");
+    }
+
+    size_t stride = static_cast<size_t>(img.width) * channels;
+    size_t rows = static_cast<size_t>(img.height);
+    std::vector<uint8_t> raw = inflate_zlib(idat, rows * (stride + 1));
+
+    // Undo the per-row filters in place; filter bytes are skipped.
+    size_t bpp = static_cast<size_t>(channels);
+    for (size_t y = 0; y < rows; y++) {
+        uint8_t filter = raw[y * (stride + 1)];
+        uint8_t* row = &raw[y * (stride + 1) + 1];
+        const uint8_t* up = y > 0 ? &raw[(y - 1) * (stride + 1) + 1] : nullptr;
+        for (size_t x = 0; x < stride; x++) {
+            uint8_t a = x >= bpp ? row[x - bpp] : 0;
+            uint8_t b = up ? up[x] : 0;
+            uint8_t c = (up && x >= bpp) ? up[x - bpp] : 0;
+            switch (filter) {
+                case 0: break;
+                case 1: row[x] = static_cast<uint8_t>(row[x] + a); break;
+                case 2: row[x] = static_cast<uint8_t>(row[x] + b); break;
+                case 3: row[x] = static_cast<uint8_t>(row[x] + ((a + b) >> 1)); break;
+                case 4: row[x] = static_cast<uint8_t>(row[x] + paeth(a, b, c)); break;
+                default: fail("bad row filter");
+            }
+        }
+    }
+
+    img.rgb.resize(rows * static_cast<size_t>(img.width) * 3);
+    for (size_t y = 0; y < rows; y++) {
+        const uint8_t* row = &raw[y * (stride + 1) + 1];
+        uint8_t* dst = &img.rgb[y * static_cast<size_t>(img.width) * 3];
+        for (int x = 0; x < img.width; x++) {
+            const uint8_t* px = row + static_cast<size_t>(x) * bpp;
+            bool gray = channels < 3;
+            dst[x * 3] = px[0];
+            dst[x * 3 + 1] = gray ? px[0] : px[1];
+            dst[x * 3 + 2] = gray ? px[0] : px[2];
+        }
+    }
+    return img;
+}
+
+RgbImage read_png(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error(std::format("cannot read {}", path.string()));
+    }
+    std::vector<uint8_t> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    try {
+        return decode_png(bytes);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::format("{}: {}", path.string(), e.what()));
+    }
+}
+
+} // namespace png_reader
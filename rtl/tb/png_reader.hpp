@@ -0,0 +1,42 @@
+// PNG image reader for the integration test harness.
+//
+// Decodes golden images so the harness can compare rendered pixels
+// against them directly instead of comparing encoded PNG bytes, which
+// would tie the goldens to one encoder's output.
+//
+// Inflates with zlib (which Verilator's FST tracing already requires)
+// and undoes the PNG row filters itself.
+// Supports what image tools produce for the goldens: 8-bit grayscale,
+// grayscale+alpha, RGB and RGBA, non-interlaced.  Alpha is dropped.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace png_reader {
+
+/// Decoded image as packed 8-bit RGB, row-major, top-left pixel first.
+struct RgbImage {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgb; ///< width * height * 3 bytes
+};
+
+/// Decode PNG file bytes.
+///
+/// @param png  Complete PNG file contents.
+/// @return The image, with grayscale expanded to RGB.
+/// @throws std::runtime_error on malformed or unsupported input.
+RgbImage decode_png(std::span<const uint8_t> png);
+
+/// Read and decode a PNG file.
+///
+/// @param path  PNG file path.
+/// @throws std::runtime_error if the file cannot be read or decoded.
+RgbImage read_png(const std::filesystem::path& path);
+
+} // namespace png_reader
@@ -32,12 +32,7 @@ Rgb888 rgb565_to_rgb888(uint16_t rgb565) {
     };
 }
 
-void write_png(const char* filename, int width, int height, std::span<const uint16_t> framebuffer) {
-    if (!filename || width <= 0 || height <= 0) {
-        throw std::runtime_error("write_png: invalid parameters");
-    }
-
-    // Convert RGB565 framebuffer to RGB888 buffer for stb_image_write.
+std::vector<uint8_t> rgb565_to_rgb888(std::span<const uint16_t> framebuffer) {
     std::vector<uint8_t> rgb(framebuffer.size() * 3);
 
     // Transform each RGB565 pixel into three consecutive RGB888 bytes.
@@ -48,6 +43,16 @@ void write_png(const char* filename, int width, int height, std::span<const uint
         rgb[i * 3 + 2] = b;
         ++i;
     });
+    return rgb;
+}
+
+void write_png(const char* filename, int width, int height, std::span<const uint16_t> framebuffer) {
+    if (!filename || width <= 0 || height <= 0) {
+        throw std::runtime_error("write_png: invalid parameters");
+    }
+
+    // Convert RGB565 framebuffer to RGB888 buffer for stb_image_write.
+    std::vector<uint8_t> rgb = rgb565_to_rgb888(framebuffer);
 
     // Write PNG.  Stride = width * 3 bytes per row.
     int result = stbi_write_png(filename, width, height, 3, rgb.data(), width * 3);
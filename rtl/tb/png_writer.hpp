@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <span>
 #include <stdexcept>
+#include <vector>
 
 namespace png_writer {
 
@@ -51,6 +52,10 @@ void write_png(const char* filename, int width, int height, std::span<const uint
 /// @return Rgb888 struct with r, g, b channels (0-255 each).
 Rgb888 rgb565_to_rgb888(uint16_t rgb565);
 
+/// Expand an RGB565 framebuffer to packed 8-bit RGB (3 bytes per pixel)
+/// with rgb565_to_rgb888().
+std::vector<uint8_t> rgb565_to_rgb888(std::span<const uint16_t> framebuffer);
+
 /// Write a grayscale PNG from an array of 8-bit luminance values.
 ///
 /// @param filename  Output file path.
@@ -0,0 +1,171 @@
+// SDRAM bandwidth and row-locality analyzer implementation.
+//
+// See sdram_bus_stats.hpp for what is measured.
+
+#include "sdram_bus_stats.hpp"
+
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+double percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+double ratio(uint64_t num, uint64_t den) {
+    return den ? static_cast<double>(num) / static_cast<double>(den) : 0.0;
+}
+
+} // namespace
+
+const char* arbiter_port_name(ArbiterPort port) {
+    switch (port) {
+        case ArbiterPort::DISPLAY:
+            return "display";
+        case ArbiterPort::COLOR:
+            return "color";
+        case ArbiterPort::ZBUF:
+            return "zbuf";
+        case ArbiterPort::TEXTURE:
+            return "texture";
+        case ArbiterPort::CONTROLLER:
+            return "controller";
+    }
+    return "?";
+}
+
+SdramBusStats::SdramBusStats(uint64_t window_cycles)
+    : window_cycles_(window_cycles ? window_cycles : DEFAULT_WINDOW_CYCLES) {}
+
+void SdramBusStats::sample(const SdramPins& pins, ArbiterPort port) {
+    if (cycles_ % window_cycles_ == 0) {
+        timeline_.push_back({.start_cycle = cycles_});
+    }
+    cycles_++;
+    SdramBusWindow& window = timeline_.back();
+    window.cycles++;
+    Port& p = ports_[static_cast<size_t>(port)];
+
+    switch (pins.cmd) {
+        case SDRAM_CMD_ACTIVATE: {
+            Bank& bank = banks_[pins.ba];
+            if (bank.has_last_row && bank.last_row == pins.a) {
+                bank.same_row_reopens++;
+            }
+            bank.has_last_row = true;
+            bank.last_row = pins.a;
+            bank.activates++;
+            bank.accessed_since_activate = false;
+            activate_cycles_++;
+            p.activates++;
+            window.activates++;
+            break;
+        }
+
+        case SDRAM_CMD_READ:
+        case SDRAM_CMD_WRITE: {
+            Bank& bank = banks_[pins.ba];
+            bank.accesses++;
+            if (bank.accessed_since_activate) {
+                bank.row_hits++;
+            }
+            bank.accessed_since_activate = true;
+            data_cycles_++;
+            if (pins.cmd == SDRAM_CMD_READ) {
+                p.read_words++;
+                window.read_words++;
+            } else {
+                p.write_words++;
+                window.write_words++;
+            }
+            window.port_words[static_cast<size_t>(port)]++;
+            break;
+        }
+
+        case SDRAM_CMD_PRECHARGE:
+            precharge_cycles_++;
+            p.precharges++;
+            break;
+
+        case SDRAM_CMD_AUTO_REFRESH:
+            refresh_cycles_++;
+            break;
+
+        case SDRAM_CMD_LOAD_MODE:
+            other_cycles_++;
+            break;
+
+        default:
+            break; // NOP / deselect: idle slot
+    }
+}
+
+std::string SdramBusStats::report() const {
+    uint64_t words = data_cycles_;
+    uint64_t activates = activate_cycles_;
+    uint64_t idle = cycles_ - data_cycles_ - activate_cycles_ - precharge_cycles_ - refresh_cycles_
+        - other_cycles_;
+
+    std::string r = std::format(
+        "SDRAM bus: {} cycles, {} words ({:.1f}% utilization), {} ACTIVATEs, "
+        "{:.1f} words/ACTIVATE\n",
+        cycles_, words, percent(words, cycles_), activates, ratio(words, activates)
+    );
+    r += std::format(
+        "  command slots: data {:.1f}%  activate {:.1f}%  precharge {:.1f}%  refresh {:.1f}%  "
+        "idle {:.1f}%\n",
+        percent(data_cycles_, cycles_), percent(activate_cycles_, cycles_),
+        percent(precharge_cycles_, cycles_), percent(refresh_cycles_, cycles_),
+        percent(idle, cycles_)
+    );
+    for (int b = 0; b < SDRAM_BANK_COUNT; b++) {
+        const Bank& bank = banks_[b];
+        r += std::format(
+            "  bank {}: {:>9} accesses, row hit {:5.1f}%, {:>7} ACTIVATEs "
+            "({} reopened the previous row)\n",
+            b, bank.accesses, percent(bank.row_hits, bank.accesses), bank.activates,
+            bank.same_row_reopens
+        );
+    }
+    for (size_t i = 0; i < ARBITER_PORT_COUNT; i++) {
+        const Port& p = ports_[i];
+        uint64_t port_words = p.read_words + p.write_words;
+        if (port_words == 0 && p.activates == 0 && p.precharges == 0) {
+            continue;
+        }
+        r += std::format(
+            "  port {:<10} {:>9} words ({:5.1f}% of traffic; {} read, {} write), "
+            "{} ACTIVATEs, {:.1f} words/ACTIVATE\n",
+            arbiter_port_name(static_cast<ArbiterPort>(i)), port_words, percent(port_words, words),
+            p.read_words, p.write_words, p.activates, ratio(port_words, p.activates)
+        );
+    }
+    return r;
+}
+
+void SdramBusStats::write_timeline_csv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error(std::format("cannot write SDRAM timeline {}", path));
+    }
+    out << "start_cycle,cycles,read_words,write_words,activates,utilization";
+    for (size_t i = 0; i < ARBITER_PORT_COUNT; i++) {
+        out << ',' << arbiter_port_name(static_cast<ArbiterPort>(i)) << "_words";
+    }
+    out << '\n';
+    for (const auto& w : timeline_) {
+        out << std::format(
+            "{},{},{},{},{},{:.4f}", w.start_cycle, w.cycles, w.read_words, w.write_words,
+            w.activates, ratio(w.read_words + w.write_words, w.cycles)
+        );
+        for (uint64_t n : w.port_words) {
+            out << ',' << n;
+        }
+        out << '\n';
+    }
+    if (!out) {
+        throw std::runtime_error(std::format("cannot write SDRAM timeline {}", path));
+    }
+}
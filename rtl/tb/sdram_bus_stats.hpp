@@ -0,0 +1,111 @@
+// SDRAM bandwidth and row-locality analyzer for the integration harness
+// (--sdram-stats).
+//
+// SdramPinAdapter (sdram_pins.hpp) only keeps global ACTIVATE / READ /
+// WRITE counts.  SdramBusStats watches the same decoded pins each cycle,
+// together with the sram_arbiter (UNIT-007) grant, and accumulates:
+//
+//   - a command-slot breakdown (data, ACTIVATE, PRECHARGE, REFRESH, idle)
+//   - per-bank row hits (READ/WRITE to the row already open) against
+//     ACTIVATEs, and how many ACTIVATEs reopened the row the bank had
+//     open last (a miss an open-row policy would have avoided)
+//   - per-arbiter-port words and ACTIVATEs, so the cost of each client
+//     can be weighed against its share of the bus
+//   - a bandwidth timeline in fixed cycle windows
+//
+// Every READ / WRITE command moves one 16-bit word (the controller issues
+// one command per column, see sdram_controller.sv), so data words equal
+// data command slots.  Commands issued without an active grant (power-up,
+// auto-refresh) are attributed to the controller itself.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sdram_pins.hpp"
+
+/// Arbiter ports (sram_arbiter.sv priority order), plus the controller
+/// for commands issued outside any grant.
+enum class ArbiterPort : uint8_t {
+    DISPLAY,    ///< Port 0: display scanout
+    COLOR,      ///< Port 1: color tile cache
+    ZBUF,       ///< Port 2: Z tile cache
+    TEXTURE,    ///< Port 3: texture cache / DMA / PERF_TIMESTAMP
+    CONTROLLER, ///< No grant: init, refresh
+};
+
+/// Number of ArbiterPort values.
+inline constexpr size_t ARBITER_PORT_COUNT = 5;
+
+/// Display name of `port` (e.g. "color").
+const char* arbiter_port_name(ArbiterPort port);
+
+/// Bus activity within one timeline window.
+struct SdramBusWindow {
+    uint64_t start_cycle = 0;
+    uint64_t cycles = 0;
+    uint64_t read_words = 0;
+    uint64_t write_words = 0;
+    uint64_t activates = 0;
+    std::array<uint64_t, ARBITER_PORT_COUNT> port_words{};
+};
+
+/// Per-cycle SDRAM command statistics.
+class SdramBusStats {
+public:
+    /// Default timeline window length in cycles.
+    static constexpr uint64_t DEFAULT_WINDOW_CYCLES = 10'000;
+
+    explicit SdramBusStats(uint64_t window_cycles = DEFAULT_WINDOW_CYCLES);
+
+    /// Account one cycle: the pins as decoded by connect_sdram() and the
+    /// port holding the arbiter grant.
+    void sample(const SdramPins& pins, ArbiterPort port);
+
+    /// Multi-line summary: command breakdown, banks and ports.
+    std::string report() const;
+
+    /// Write the bandwidth timeline as CSV, one row per window.
+    /// @throws std::runtime_error if the file cannot be written.
+    void write_timeline_csv(const std::string& path) const;
+
+    /// Timeline windows so far (the last one may be partial).
+    const std::vector<SdramBusWindow>& timeline() const {
+        return timeline_;
+    }
+
+private:
+    /// Row-locality counters for one bank.
+    struct Bank {
+        bool has_last_row = false;
+        uint32_t last_row = 0;          ///< Row most recently activated
+        uint64_t activates = 0;
+        uint64_t same_row_reopens = 0;  ///< ACTIVATE of last_row after a PRECHARGE
+        uint64_t accesses = 0;          ///< READ + WRITE
+        uint64_t row_hits = 0;          ///< Accesses after the first per ACTIVATE
+        bool accessed_since_activate = false;
+    };
+
+    /// Counters for one arbiter port.
+    struct Port {
+        uint64_t read_words = 0;
+        uint64_t write_words = 0;
+        uint64_t activates = 0;
+        uint64_t precharges = 0;
+    };
+
+    uint64_t window_cycles_;
+    uint64_t cycles_ = 0;
+    uint64_t data_cycles_ = 0;
+    uint64_t activate_cycles_ = 0;
+    uint64_t precharge_cycles_ = 0;
+    uint64_t refresh_cycles_ = 0;
+    uint64_t other_cycles_ = 0; ///< LOAD_MODE
+    std::array<Bank, SDRAM_BANK_COUNT> banks_{};
+    std::array<Port, ARBITER_PORT_COUNT> ports_{};
+    std::vector<SdramBusWindow> timeline_;
+};
@@ -0,0 +1,130 @@
+// Memory-mapped SDRAM image file implementation (POSIX mmap).
+//
+// See sdram_image.hpp for the file format and mapping modes.
+
+#include "sdram_image.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/// Throw std::runtime_error for a failed system call on `path`.
+[[noreturn]] void fail(const std::string& what, const std::string& path) {
+    throw std::runtime_error(std::format("SDRAM image {}: {}: {}", path, what, std::strerror(errno)));
+}
+
+/// Closes a file descriptor on scope exit (the mapping outlives it).
+struct FdCloser {
+    int fd;
+    ~FdCloser() {
+        ::close(fd);
+    }
+};
+
+/// Data regions of `fd` within [0, bytes), as word ranges.  Falls back to
+/// the whole range when SEEK_DATA is unsupported.
+std::vector<std::pair<size_t, size_t>> find_extents(int fd, size_t bytes) {
+    std::vector<std::pair<size_t, size_t>> extents;
+    off_t pos = 0;
+    while (static_cast<size_t>(pos) < bytes) {
+        off_t data = ::lseek(fd, pos, SEEK_DATA);
+        if (data < 0) {
+            if (errno == ENXIO) {
+                break; // no more data: the rest is a hole
+            }
+            return {{0, bytes / 2}};
+        }
+        if (static_cast<size_t>(data) >= bytes) {
+            break;
+        }
+        off_t hole = ::lseek(fd, data, SEEK_HOLE);
+        if (hole < 0) {
+            return {{0, bytes / 2}};
+        }
+        size_t end = std::min(static_cast<size_t>(hole), bytes);
+        extents.emplace_back(static_cast<size_t>(data) / 2, (end + 1) / 2);
+        pos = hole;
+    }
+    return extents;
+}
+
+} // namespace
+
+SdramImageMode parse_sdram_image_mode(const std::string& name) {
+    if (name == "cow") {
+        return SdramImageMode::COPY_ON_WRITE;
+    }
+    if (name == "shared") {
+        return SdramImageMode::SHARED;
+    }
+    throw std::invalid_argument(
+        std::format("unknown SDRAM image mode '{}' (expected cow or shared)", name)
+    );
+}
+
+SdramImage::SdramImage(const std::string& path, size_t num_words, SdramImageMode mode)
+    : path_(path), mode_(mode), num_words_(num_words) {
+    size_t bytes = num_words * sizeof(uint16_t);
+    bool shared = (mode == SdramImageMode::SHARED);
+
+    int fd = ::open(path.c_str(), shared ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (fd < 0) {
+        fail("cannot open", path);
+    }
+    FdCloser closer{fd};
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        fail("cannot stat", path);
+    }
+    // A shared image must cover the whole SDRAM so every write has a home
+    // in the file; ftruncate() extends it with a hole.  A private mapping
+    // beyond EOF would fault, so short copy-on-write images are mapped
+    // whole and the tail is backed by anonymous zero pages below.
+    size_t file_bytes = static_cast<size_t>(st.st_size);
+    if (shared && file_bytes < bytes) {
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            fail("cannot extend", path);
+        }
+        file_bytes = bytes;
+    }
+
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        fail("cannot reserve memory", path);
+    }
+    size_t map_bytes = std::min(file_bytes, bytes);
+    if (map_bytes > 0) {
+        void* file_map = ::mmap(
+            base, map_bytes, PROT_READ | PROT_WRITE, (shared ? MAP_SHARED : MAP_PRIVATE) | MAP_FIXED,
+            fd, 0
+        );
+        if (file_map == MAP_FAILED) {
+            ::munmap(base, bytes);
+            fail("cannot map", path);
+        }
+    }
+    words_ = static_cast<uint16_t*>(base);
+    extents_ = find_extents(fd, map_bytes);
+}
+
+SdramImage::~SdramImage() {
+    if (words_) {
+        ::munmap(words_, num_words_ * sizeof(uint16_t));
+    }
+}
+
+void SdramImage::sync() const {
+    if (mode_ == SdramImageMode::SHARED) {
+        ::msync(words_, num_words_ * sizeof(uint16_t), MS_SYNC);
+    }
+}
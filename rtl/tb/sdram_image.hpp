@@ -0,0 +1,90 @@
+// Memory-mapped SDRAM image file shared by SdramModel (integration
+// harness) and SdramModelSim (interactive simulator).
+//
+// An SDRAM image is the raw little-endian 16-bit word array of the whole
+// SDRAM, word 0 first (32 MB for the W9825G6KH).  Mapping one lets a run
+// start with textures, palettes or any other data already in memory
+// instead of replaying the MEM_DATA upload, and lets external tools
+// inspect the final SDRAM state of a run without another simulation.
+//
+// Two modes:
+//   COPY_ON_WRITE -- MAP_PRIVATE.  The file is a read-only preload; the
+//                    run's writes stay in process memory.
+//   SHARED        -- MAP_SHARED.  Writes land in the file, which holds
+//                    the final SDRAM state once the model is destroyed.
+//                    The file is created (sparse, all zero) if missing.
+//
+// Image files are expected to be sparse: data_extents() reports the
+// regions that hold data (SEEK_DATA / SEEK_HOLE), so models can skip the
+// holes, which are known to be zero, without reading the whole file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// How an SDRAM image file is mapped.
+enum class SdramImageMode : uint8_t {
+    COPY_ON_WRITE, ///< Private mapping: file is preload-only
+    SHARED,        ///< Shared mapping: writes go back to the file
+};
+
+/// Parse "cow" / "shared" into an SdramImageMode.
+/// @throws std::invalid_argument for any other string.
+SdramImageMode parse_sdram_image_mode(const std::string& name);
+
+/// RAII mapping of an SDRAM image file.
+class SdramImage {
+public:
+    /// Map `path` as `num_words` 16-bit words.
+    ///
+    /// A COPY_ON_WRITE image must exist; words past its end read as zero.
+    /// A SHARED image is created if missing and extended (sparsely) to
+    /// num_words.  A longer file is mapped only up to num_words.
+    ///
+    /// @throws std::runtime_error if the file cannot be opened or mapped.
+    SdramImage(const std::string& path, size_t num_words, SdramImageMode mode);
+    ~SdramImage();
+
+    SdramImage(const SdramImage&) = delete;
+    SdramImage& operator=(const SdramImage&) = delete;
+
+    /// Mapped words.
+    uint16_t* data() const {
+        return words_;
+    }
+
+    /// Number of mapped words.
+    size_t size() const {
+        return num_words_;
+    }
+
+    SdramImageMode mode() const {
+        return mode_;
+    }
+
+    const std::string& path() const {
+        return path_;
+    }
+
+    /// Word ranges [first, last) that may hold non-zero data, in ascending
+    /// order.  Everything outside them is a file hole and reads as zero.
+    /// Falls back to the whole image when the filesystem cannot report
+    /// holes.
+    const std::vector<std::pair<size_t, size_t>>& data_extents() const {
+        return extents_;
+    }
+
+    /// Flush a SHARED image to the file (no-op for COPY_ON_WRITE).
+    void sync() const;
+
+private:
+    std::string path_;
+    SdramImageMode mode_;
+    size_t num_words_;
+    uint16_t* words_ = nullptr;
+    std::vector<std::pair<size_t, size_t>> extents_;
+};
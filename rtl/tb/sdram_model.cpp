@@ -7,7 +7,7 @@
 // This is a minimal, byte-array-backed SDRAM model that provides correct
 // word-level read/write semantics.  Cycle-level command timing
 // (ACTIVATE / READ / WRITE / PRECHARGE, CAS latency, refresh, bank
-// state) is layered on by connect_sdram() in harness.cpp.
+// state) is layered on by connect_sdram() in sdram_pins.hpp.
 //
 // Texture-pipeline burst patterns served by this model:
 //
@@ -42,30 +42,119 @@
 #include "sdram_model.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <cstdio>
 #include <cstring>
+#include <new>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace {
 /// Bytes per palette slot (UNIT-011.06): 256 entries x 4 quadrants x 4
 /// bytes per RGBA8888 channel = 4096 bytes.  Matches the
 /// `texture_palette_lut.sv` load FSM transfer length.
 constexpr std::size_t PALETTE_SLOT_BYTES = 4096;
+
+/// De-tile one row of 4x4 RGB565 blocks into four framebuffer rows.
+///
+/// Block `bx` starts at blocks + bx * 32 (read_framebuffer() addressing:
+/// model words are byte addresses, so a block's 16 pixels sit at the even
+/// offsets 0, 2, ..., 30 and pixel row `ly` at ly * 8).  Its rows land in
+/// `rows` (four framebuffer rows, `stride` pixels apart) at column bx * 4.
+/// All `blocks_x` blocks must lie inside the model.
+void detile_block_row(const uint16_t* blocks, int blocks_x, uint16_t* rows, size_t stride) {
+    int bx = 0;
+#if defined(__SSE2__)
+    // One 16-byte load holds a block's pixel row in its even 16-bit lanes.
+    // Sign-extending each 32-bit lane from its low half drops the odd
+    // lane, and _mm_packs_epi32 then packs two blocks' rows into the eight
+    // contiguous pixels of one store without saturating.
+    for (; bx + 2 <= blocks_x; bx += 2) {
+        const uint16_t* a = blocks + static_cast<size_t>(bx) * 32;
+        const uint16_t* b = a + 32;
+        uint16_t* dst = rows + static_cast<size_t>(bx) * 4;
+        for (int ly = 0; ly < 4; ly++) {
+            __m128i ra = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + ly * 8));
+            __m128i rb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + ly * 8));
+            ra = _mm_srai_epi32(_mm_slli_epi32(ra, 16), 16);
+            rb = _mm_srai_epi32(_mm_slli_epi32(rb, 16), 16);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(dst + static_cast<size_t>(ly) * stride),
+                _mm_packs_epi32(ra, rb)
+            );
+        }
+    }
+#endif
+    for (; bx < blocks_x; bx++) {
+        const uint16_t* block = blocks + static_cast<size_t>(bx) * 32;
+        for (int ly = 0; ly < 4; ly++) {
+            for (int lx = 0; lx < 4; lx++) {
+                rows[static_cast<size_t>(ly) * stride + static_cast<size_t>(bx) * 4 + lx] =
+                    block[ly * 8 + lx * 2];
+            }
+        }
+    }
+}
 }
 
-SdramModel::SdramModel(uint32_t num_words) : mem_(num_words, 0) {}
+SdramModel::SdramModel(uint32_t num_words)
+    : num_words_(num_words),
+      owned_(static_cast<uint16_t*>(std::calloc(std::max<size_t>(num_words, 1), sizeof(uint16_t)))),
+      mem_(owned_.get()),
+      dirty_((num_words / PAGE_WORDS + 64) / 64, 0) {
+    if (!owned_) {
+        throw std::bad_alloc();
+    }
+}
+
+SdramModel::SdramModel(uint32_t num_words, const std::string& image_path, SdramImageMode mode)
+    : num_words_(num_words),
+      image_(std::make_unique<SdramImage>(image_path, num_words, mode)),
+      mem_(image_->data()),
+      dirty_((num_words / PAGE_WORDS + 64) / 64, 0) {
+    // Holes in the image file are zero; only pages overlapping its data
+    // extents can hold staged contents.
+    for (auto [first, last] : image_->data_extents()) {
+        for (size_t page = first / PAGE_WORDS; page * PAGE_WORDS < last; page++) {
+            mark_page(static_cast<uint32_t>(page * PAGE_WORDS));
+        }
+    }
+}
 
 uint16_t SdramModel::read_word(uint32_t word_addr) const {
-    if (word_addr >= mem_.size()) {
+    if (word_addr >= num_words_) {
         return 0;
     }
     return mem_[word_addr];
 }
 
 void SdramModel::write_word(uint32_t word_addr, uint16_t data) {
-    if (word_addr >= mem_.size()) {
+    if (word_addr >= num_words_) {
         return;
     }
     mem_[word_addr] = data;
+    mark_page(word_addr);
+}
+
+std::span<uint16_t> SdramModel::writable_range(uint32_t first_word, uint32_t count) {
+    if (first_word >= num_words_) {
+        return {};
+    }
+    count = std::min(count, num_words_ - first_word);
+    for (uint32_t page = first_word / PAGE_WORDS; page * PAGE_WORDS < first_word + count; page++) {
+        mark_page(page * PAGE_WORDS);
+    }
+    return {mem_ + first_word, count};
+}
+
+uint32_t SdramModel::touched_pages() const {
+    uint32_t n = 0;
+    for (uint64_t bits : dirty_) {
+        n += static_cast<uint32_t>(std::popcount(bits));
+    }
+    return n;
 }
 
 void SdramModel::upload_raw(uint32_t base_word_addr, std::span<const uint8_t> data) {
@@ -134,18 +223,56 @@ SdramModel::read_framebuffer(uint32_t base_word, int width_log2, int height) con
     // base_word is in byte units (fb_color_base << 9).
     int blocks_log2 = (width_log2 >= 2) ? (width_log2 - 2) : 0;
 
-    for (int py = 0; py < height; ++py) {
-        for (int px = 0; px < width; ++px) {
-            uint32_t block_x = static_cast<uint32_t>(px) >> 2;
-            uint32_t block_y = static_cast<uint32_t>(py) >> 2;
-            uint32_t local_x = static_cast<uint32_t>(px) & 3;
-            uint32_t local_y = static_cast<uint32_t>(py) & 3;
-            uint32_t block_idx = (block_y << blocks_log2) | block_x;
-            uint32_t block_off = block_idx << 5;  // 32 bytes per block
-            uint32_t pixel_off = (local_y * 4 + local_x) * 2;
-            uint32_t byte_addr = base_word + block_off + pixel_off;
-
-            fb[py * width + px] = read_word(byte_addr);
+    // Walk 4x4 blocks rather than pixels so that blocks in untouched
+    // pages (known zero) are skipped without reading memory.  A block
+    // spans 32 contiguous addresses, so it touches at most two pages.
+    int blocks_x = std::max(width >> 2, 1);
+    int blocks_y = (height + 3) >> 2;
+
+    // Block rows that lie wholly inside the image and the model are
+    // de-tiled a page's worth of blocks at a time; only partial rows at
+    // the edges take the per-pixel path below.
+    constexpr int GROUP_BLOCKS = PAGE_WORDS / 32;
+
+    for (int by = 0; by < blocks_y; ++by) {
+        uint32_t row_base = base_word + ((static_cast<uint32_t>(by) << blocks_log2) << 5);
+        if (width >= 4 && (by << 2) + 4 <= height
+            && row_base + static_cast<uint32_t>(blocks_x) * 32 <= num_words_) {
+            uint16_t* rows = &fb[static_cast<size_t>(by) * 4 * width];
+            for (int bx = 0; bx < blocks_x; bx += GROUP_BLOCKS) {
+                int n = std::min(GROUP_BLOCKS, blocks_x - bx);
+                uint32_t first = row_base + static_cast<uint32_t>(bx) * 32;
+                uint32_t last = first + static_cast<uint32_t>(n) * 32 - 2;
+                if (page_touched(first) || page_touched(last)) {
+                    detile_block_row(mem_ + first, n, rows + bx * 4, static_cast<size_t>(width));
+                }
+            }
+            continue;
+        }
+        for (int bx = 0; bx < blocks_x; ++bx) {
+            uint32_t block_idx = (static_cast<uint32_t>(by) << blocks_log2) | static_cast<uint32_t>(bx);
+            uint32_t block_base = base_word + (block_idx << 5);  // 32 bytes per block
+            if (block_base >= num_words_) {
+                continue;
+            }
+            uint32_t block_last = std::min(block_base + 30, num_words_ - 1);
+            if (!page_touched(block_base) && !page_touched(block_last)) {
+                continue;
+            }
+            for (int local_y = 0; local_y < 4; ++local_y) {
+                int py = (by << 2) + local_y;
+                if (py >= height) {
+                    break;
+                }
+                for (int local_x = 0; local_x < 4; ++local_x) {
+                    int px = (bx << 2) + local_x;
+                    if (px >= width) {
+                        break;
+                    }
+                    uint32_t pixel_off = static_cast<uint32_t>(local_y * 4 + local_x) * 2;
+                    fb[py * width + px] = read_word(block_base + pixel_off);
+                }
+            }
         }
     }
 
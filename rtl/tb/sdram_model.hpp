@@ -10,8 +10,18 @@
 //
 // The model is a *behavioral* stub: it provides correct read/write
 // semantics without modeling SDRAM timing (ACTIVATE, CAS latency, etc.).
-// connect_sdram() in harness.cpp wraps this model with the SDRAM command
-// decoder and CAS-latency read pipeline that the SDRAM controller drives.
+//
+// Writes are tracked at page granularity (one page = one 512-word SDRAM
+// row).  Untouched pages are known to be zero, so diagnostics, readback
+// and checkpoints walk only touched pages (for_each_dirty_range()) and
+// their cost scales with the memory a test actually uses, not with the
+// 32 MB capacity.
+//
+// The model can instead be backed by a memory-mapped SDRAM image file
+// (sdram_image.hpp), to start from pre-staged data or to leave the final
+// SDRAM state in a file.  Pages holding data in the image start touched.
+// connect_sdram() (sdram_pins.hpp) wraps this model with the SDRAM command
+// decoder and CAS-latency delay line that the SDRAM controller drives.
 //
 // Texture-pipeline burst patterns served by this model (UNIT-011):
 //
@@ -38,12 +48,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <memory>
 #include <span>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
+#include "sdram_image.hpp"
+
 /// Texture format codes matching INT-014 TEXn_CFG.FORMAT field encoding.
 ///
 /// UNIT-011 currently supports INDEXED8_2X2 only.  RGB565 is retained for
@@ -79,6 +96,20 @@ public:
     /// @param num_words  Number of 16-bit words to allocate.
     explicit SdramModel(uint32_t num_words);
 
+    /// Construct a model backed by a memory-mapped SDRAM image file.
+    ///
+    /// @param num_words   Number of 16-bit words to map.
+    /// @param image_path  Image file (see SdramImage for the format).
+    /// @param mode        COPY_ON_WRITE (file is a preload) or SHARED
+    ///                    (writes land in the file).
+    /// @throws std::runtime_error if the image cannot be mapped.
+    SdramModel(uint32_t num_words, const std::string& image_path, SdramImageMode mode);
+
+    /// Backing image, or nullptr for an anonymous model.
+    const SdramImage* image() const {
+        return image_.get();
+    }
+
     /// Read a 16-bit word at the given word address.
     /// Returns 0 for out-of-range addresses.
     ///
@@ -200,11 +231,80 @@ public:
     std::vector<uint16_t>
     read_framebuffer(uint32_t base_word, int width_log2, int height) const;
 
+    /// Words per dirty-tracking page: one SDRAM row (column bits [8:0]).
+    static constexpr uint32_t PAGE_WORDS = 512;
+
     /// Return the total number of 16-bit words in the model.
     uint32_t size() const {
-        return static_cast<uint32_t>(mem_.size());
+        return num_words_;
+    }
+
+    /// Raw view of the backing store.  Pages never written read as zero.
+    std::span<const uint16_t> words() const {
+        return {mem_, num_words_};
+    }
+
+    /// Mutable view of [first_word, first_word + count), clamped to the
+    /// model size.  The covered pages are marked touched; used by
+    /// checkpoint restore to fill memory in place.
+    std::span<uint16_t> writable_range(uint32_t first_word, uint32_t count);
+
+    /// Return true if any word in the page containing word_addr has been
+    /// written.
+    bool page_touched(uint32_t word_addr) const {
+        uint32_t page = word_addr / PAGE_WORDS;
+        return (dirty_[page / 64] >> (page % 64)) & 1;
+    }
+
+    /// Number of pages written since construction.
+    uint32_t touched_pages() const;
+
+    /// Call `fn(first_word, words)` for each maximal run of consecutive
+    /// touched pages, in ascending address order.  `words` is a
+    /// std::span<const uint16_t> covering the run (the last run is clamped
+    /// to size()).  Every word outside the reported runs is zero.
+    template <typename Fn>
+    void for_each_dirty_range(Fn&& fn) const {
+        uint32_t num_pages = (num_words_ + PAGE_WORDS - 1) / PAGE_WORDS;
+        uint32_t page = 0;
+        while (page < num_pages) {
+            // Skip clean pages 64 at a time.
+            uint64_t bits = dirty_[page / 64] >> (page % 64);
+            if (bits == 0) {
+                page = (page / 64 + 1) * 64;
+                continue;
+            }
+            page += static_cast<uint32_t>(std::countr_zero(bits));
+            uint32_t first = page;
+            while (page < num_pages && page_touched(page * PAGE_WORDS)) {
+                page++;
+            }
+            uint32_t first_word = first * PAGE_WORDS;
+            uint32_t end_word = std::min(page * PAGE_WORDS, num_words_);
+            fn(first_word, words().subspan(first_word, end_word - first_word));
+        }
     }
 
 private:
-    std::vector<uint16_t> mem_;
+    /// Frees storage obtained from std::calloc().
+    struct FreeDeleter {
+        void operator()(uint16_t* p) const {
+            std::free(p);
+        }
+    };
+
+    /// Mark the page containing word_addr as touched.
+    void mark_page(uint32_t word_addr) {
+        uint32_t page = word_addr / PAGE_WORDS;
+        dirty_[page / 64] |= uint64_t{1} << (page % 64);
+    }
+
+    uint32_t num_words_;
+    /// calloc'd so the OS supplies zero pages lazily: construction does not
+    /// touch all 32 MB, and pages never written are never faulted in.
+    /// Null when image_ backs the model.
+    std::unique_ptr<uint16_t[], FreeDeleter> owned_;
+    std::unique_ptr<SdramImage> image_; ///< Mapped image file, if any
+    uint16_t* mem_;                     ///< owned_ or image_ storage
+    std::vector<uint64_t> dirty_; ///< One bit per PAGE_WORDS-word page
 };
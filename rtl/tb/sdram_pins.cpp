@@ -0,0 +1,82 @@
+// Pin-level SDRAM adapter implementation.
+//
+// See sdram_pins.hpp for the delay-line scheme and the connect_sdram()
+// glue that applies each SdramBusOp to a memory model.
+//
+// References:
+//   INT-011 (SDRAM Memory Layout)
+
+#include "sdram_pins.hpp"
+
+SdramBusOp SdramPinAdapter::clock(const SdramPins& pins) {
+    SdramBusOp op;
+
+    // Step 1: Pop the read maturing this cycle (at most one: the
+    // controller issues at most one READ per cycle and the latency is
+    // fixed).
+    DelaySlot& due = delay_[cycle_ & (DELAY_SLOTS - 1)];
+    if (due != 0) {
+        op.read = true;
+        op.read_addr = due - 1;
+        due = 0;
+    }
+
+    // Step 2: Decode the current-cycle command.
+    switch (pins.cmd) {
+        case SDRAM_CMD_ACTIVATE: {
+            // A[12:0] = row address
+            banks_[pins.ba].row_active = true;
+            banks_[pins.ba].active_row = pins.a;
+            activate_count++;
+            break;
+        }
+
+        case SDRAM_CMD_READ: {
+            // Column address is A[8:0] on the READ command.  The controller
+            // already decomposes byte addresses (bank = addr[23:22],
+            // row = addr[21:9], col = addr[8:1]), so reconstruct the flat
+            // word address that indexes the 16-bit word array.
+            uint32_t col = pins.a & 0x1FF;
+            uint32_t row = banks_[pins.ba].active_row;
+            uint32_t word_addr = (static_cast<uint32_t>(pins.ba) << 23) | (row << 9) | col;
+            delay_[(cycle_ + CAS_DELAY) & (DELAY_SLOTS - 1)] = word_addr + 1;
+            read_count++;
+            break;
+        }
+
+        case SDRAM_CMD_WRITE: {
+            // SDRAM captures write data on the same cycle as the WRITE
+            // command.
+            uint32_t col = pins.a & 0x1FF;
+            uint32_t row = banks_[pins.ba].active_row;
+            op.write = true;
+            op.write_addr = (static_cast<uint32_t>(pins.ba) << 23) | (row << 9) | col;
+            op.write_data = pins.dq_out;
+            op.write_dqm = pins.dqm;
+            write_count++;
+            break;
+        }
+
+        case SDRAM_CMD_PRECHARGE: {
+            // Close row(s). A10=1 means all banks, A10=0 means selected bank.
+            if (pins.a & (1 << 10)) {
+                for (auto& b : banks_) {
+                    b.row_active = false;
+                }
+            } else {
+                banks_[pins.ba].row_active = false;
+            }
+            break;
+        }
+
+        case SDRAM_CMD_NOP:
+        case SDRAM_CMD_AUTO_REFRESH:
+        case SDRAM_CMD_LOAD_MODE:
+        default:
+            // No action needed for the behavioral model
+            break;
+    }
+
+    cycle_++;
+    return op;
+}
@@ -0,0 +1,161 @@
+// Pin-level SDRAM adapter shared by the integration harness
+// (rtl/tb/harness.cpp) and the interactive simulator
+// (integration/sim/gpu_sim.cpp).
+//
+// The SDRAM controller in gpu_top drives physical SDRAM pins (csn, rasn,
+// casn, wen, ba, a, dq, dqm).  SdramPinAdapter decodes the command on
+// those pins each clock, tracks the open row per bank, and models the
+// CAS latency with a fixed-latency ring-indexed delay line: a READ
+// schedules its word address CAS_DELAY cycles ahead, and each cycle
+// pops exactly one slot, so per-cycle cost is O(1) regardless of how
+// many reads are in flight.
+//
+// The adapter does not own memory.  connect_sdram() below samples the
+// Verilated model's pins, clocks the adapter, applies the resulting
+// read/write to any memory type exposing read_word()/write_word()
+// (SdramModel, SdramModelSim), and drives sdram_dq.
+//
+// With --pins-inout-enables, Verilator splits the inout sdram_dq port into:
+//   sdram_dq      -- input  (testbench drives read data to controller)
+//   sdram_dq__out -- output (controller drives write data)
+//   sdram_dq__en  -- output enable (1 = controller driving)
+//
+// References:
+//   INT-011 (SDRAM Memory Layout)
+//   UNIT-007 (Memory Arbiter) -- sdram_controller.sv command encoding
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// SDRAM command encoding: {csn, rasn, casn, wen}
+// Matches sdram_controller.sv localparam definitions.
+inline constexpr uint8_t SDRAM_CMD_NOP = 0b0111;
+inline constexpr uint8_t SDRAM_CMD_ACTIVATE = 0b0011;
+inline constexpr uint8_t SDRAM_CMD_READ = 0b0101;
+inline constexpr uint8_t SDRAM_CMD_WRITE = 0b0100;
+inline constexpr uint8_t SDRAM_CMD_PRECHARGE = 0b0010;
+inline constexpr uint8_t SDRAM_CMD_AUTO_REFRESH = 0b0001;
+inline constexpr uint8_t SDRAM_CMD_LOAD_MODE = 0b0000;
+
+/// Number of SDRAM banks.
+inline constexpr int SDRAM_BANK_COUNT = 4;
+
+/// CAS latency (CL=3, matching sdram_controller.sv).
+inline constexpr int CAS_LATENCY = 3;
+
+/// Controller pin values sampled after the rising-edge eval.
+struct SdramPins {
+    uint8_t cmd = SDRAM_CMD_NOP; ///< {csn, rasn, casn, wen}
+    uint8_t ba = 0;              ///< Bank address (2 bits)
+    uint16_t a = 0;              ///< Address bus (13 bits)
+    uint16_t dq_out = 0;         ///< Write data driven by the controller
+    uint8_t dqm = 0;             ///< Byte mask (1 = byte masked)
+};
+
+/// Memory operation requested by one clocked cycle of the adapter.
+struct SdramBusOp {
+    bool read = false;       ///< A READ matured: drive read_word(read_addr) onto dq
+    uint32_t read_addr = 0;  ///< Word address of the matured read
+    bool write = false;      ///< A WRITE was issued this cycle
+    uint32_t write_addr = 0; ///< Word address of the write
+    uint16_t write_data = 0; ///< Data on dq_out
+    uint8_t write_dqm = 0;   ///< DQM[1] masks the upper byte, DQM[0] the lower
+};
+
+/// Per-bank active row tracking.
+struct SdramBankState {
+    bool row_active = false; ///< Whether a row is currently activated
+    uint32_t active_row = 0; ///< Row address of the activated row (13 bits)
+};
+
+/// Pin-level SDRAM command decoder with a CAS-latency delay line.
+///
+/// Trivially copyable so checkpoints can store it as raw bytes.
+class SdramPinAdapter {
+public:
+    /// Cycles between the call that sees a READ and the call that drives
+    /// its data.  CAS_LATENCY - 1 because connect_sdram() runs AFTER
+    /// tick(): data driven after cycle N is sampled by the RTL on cycle
+    /// N+1's rising edge, so one cycle of the latency is already implied.
+    static constexpr int CAS_DELAY = CAS_LATENCY - 1;
+
+    /// Delay-line length (power of two > CAS_DELAY).
+    static constexpr int DELAY_SLOTS = 4;
+    static_assert(DELAY_SLOTS > CAS_DELAY && (DELAY_SLOTS & (DELAY_SLOTS - 1)) == 0);
+
+    /// Clock the adapter for one cycle.
+    ///
+    /// Pops the read (if any) maturing this cycle, then decodes `pins`:
+    /// ACTIVATE opens a row, READ schedules a read CAS_DELAY cycles ahead,
+    /// WRITE is reported for immediate application, PRECHARGE closes rows.
+    ///
+    /// Word address from SDRAM signals: (bank << 23) | (row << 9) | column.
+    SdramBusOp clock(const SdramPins& pins);
+
+    /// Merge a masked write into the existing word (DQM=1 keeps the byte).
+    static uint16_t apply_dqm(uint16_t existing, uint16_t wdata, uint8_t dqm) {
+        if (!(dqm & 0x01)) {
+            existing = (existing & 0xFF00) | (wdata & 0x00FF);
+        }
+        if (!(dqm & 0x02)) {
+            existing = (existing & 0x00FF) | (wdata & 0xFF00);
+        }
+        return existing;
+    }
+
+    /// Open-row state for one bank.
+    const SdramBankState& bank(int b) const {
+        return banks_[b];
+    }
+
+    uint64_t activate_count = 0; ///< Diagnostic: total ACTIVATEs
+    uint64_t write_count = 0;    ///< Diagnostic: total WRITEs
+    uint64_t read_count = 0;     ///< Diagnostic: total READs
+
+private:
+    /// One delay-line slot: word address + 1, or 0 when empty.
+    using DelaySlot = uint32_t;
+
+    std::array<SdramBankState, SDRAM_BANK_COUNT> banks_{};
+    std::array<DelaySlot, DELAY_SLOTS> delay_{};
+    uint32_t cycle_ = 0; ///< Ring index; slot cycle_ % DELAY_SLOTS matures now
+};
+
+/// Sample the controller's SDRAM pins from the Verilated top (Vgpu_top).
+template <typename Top>
+inline SdramPins sample_sdram_pins(const Top* top) {
+    SdramPins pins;
+    pins.cmd = static_cast<uint8_t>(
+        ((top->sdram_csn & 1) << 3) | ((top->sdram_rasn & 1) << 2) | ((top->sdram_casn & 1) << 1)
+        | (top->sdram_wen & 1)
+    );
+    pins.ba = static_cast<uint8_t>(top->sdram_ba & 0x3);
+    pins.a = static_cast<uint16_t>(top->sdram_a & 0x1FFF);
+    pins.dq_out = static_cast<uint16_t>(top->sdram_dq__out & 0xFFFF);
+    pins.dqm = static_cast<uint8_t>(top->sdram_dqm & 0x3);
+    return pins;
+}
+
+/// Connect a memory model to the Verilated model's physical SDRAM pins.
+///
+/// Called once per clock cycle, after tick().  `Top` is the Verilated top
+/// (Vgpu_top); `Memory` provides read_word(addr) and write_word(addr, data).
+template <typename Top, typename Memory>
+inline void connect_sdram(Top* top, Memory& mem, SdramPinAdapter& adapter) {
+    SdramBusOp op = adapter.clock(sample_sdram_pins(top));
+
+    top->sdram_dq = op.read ? mem.read_word(op.read_addr) : 0;
+
+    if (op.write) {
+        if (op.write_dqm == 0) {
+            mem.write_word(op.write_addr, op.write_data);
+        } else {
+            mem.write_word(
+                op.write_addr,
+                SdramPinAdapter::apply_dqm(mem.read_word(op.write_addr), op.write_data, op.write_dqm)
+            );
+        }
+    }
+}
@@ -0,0 +1,102 @@
+// Header-only helpers for simulation checkpoint files.
+//
+// A checkpoint captures everything needed to resume a Verilator run
+// without re-simulating reset and the SDRAM power-up sequence:
+//
+//   - A small header (magic, sim_time, resume phase index, test name).
+//   - The SDRAM pin-adapter state (SdramPinAdapter: open rows, CAS
+//     delay line), written as raw bytes.
+//   - The SDRAM model contents (format owned by the caller).
+//   - The Verilated model itself (requires a --savable build).
+//
+// Shared by the integration harness (rtl/tb/harness.cpp) and the
+// interactive simulator (integration/sim/gpu_sim.cpp).  Both write the
+// same header; each writes its own SDRAM model contents before the
+// Verilated model.
+//
+// A checkpoint is only valid for the binary that wrote it: Verilator's
+// serialized model layout changes with every RTL rebuild.  The Makefile
+// regenerates checkpoints whenever the simulator binary is rebuilt.
+
+#ifndef SIM_CHECKPOINT_HPP
+#define SIM_CHECKPOINT_HPP
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "verilated_save.h"
+
+namespace sim_checkpoint {
+
+/// File magic; bump the trailing digit when the file layout changes.
+inline constexpr std::array<char, 8> MAGIC = {'P', 'G', 'S', 'C', 'K', 'P', 'T', '4'};
+
+/// Checkpoint header written ahead of the model state.
+struct Header {
+    uint64_t sim_time = 0;   ///< Harness sim_time (two units per clock)
+    uint64_t next_phase = 0; ///< Index of the first script phase to run on restore
+    std::string test_name;   ///< Empty for a post-init checkpoint (valid for any test)
+    std::string phase_name;  ///< Name of phases[next_phase], for validation
+};
+
+/// Write a trivially-copyable value as raw bytes.
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+inline void write_pod(VerilatedSerialize& os, const T& value) {
+    os.write(&value, sizeof(value));
+}
+
+/// Read a trivially-copyable value written by write_pod().
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+inline void read_pod(VerilatedDeserialize& is, T& value) {
+    is.read(&value, sizeof(value));
+}
+
+/// Write a length-prefixed string.
+inline void write_string(VerilatedSerialize& os, const std::string& s) {
+    write_pod(os, static_cast<uint64_t>(s.size()));
+    os.write(s.data(), s.size());
+}
+
+/// Read a length-prefixed string written by write_string().
+inline std::string read_string(VerilatedDeserialize& is) {
+    uint64_t len = 0;
+    read_pod(is, len);
+    std::string s(len, '\0');
+    is.read(s.data(), len);
+    return s;
+}
+
+/// Write the magic and header fields.
+inline void write_header(VerilatedSerialize& os, const Header& h) {
+    os.write(MAGIC.data(), MAGIC.size());
+    write_pod(os, h.sim_time);
+    write_pod(os, h.next_phase);
+    write_string(os, h.test_name);
+    write_string(os, h.phase_name);
+}
+
+/// Read and validate the magic, then read the header fields.
+/// Throws std::runtime_error if the file is not a checkpoint of this
+/// format version.
+inline Header read_header(VerilatedDeserialize& is) {
+    std::array<char, 8> magic{};
+    is.read(magic.data(), magic.size());
+    if (magic != MAGIC) {
+        throw std::runtime_error("not a pico-gs checkpoint (bad magic)");
+    }
+    Header h;
+    read_pod(is, h.sim_time);
+    read_pod(is, h.next_phase);
+    h.test_name = read_string(is);
+    h.phase_name = read_string(is);
+    return h;
+}
+
+} // namespace sim_checkpoint
+
+#endif // SIM_CHECKPOINT_HPP
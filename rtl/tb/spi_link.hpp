@@ -0,0 +1,106 @@
+// Header-only SPI link bit-banger for the harness_spi build variant.
+//
+// The regular harness injects register writes through SIM_DIRECT_REG and
+// gpu_sim through SIM_DIRECT_CMD, so neither exercises spi_slave.sv or the
+// async_fifo-based command_fifo.sv, and neither can show how the host link
+// limits frame rate.  SpiLink generates the pin levels the RP2350 drives
+// for each write, one core cycle at a time:
+//
+//   * SPI mode 0: MOSI changes while SCK is low, spi_slave samples it on
+//     the rising edge.  72 bits per write ({rw, addr[6:0], data[63:0]},
+//     MSB first), i.e. the 9 bytes of rp2350_vertex_throughput.md.
+//   * One SCK period is `sck_ratio` core cycles: 4 models the 25 MHz link
+//     against the 100 MHz core clock.  SCK is low for sck_ratio / 2
+//     cycles and high for the rest.
+//   * After the last bit CS stays low for SPI_CDC_HOLD cycles, so the
+//     spi_slave synchronizer sees transaction_done before CS deassertion
+//     clears it, then stays high for one SCK period between writes.
+//
+// The host must not start a write while gpio_cmd_full (the command FIFO's
+// almost-full flag) is set; the harness checks it before each begin().
+
+#ifndef SPI_LINK_HPP
+#define SPI_LINK_HPP
+
+#include <algorithm>
+#include <cstdint>
+
+#include "hex_parser.hpp"
+
+/// Core cycles CS is held low after the last rising SCK edge.  Covers
+/// spi_slave's three-stage transaction_done synchronizer.
+inline constexpr unsigned SPI_CDC_HOLD = 4;
+
+/// Bits per register write on the link (R/W, 7-bit address, 64-bit data).
+inline constexpr unsigned SPI_WRITE_BITS = 72;
+
+/// SPI pin levels for one core cycle.
+struct SpiPins {
+    bool cs_n = true;
+    bool sck = false;
+    bool mosi = false;
+};
+
+/// Cycle accounting for the link (harness_spi only).
+struct SpiLinkStats {
+    uint64_t writes = 0;        ///< Register writes sent
+    uint64_t link_cycles = 0;   ///< Cycles with a write on the wire (CS gap included)
+    uint64_t full_cycles = 0;   ///< Cycles the host waited on gpio_cmd_full
+    uint64_t starved_cycles = 0; ///< Script cycles the GPU sat idle on an empty FIFO
+    uint64_t script_cycles = 0; ///< All cycles spent injecting scripts
+};
+
+/// Serializes one register write at a time into per-cycle SPI pin levels.
+class SpiLink {
+public:
+    /// @param sck_ratio  Core cycles per SCK period (>= 2).
+    explicit SpiLink(unsigned sck_ratio = 4)
+        : low_(std::max(sck_ratio, 2u) / 2),
+          period_(std::max(sck_ratio, 2u)) {}
+
+    /// Core cycles one write occupies the link, CS gap included.
+    unsigned cycles_per_write() const {
+        return SPI_WRITE_BITS * period_ + std::max(SPI_CDC_HOLD, low_) + period_;
+    }
+
+    /// Start sending `w` (a write: bit 71 = 0).
+    void begin(const HexRegWrite& w) {
+        addr_ = w.addr & 0x7F;
+        data_ = w.data;
+        cycle_ = 0;
+    }
+
+    /// True once every cycle of the current write has been produced.
+    bool done() const {
+        return cycle_ >= cycles_per_write();
+    }
+
+    /// Pin levels for the next core cycle of the current write.
+    SpiPins next() {
+        unsigned c = cycle_++;
+        unsigned bit = c / period_;
+        if (bit < SPI_WRITE_BITS) {
+            return {false, c % period_ >= low_, frame_bit(SPI_WRITE_BITS - 1 - bit)};
+        }
+        // CDC hold with CS low, then the CS-high gap before the next write.
+        unsigned tail = c - SPI_WRITE_BITS * period_;
+        return {tail >= std::max(SPI_CDC_HOLD, low_), false, false};
+    }
+
+private:
+    /// Bit `i` of the 72-bit frame {rw = 0, addr[6:0], data[63:0]}.
+    bool frame_bit(unsigned i) const {
+        if (i < 64) {
+            return (data_ >> i) & 1;
+        }
+        return i < 71 && ((addr_ >> (i - 64)) & 1);
+    }
+
+    unsigned low_;
+    unsigned period_;
+    uint8_t addr_ = 0;
+    uint64_t data_ = 0;
+    unsigned cycle_ = 0;
+};
+
+#endif // SPI_LINK_HPP
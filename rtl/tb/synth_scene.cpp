@@ -0,0 +1,394 @@
+// Procedural stress-scene generator implementation.
+//
+// See synth_scene.hpp for the scene kinds.  Register encodings follow
+// INT-010 and the packing helpers in integration/scripts/gen/common.py.
+
+#include "synth_scene.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <stdexcept>
+#include <vector>
+
+#include "fast_upload.hpp"
+
+namespace {
+
+// INT-010 register addresses (MEM_FILL / MEM_ADDR / MEM_DATA come from
+// fast_upload.hpp).
+constexpr uint8_t REG_COLOR = 0x00;
+constexpr uint8_t REG_ST0_ST1 = 0x01;
+constexpr uint8_t REG_VERTEX_NOKICK = 0x06;
+constexpr uint8_t REG_VERTEX_KICK_012 = 0x07;
+constexpr uint8_t REG_VERTEX_KICK_021 = 0x08;
+constexpr uint8_t REG_TEX0_CFG = 0x10;
+constexpr uint8_t REG_PALETTE0 = 0x12;
+constexpr uint8_t REG_CC_MODE = 0x18;
+constexpr uint8_t REG_CC_MODE_2 = 0x1A;
+constexpr uint8_t REG_RENDER_MODE = 0x30;
+constexpr uint8_t REG_FB_CONFIG = 0x40;
+constexpr uint8_t REG_FB_CONTROL = 0x43;
+constexpr uint8_t REG_FB_CACHE_CTRL = 0x45;
+
+// RENDER_MODE bits.
+constexpr uint64_t GOURAUD_EN = 1 << 0;
+constexpr uint64_t Z_TEST_EN = 1 << 2;
+constexpr uint64_t Z_WRITE_EN = 1 << 3;
+constexpr uint64_t COLOR_WRITE_EN = 1 << 4;
+constexpr uint64_t Z_COMPARE_GEQUAL = 3 << 13;
+
+// Combiner presets (common.py).
+constexpr uint64_t CC_MODE_SHADE_PASSTHROUGH = 0x7670'7670'7673'7673;
+constexpr uint64_t CC_MODE_MODULATE = 0x7670'7670'7371'7371;
+constexpr uint64_t CC_MODE_2_DISABLED = 0x7670'7670;
+constexpr uint64_t CC_MODE_2_BLEND = 0x7670'9C90;
+
+/// Q for affine texturing (1.0 in UQ1.15).
+constexpr uint16_t Q_AFFINE = 0x8000;
+
+// 512x512 RGB565 color buffer at word 0, Z buffer at 0x0800 x 512 B
+// (word 0x80000), as in VER-011 / VER-014.
+constexpr int FB_LOG2 = 9;
+constexpr int FB_SIZE = 1 << FB_LOG2;
+constexpr uint32_t Z_BASE_512 = 0x0800;
+
+// texture_thrash: 256x256 apparent INDEXED8_2X2 texture (128x128 index
+// bytes) at 0x0C00 x 512 B and its palette at 0x0880 x 512 B, the
+// addresses VER-014 uses.
+constexpr int TEX_LOG2 = 8;
+constexpr uint32_t TEX_BASE_512 = 0x0C00;
+constexpr uint32_t PALETTE_BASE_512 = 0x0880;
+constexpr uint32_t PALETTE_DWORDS = 4096 / 8;
+constexpr uint32_t INDEX_DWORDS = (1u << (TEX_LOG2 - 1)) * (1u << (TEX_LOG2 - 1)) / 8;
+
+constexpr std::array<std::string_view, 6> KIND_NAMES = {
+    "tiny_tris", "overdraw_blend", "texture_thrash", "hiz_sorted", "hiz_reverse", "strips",
+};
+
+/// SplitMix64: small, fast and identical on every platform, unlike the
+/// <random> distributions.
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state_(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state_ += 0x9E37'79B9'7F4A'7C15);
+        z = (z ^ (z >> 30)) * 0xBF58'476D'1CE4'E5B9;
+        z = (z ^ (z >> 27)) * 0x94D0'49BB'1331'11EB;
+        return z ^ (z >> 31);
+    }
+
+    /// Uniform integer in [lo, hi].
+    int range(int lo, int hi) {
+        return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+    /// Uniform real in [lo, hi).
+    double real(double lo, double hi) {
+        return lo + (hi - lo) * static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    /// Random RGB with the given alpha, as RGBA8888.
+    uint32_t rgba(uint8_t alpha) {
+        return static_cast<uint32_t>(next() & 0xFFFF'FF00) | alpha;
+    }
+
+private:
+    uint64_t state_;
+};
+
+/// VERTEX data: Q12.4 X/Y, 16-bit Z, UQ1.15 Q.
+uint64_t pack_vertex(int x_q4, int y_q4, uint16_t z, uint16_t q = 0) {
+    return static_cast<uint64_t>(q) << 48 | static_cast<uint64_t>(z) << 32
+        | static_cast<uint64_t>(y_q4 & 0xFFFF) << 16 | static_cast<uint64_t>(x_q4 & 0xFFFF);
+}
+
+/// COLOR data: diffuse RGBA8888 in [63:32], specular zero.
+uint64_t pack_color(uint32_t diffuse) {
+    return static_cast<uint64_t>(diffuse) << 32;
+}
+
+/// ST0_ST1 data: S0/T0 in Q4.12, ST1 zero.
+uint64_t pack_st(double s, double t) {
+    auto q4_12 = [](double v) {
+        return static_cast<uint64_t>(static_cast<int>(v * 4096.0) & 0xFFFF);
+    };
+    return q4_12(t) << 16 | q4_12(s);
+}
+
+uint64_t pack_mem_fill(uint32_t base_word, uint16_t value, uint32_t count) {
+    return static_cast<uint64_t>(count & 0xFFFFF) << 40 | static_cast<uint64_t>(value) << 24
+        | (base_word & 0xFFFFFF);
+}
+
+/// Q12.4 position of pixel coordinate `px`.
+constexpr int q4(int px) {
+    return px * 16;
+}
+
+/// Accumulates phases and counts kicked triangles.
+class ScriptBuilder {
+public:
+    explicit ScriptBuilder(HexScript& script) : script_(script) {}
+
+    void phase(std::string name) {
+        script_.phases.push_back(HexPhase{std::move(name), {}});
+    }
+
+    void write(uint8_t addr, uint64_t data) {
+        script_.phases.back().commands.push_back(HexRegWrite{addr, data});
+        triangles_ += addr == REG_VERTEX_KICK_012 || addr == REG_VERTEX_KICK_021;
+    }
+
+    /// Independent triangle: NOKICK, NOKICK, KICK_012 (vertex ring stays aligned).
+    void triangle(const std::array<uint64_t, 3>& v, const std::array<uint32_t, 3>& color) {
+        for (size_t i = 0; i < 3; i++) {
+            write(REG_COLOR, pack_color(color[i]));
+            write(i < 2 ? REG_VERTEX_NOKICK : REG_VERTEX_KICK_012, v[i]);
+        }
+    }
+
+    /// Axis-aligned quad as two triangles, one flat color.
+    void quad(int x0, int y0, int x1, int y1, uint16_t z, uint32_t color) {
+        triangle({pack_vertex(q4(x0), q4(y0), z), pack_vertex(q4(x1), q4(y0), z),
+                  pack_vertex(q4(x1), q4(y1), z)},
+                 {color, color, color});
+        triangle({pack_vertex(q4(x0), q4(y0), z), pack_vertex(q4(x1), q4(y1), z),
+                  pack_vertex(q4(x0), q4(y1), z)},
+                 {color, color, color});
+    }
+
+    uint64_t triangles() const {
+        return triangles_;
+    }
+
+private:
+    HexScript& script_;
+    uint64_t triangles_ = 0;
+};
+
+/// Random rectangle at least `min` pixels on a side inside the framebuffer.
+std::array<int, 4> random_rect(Rng& rng, int min) {
+    int w = rng.range(min, FB_SIZE);
+    int h = rng.range(min, FB_SIZE);
+    int x = rng.range(0, FB_SIZE - w);
+    int y = rng.range(0, FB_SIZE - h);
+    return {x, y, x + w, y + h};
+}
+
+/// Clear, framebuffer and combiner state common to every scene.
+void emit_setup(ScriptBuilder& b, bool depth) {
+    b.phase("setup");
+    b.write(REG_MEM_FILL, pack_mem_fill(0, 0x0000, FB_SIZE * FB_SIZE));
+    b.write(REG_FB_CONFIG, static_cast<uint64_t>(FB_LOG2) << 36
+                               | static_cast<uint64_t>(FB_LOG2) << 32
+                               | (depth ? Z_BASE_512 : 0) << 16);
+    // FB_CONTROL scissor: x=0 y=0 w=512 h=512.
+    b.write(REG_FB_CONTROL, static_cast<uint64_t>(FB_SIZE) << 30
+                                | static_cast<uint64_t>(FB_SIZE) << 20);
+    b.write(REG_CC_MODE, CC_MODE_SHADE_PASSTHROUGH);
+    b.write(REG_CC_MODE_2, CC_MODE_2_DISABLED);
+    b.write(REG_RENDER_MODE, GOURAUD_EN | COLOR_WRITE_EN);
+}
+
+std::string gen_tiny_tris(ScriptBuilder& b, Rng& rng, uint32_t count) {
+    count = count ? count : 4096;
+    emit_setup(b, false);
+    b.phase("draw");
+    for (uint32_t i = 0; i < count; i++) {
+        // Anchor anywhere on screen, the other two vertices 1-4 px away at
+        // sub-pixel positions, so coverage ranges from zero to a few pixels.
+        // One draw per statement: argument evaluation order is unspecified
+        // and the stream must not depend on the compiler.
+        int x = rng.range(0, q4(FB_SIZE - 5));
+        int y = rng.range(0, q4(FB_SIZE - 5));
+        int x1 = x + rng.range(q4(1), q4(4));
+        int y1 = y + rng.range(0, q4(2));
+        int x2 = x + rng.range(0, q4(2));
+        int y2 = y + rng.range(q4(1), q4(4));
+        std::array<uint32_t, 3> colors = {rng.rgba(0xFF), rng.rgba(0xFF), rng.rgba(0xFF)};
+        b.triangle({pack_vertex(x, y, 0), pack_vertex(x1, y1, 0), pack_vertex(x2, y2, 0)},
+                   colors);
+    }
+    return std::format("{} triangles of 1-4 px", count);
+}
+
+std::string gen_overdraw_blend(ScriptBuilder& b, Rng& rng, uint32_t count) {
+    count = count ? count : 16;
+    emit_setup(b, false);
+    b.write(REG_CC_MODE_2, CC_MODE_2_BLEND);
+    b.phase("draw");
+    for (uint32_t i = 0; i < count; i++) {
+        auto [x0, y0, x1, y1] = random_rect(rng, FB_SIZE / 2);
+        auto alpha = static_cast<uint8_t>(rng.range(0x40, 0xC0));
+        b.quad(x0, y0, x1, y1, 0, rng.rgba(alpha));
+    }
+    return std::format("{} blended quads of at least {}x{} px", count, FB_SIZE / 2, FB_SIZE / 2);
+}
+
+std::string gen_texture_thrash(ScriptBuilder& b, Rng& rng, uint32_t count) {
+    count = count ? count : 8;
+    emit_setup(b, false);
+
+    // Random palette (256 entries of four RGBA8888 quadrant colors) and
+    // random indices, uploaded before the load trigger and TEX0_CFG write.
+    b.write(REG_MEM_ADDR, PALETTE_BASE_512 * 512 / 8);
+    for (uint32_t i = 0; i < PALETTE_DWORDS; i++) {
+        b.write(REG_MEM_DATA, rng.next() | 0xFF000000'FF000000);
+    }
+    b.write(REG_PALETTE0, PALETTE_BASE_512 | 1u << 16);
+    b.write(REG_MEM_ADDR, TEX_BASE_512 * 512 / 8);
+    for (uint32_t i = 0; i < INDEX_DWORDS; i++) {
+        b.write(REG_MEM_DATA, rng.next());
+    }
+    // ENABLE, NEAREST, INDEXED8_2X2, 256x256, REPEAT, PALETTE_IDX 0.
+    b.write(REG_TEX0_CFG, static_cast<uint64_t>(TEX_BASE_512) << 32 | TEX_LOG2 << 12
+                              | TEX_LOG2 << 8 | 1);
+    b.write(REG_CC_MODE, CC_MODE_MODULATE);
+    b.write(REG_RENDER_MODE, COLOR_WRITE_EN);
+
+    // ST changes by up to ~3.5 texture widths per quad edge in each
+    // direction (staying inside Q4.12's +/-8): on a 256 px quad that is
+    // up to ~5 apparent texels per pixel, so a 4x4 index block (8x8
+    // texels) lasts one or two fragments and each fragment row sweeps
+    // far more blocks than the index cache holds.
+    b.phase("draw");
+    constexpr uint32_t WHITE = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < count; i++) {
+        auto [x0, y0, x1, y1] = random_rect(rng, FB_SIZE / 2);
+        double s0 = rng.real(0.0, 1.0);
+        double t0 = rng.real(0.0, 1.0);
+        double dsx = rng.real(-3.45, 3.45);
+        double dtx = rng.real(-3.45, 3.45);
+        double dsy = rng.real(-3.45, 3.45);
+        double dty = rng.real(-3.45, 3.45);
+        auto corner = [&](int x, int y, uint8_t reg, double u, double v) {
+            b.write(REG_COLOR, pack_color(WHITE));
+            b.write(REG_ST0_ST1, pack_st(s0 + u * dsx + v * dsy, t0 + u * dtx + v * dty));
+            b.write(reg, pack_vertex(q4(x), q4(y), 0, Q_AFFINE));
+        };
+        corner(x0, y0, REG_VERTEX_NOKICK, 0, 0);
+        corner(x1, y0, REG_VERTEX_NOKICK, 1, 0);
+        corner(x1, y1, REG_VERTEX_KICK_012, 1, 1);
+        corner(x0, y0, REG_VERTEX_NOKICK, 0, 0);
+        corner(x1, y1, REG_VERTEX_NOKICK, 1, 1);
+        corner(x0, y1, REG_VERTEX_KICK_012, 0, 1);
+    }
+    return std::format("{} textured quads, 256x256 INDEXED8_2X2, up to ~5 texels/px", count);
+}
+
+std::string gen_hiz(ScriptBuilder& b, Rng& rng, uint32_t count, bool nearest_first) {
+    count = count ? count : 16;
+    emit_setup(b, true);
+    b.write(REG_RENDER_MODE, GOURAUD_EN | Z_TEST_EN | Z_WRITE_EN | COLOR_WRITE_EN
+                                 | Z_COMPARE_GEQUAL);
+
+    // Both kinds draw the same layers for a given seed; only the order
+    // differs.  Reverse-Z: a larger Z is nearer.
+    struct Layer {
+        std::array<int, 4> rect;
+        uint16_t z;
+        uint32_t color;
+    };
+    std::vector<Layer> layers;
+    for (uint32_t i = 0; i < count; i++) {
+        layers.push_back({random_rect(rng, FB_SIZE / 2),
+                          static_cast<uint16_t>(rng.range(0x1000, 0xF000)), rng.rgba(0xFF)});
+    }
+    std::ranges::sort(layers, [&](const Layer& a, const Layer& c) {
+        return nearest_first ? a.z > c.z : a.z < c.z;
+    });
+
+    b.phase("draw");
+    for (const auto& l : layers) {
+        b.quad(l.rect[0], l.rect[1], l.rect[2], l.rect[3], l.z, l.color);
+    }
+    return std::format(
+        "{} Z-tested quads of at least {}x{} px, {} first", count, FB_SIZE / 2, FB_SIZE / 2,
+        nearest_first ? "nearest" : "farthest");
+}
+
+std::string gen_strips(ScriptBuilder& b, Rng& rng, uint32_t count) {
+    count = count ? count : 64;
+    // 64 triangles (66 vertices) per strip: a multiple of three vertices,
+    // so every strip starts with the vertex ring back at slot 0.
+    constexpr int TRIS_PER_STRIP = 64;
+    constexpr int VERTS = TRIS_PER_STRIP + 2;
+    constexpr int STEP = FB_SIZE / (VERTS / 2); // Pixels between columns
+    emit_setup(b, false);
+    b.phase("draw");
+    for (uint32_t s = 0; s < count; s++) {
+        int y = rng.range(0, FB_SIZE - 9);
+        int h = rng.range(2, 8);
+        // Zig-zag between the band's top and bottom edges; the first two
+        // vertices are buffered, then each one kicks a triangle with
+        // alternating winding (INT-010 strip sequence).
+        for (int i = 0; i < VERTS; i++) {
+            int x = q4((i / 2) * STEP) + rng.range(0, 15);
+            int vy = q4(y + (i % 2) * h);
+            uint8_t reg = i < 2 ? REG_VERTEX_NOKICK
+                                : (i % 2 == 0 ? REG_VERTEX_KICK_012 : REG_VERTEX_KICK_021);
+            b.write(REG_COLOR, pack_color(rng.rgba(0xFF)));
+            b.write(reg, pack_vertex(x, vy, 0));
+        }
+    }
+    return std::format("{} strips of {} triangles", count, TRIS_PER_STRIP);
+}
+
+} // namespace
+
+SynthKind parse_synth_kind(std::string_view name) {
+    auto it = std::ranges::find(KIND_NAMES, name);
+    if (it == KIND_NAMES.end()) {
+        std::string valid;
+        for (auto n : KIND_NAMES) {
+            valid += std::format("{}{}", valid.empty() ? "" : ", ", n);
+        }
+        throw std::invalid_argument(
+            std::format("unknown synth scene '{}' (expected one of {})", name, valid));
+    }
+    return static_cast<SynthKind>(it - KIND_NAMES.begin());
+}
+
+std::string_view synth_kind_name(SynthKind kind) {
+    return KIND_NAMES[static_cast<size_t>(kind)];
+}
+
+SynthScene synthesize_scene(const SynthParams& params) {
+    SynthScene scene;
+    scene.script.fb_width = FB_SIZE;
+    scene.script.fb_height = FB_SIZE;
+    ScriptBuilder b(scene.script);
+    Rng rng(params.seed);
+
+    std::string what;
+    switch (params.kind) {
+    case SynthKind::TINY_TRIS:
+        what = gen_tiny_tris(b, rng, params.count);
+        break;
+    case SynthKind::OVERDRAW_BLEND:
+        what = gen_overdraw_blend(b, rng, params.count);
+        break;
+    case SynthKind::TEXTURE_THRASH:
+        what = gen_texture_thrash(b, rng, params.count);
+        break;
+    case SynthKind::HIZ_SORTED:
+        what = gen_hiz(b, rng, params.count, true);
+        break;
+    case SynthKind::HIZ_REVERSE:
+        what = gen_hiz(b, rng, params.count, false);
+        break;
+    case SynthKind::STRIPS:
+        what = gen_strips(b, rng, params.count);
+        break;
+    }
+    scene.triangles = b.triangles();
+
+    b.phase("flush");
+    b.write(REG_FB_CACHE_CTRL, 1); // FLUSH_TRIGGER
+
+    scene.description =
+        std::format("{} seed {}: {}", synth_kind_name(params.kind), params.seed, what);
+    return scene;
+}
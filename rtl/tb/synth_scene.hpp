@@ -0,0 +1,65 @@
+// Procedural stress scenes for the harness (--synth <kind> --seed N).
+//
+// The VER scripts are small hand-authored or offline-generated scenes
+// that check pixels, not load.  synthesize_scene() builds a register
+// stream in memory, as a HexScript the harness runs like a parsed .hex
+// file, for one of these workloads:
+//
+//   tiny_tris       thousands of 1-4 px triangles (setup bound)
+//   overdraw_blend  stacked large quads with Porter-Duff BLEND through
+//                   CC_MODE_2 (DST_COLOR read-modify-write per fragment)
+//   texture_thrash  large INDEXED8_2X2 quads whose ST gradients step
+//                   across several 4x4 index blocks per pixel, so the
+//                   UNIT-011.03 index cache misses on almost every fetch
+//   hiz_sorted      the same stacked Z-tested quads drawn nearest first
+//   hiz_reverse     ... and farthest first (reverse-Z, GEQUAL), to compare
+//                   how much Hi-Z rejection saves
+//   strips          long triangle strips alternating VERTEX_KICK_012 and
+//                   VERTEX_KICK_021, two register writes per triangle
+//
+// Every scene renders into a 512x512 framebuffer in three phases:
+// "setup" (clear, state, texture upload), "draw" (the workload) and
+// "flush".  The same kind, seed and count always produce the same
+// stream.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "hex_parser.hpp"
+
+/// Procedural workload selected with --synth.
+enum class SynthKind {
+    TINY_TRIS,
+    OVERDRAW_BLEND,
+    TEXTURE_THRASH,
+    HIZ_SORTED,
+    HIZ_REVERSE,
+    STRIPS,
+};
+
+/// Parse a --synth argument.
+/// @throws std::invalid_argument for an unknown kind name.
+SynthKind parse_synth_kind(std::string_view name);
+
+/// The --synth name of `kind`.
+std::string_view synth_kind_name(SynthKind kind);
+
+/// Generator inputs.
+struct SynthParams {
+    SynthKind kind = SynthKind::TINY_TRIS;
+    uint32_t seed = 1;  ///< PRNG seed (--seed)
+    uint32_t count = 0; ///< Primitives (triangles, quads or strips); 0 = kind default
+};
+
+/// A generated scene and what its draw phase submits.
+struct SynthScene {
+    HexScript script;
+    uint64_t triangles = 0;  ///< Triangles kicked by one pass of the "draw" phase
+    std::string description; ///< One-line summary for the run log
+};
+
+/// Build the register stream for `params`.
+SynthScene synthesize_scene(const SynthParams& params);
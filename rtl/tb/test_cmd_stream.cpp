@@ -0,0 +1,141 @@
+// Unit tests for compiled binary command streams (cmd_stream.hpp).
+//
+// Verifies:
+//   1. compile_cmd_stream() -> CmdStream reproduces the parsed script:
+//      framebuffer size, phase names (including an empty phase) and
+//      every command in order.
+//   2. The loader rejects a bad magic, a truncated header, and record
+//      tables, phase entries or phase names that point past the file.
+//
+// Run by `make test-cmd-stream`; no Verilator model needed.
+
+#include "cmd_stream.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+static bool same_commands(std::span<const HexRegWrite> a, std::span<const HexRegWrite> b) {
+    return std::ranges::equal(a, b, [](const HexRegWrite& x, const HexRegWrite& y) {
+        return x.addr == y.addr && x.data == y.data;
+    });
+}
+
+static void write_bytes(const std::string& path, std::span<const uint8_t> bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+/// Removes the scratch stream file when a test returns.
+struct TempFile {
+    std::string path;
+    ~TempFile() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+/// Script with an empty phase and commands whose data uses every byte.
+static HexScript sample_script() {
+    return parse_hex_string(
+        "## FRAMEBUFFER: 640 480\n"
+        "## PHASE: setup\n"
+        "40 0000_0000_0000_0000\n"
+        "44 0000_1000_0000_0000\n"
+        "## PHASE: empty\n"
+        "## PHASE: draw\n"
+        "07 FFFF_0123_4567_89AB\n"
+        "7F 8000_0000_0000_0001\n"
+        "06 0000_0000_0000_0000\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 1: Round trip
+// -----------------------------------------------------------------------
+static void test_round_trip(TestResults& results) {
+    HexScript script = sample_script();
+    TempFile file{test_temp_path("cmd_stream.pgcmd")};
+    write_bytes(file.path, compile_cmd_stream(script));
+
+    TEST_ASSERT(results, is_cmd_stream(file.path), "Compiled stream recognised by is_cmd_stream");
+    CmdStream stream(file.path);
+    const ScriptView& got = stream.view();
+    ScriptView want = view_script(script);
+    TEST_ASSERT(results, got.fb_width == 640 && got.fb_height == 480, "Framebuffer size kept");
+    TEST_ASSERT_EQ(results, got.phases.size(), want.phases.size(), "Phase count");
+    for (size_t i = 0; i < std::min(got.phases.size(), want.phases.size()); i++) {
+        TEST_ASSERT(results, got.phases[i].name == want.phases[i].name, "Phase name kept");
+        TEST_ASSERT(results, same_commands(got.phases[i].commands, want.phases[i].commands),
+                    "Phase commands kept");
+    }
+    TEST_ASSERT_EQ(results, got.command_count(), size_t{5}, "Command count");
+    // '## TEXTURE:' directives are not carried (cmd_stream.hpp); a
+    // texture-free script must still map to no textures.
+    TEST_ASSERT(results, got.textures.empty() && want.textures.empty(), "No textures");
+
+    std::printf("  test_round_trip: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Loader bounds checks
+// -----------------------------------------------------------------------
+static void test_rejects_bad_files(TestResults& results) {
+    std::vector<uint8_t> bytes = compile_cmd_stream(sample_script());
+    TempFile file{test_temp_path("cmd_stream_bad.pgcmd")};
+
+    auto rejected = [&](std::span<const uint8_t> contents) {
+        write_bytes(file.path, contents);
+        try {
+            CmdStream stream(file.path);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    auto patched = [&](size_t offset, uint64_t value, size_t size) {
+        std::vector<uint8_t> copy = bytes;
+        std::memcpy(copy.data() + offset, &value, size);
+        return copy;
+    };
+    constexpr size_t PHASE0 = sizeof(CmdStreamHeader);
+
+    std::vector<uint8_t> bad_magic = bytes;
+    bad_magic[7] = '9';
+    TEST_ASSERT(results, rejected(bad_magic), "Bad magic rejected");
+    TEST_ASSERT(results, rejected(std::span(bytes).first(sizeof(CmdStreamHeader) - 1)),
+                "Truncated header rejected");
+    TEST_ASSERT(results, rejected(std::span(bytes).first(bytes.size() - sizeof(HexRegWrite))),
+                "Record table past the end of the file rejected");
+    TEST_ASSERT(results, rejected(patched(PHASE0 + offsetof(CmdStreamPhase, first_record), 6, 8)),
+                "Phase starting past the last record rejected");
+    TEST_ASSERT(results, rejected(patched(PHASE0 + offsetof(CmdStreamPhase, record_count), 6, 8)),
+                "Phase running past the last record rejected");
+    TEST_ASSERT(results,
+                rejected(patched(PHASE0 + offsetof(CmdStreamPhase, name_offset), bytes.size(), 4)),
+                "Phase name past the end of the file rejected");
+
+    std::printf("  test_rejects_bad_files: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main() {
+    std::printf("Running command stream tests...\n\n");
+
+    TestResults results;
+
+    test_round_trip(results);
+    test_rejects_bad_files(results);
+
+    return test_summary(results);
+}
@@ -0,0 +1,135 @@
+// Unit tests for the MEM_* upload backdoor (fast_upload.hpp).
+//
+// FastUpload must write the words, at the model addresses, that mem_dma
+// and sdram_controller.sv would.  Expected addresses are worked by hand
+// from the controller's split: bank = addr[23:22], row = addr[21:9],
+// column = {addr[8:1], 1'b0}, recombined as (bank << 23) | (row << 9) | column.
+//
+// Verifies:
+//   1. Byte address to model word address mapping.
+//   2. MEM_DATA word order, column stepping and pointer advance.
+//   3. MEM_FILL stride, row carry, and that it leaves the pointer alone.
+//   4. Alternating upload and RTL runs: each run ends at the other kind
+//      of write and MEM_DATA resumes from the synced pointer.
+//
+// Run by `make test-fast-upload`; no Verilator model needed.
+
+#include "fast_upload.hpp"
+#include "test_support.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <utility>
+#include <vector>
+
+using Writes = std::vector<std::pair<uint32_t, uint16_t>>;
+
+/// Records write_word() calls in order, standing in for SdramModel.
+struct Memory {
+    Writes writes;
+    void write_word(uint32_t addr, uint16_t value) {
+        writes.emplace_back(addr, value);
+    }
+};
+
+// -----------------------------------------------------------------------
+// Test 1: Address mapping
+// -----------------------------------------------------------------------
+static void test_model_addr(TestResults& results) {
+    TEST_ASSERT_EQ(results, FastUpload::model_addr(0x00'0203), uint32_t{0x00'0202},
+                   "Column bit 0 dropped");
+    TEST_ASSERT_EQ(results, FastUpload::model_addr(0x40'0000), uint32_t{0x80'0000},
+                   "Bank 1 placement");
+    TEST_ASSERT_EQ(results, FastUpload::model_addr(0xFF'FFFF), uint32_t{0x1BF'FFFE},
+                   "Bank 3 / last row / last column placement");
+
+    std::printf("  test_model_addr: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: MEM_DATA
+// -----------------------------------------------------------------------
+static void test_mem_data(TestResults& results) {
+    // DATA[15:0] first, four consecutive columns from byte address
+    // dword << 2, then the pointer advances one dword.
+    Memory mem;
+    FastUpload up;
+    std::vector<HexRegWrite> writes = {
+        {REG_MEM_ADDR, 0x100},
+        {REG_MEM_DATA, 0x4444'3333'2222'1111},
+        {REG_MEM_DATA, 0x8888'7777'6666'5555},
+    };
+    TEST_ASSERT_EQ(results, up.apply_prefix(mem, writes), size_t{3}, "Whole run applied");
+    Writes want = {{0x400, 0x1111}, {0x401, 0x2222}, {0x402, 0x3333}, {0x403, 0x4444},
+                   {0x404, 0x5555}, {0x405, 0x6666}, {0x406, 0x7777}, {0x407, 0x8888}};
+    TEST_ASSERT(results, mem.writes == want, "MEM_DATA word order and address");
+    TEST_ASSERT(results, up.needs_sync(), "Pointer moved");
+    TEST_ASSERT_EQ(results, up.sync_write().data, uint64_t{0x102}, "Pointer advanced two dwords");
+    TEST_ASSERT(results, !up.needs_sync(), "sync_write clears needs_sync");
+    TEST_ASSERT_EQ(results, up.words(), uint64_t{8}, "Word counter");
+    TEST_ASSERT_EQ(results, up.writes(), uint64_t{3}, "Write counter");
+
+    std::printf("  test_mem_data: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 3: MEM_FILL
+// -----------------------------------------------------------------------
+static void test_mem_fill(TestResults& results) {
+    // Byte address {BASE, 1'b0} steps by 2, so the fill lands on every
+    // other column and carries into the next row at column 0.
+    Memory mem;
+    FastUpload up;
+    HexRegWrite fill{REG_MEM_FILL, uint64_t{4} << 40 | uint64_t{0xABCD} << 24 | 0xFE};
+    std::vector<HexRegWrite> writes = {fill};
+    TEST_ASSERT_EQ(results, up.apply_prefix(mem, writes), size_t{1}, "Fill applied");
+    Writes want = {{0x1FC, 0xABCD}, {0x1FE, 0xABCD}, {0x200, 0xABCD}, {0x202, 0xABCD}};
+    TEST_ASSERT(results, mem.writes == want, "MEM_FILL stride and row carry");
+    TEST_ASSERT(results, !up.needs_sync(), "MEM_FILL leaves the MEM_DATA pointer");
+
+    std::printf("  test_mem_fill: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 4: Alternating upload and RTL runs
+// -----------------------------------------------------------------------
+static void test_runs(TestResults& results) {
+    Memory mem;
+    FastUpload up;
+    std::vector<HexRegWrite> writes = {
+        {REG_MEM_ADDR, 0x10}, {REG_MEM_DATA, 1}, {0x30, 0}, {0x31, 0}, {REG_MEM_DATA, 2},
+    };
+    std::span<const HexRegWrite> rest = writes;
+
+    size_t fast = up.apply_prefix(mem, rest);
+    TEST_ASSERT_EQ(results, fast, size_t{2}, "First run ends at a non-upload write");
+    rest = rest.subspan(fast);
+    size_t rtl = FastUpload::rtl_prefix(rest);
+    TEST_ASSERT_EQ(results, rtl, size_t{2}, "RTL run ends at the next upload write");
+    rest = rest.subspan(rtl);
+    TEST_ASSERT_EQ(results, up.sync_write().data, uint64_t{0x11}, "Sync carries the pointer");
+    TEST_ASSERT_EQ(results, up.apply_prefix(mem, rest), size_t{1}, "Second run applied");
+
+    Writes want = {{0x40, 1}, {0x41, 0}, {0x42, 0}, {0x43, 0},
+                   {0x44, 2}, {0x45, 0}, {0x46, 0}, {0x47, 0}};
+    TEST_ASSERT(results, mem.writes == want, "Second run resumes at the next dword");
+
+    std::printf("  test_runs: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main() {
+    std::printf("Running fast upload tests...\n\n");
+
+    TestResults results;
+
+    test_model_addr(results);
+    test_mem_data(results);
+    test_mem_fill(results);
+    test_runs(results);
+
+    return test_summary(results);
+}
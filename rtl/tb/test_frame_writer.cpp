@@ -0,0 +1,135 @@
+// Unit tests for the fast frame output path (frame_writer.hpp).
+//
+// Verifies:
+//   1. The striped PNG encoder, whose per-stripe deflate blocks are joined
+//      into one zlib stream, decodes to the framebuffer at 1, 4 and
+//      hardware_concurrency() stripes, including a partial last stripe.
+//   2. frame_format() picks the format from the extension, case-blind.
+//   3. A .rgb565 dump is the framebuffer as little-endian words, and RGB
+//      data cannot be written as one.
+//   4. QOI output carries the header and end marker of the QOI spec.
+//
+// Run by `make test-frame-writer`; no Verilator model needed.
+
+#include "frame_writer.hpp"
+#include "golden_compare.hpp"
+#include "png_reader.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+/// Noisy RGB565 frame, so deflate finds few matches and every stripe
+/// emits literals as well as back-references.
+static std::vector<uint16_t> test_frame(int width, int height) {
+    std::vector<uint16_t> fb(static_cast<size_t>(width) * static_cast<size_t>(height));
+    for (size_t i = 0; i < fb.size(); i++) {
+        fb[i] = static_cast<uint16_t>(i * 0x9E37 >> 3);
+    }
+    return fb;
+}
+
+// -----------------------------------------------------------------------
+// Test 1: Striped PNG round trip
+// -----------------------------------------------------------------------
+static void test_striped_png(TestResults& results) {
+    for (int height : {64, 70}) {
+        std::vector<uint16_t> fb = test_frame(8, height);
+        for (unsigned threads : {1u, 4u, 0u}) {
+            try {
+                auto decoded = png_reader::decode_png(
+                    frame_writer::encode_png(8, height, fb, threads));
+                TEST_ASSERT(results, compare_to_golden(decoded, 8, height, fb).passed(),
+                            "Striped PNG decodes to the framebuffer");
+            } catch (const std::runtime_error& e) {
+                test_fail(results, __func__, __LINE__, e.what());
+            }
+        }
+    }
+
+    std::printf("  test_striped_png: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Format from extension
+// -----------------------------------------------------------------------
+static void test_frame_format(TestResults& results) {
+    using frame_writer::FrameFormat;
+    using frame_writer::frame_format;
+    TEST_ASSERT(results, frame_format("a/frame.png") == FrameFormat::PNG, ".png is PNG");
+    TEST_ASSERT(results, frame_format("frame.QOI") == FrameFormat::QOI, ".QOI is QOI");
+    TEST_ASSERT(results, frame_format("frame.rgb565") == FrameFormat::RGB565, ".rgb565 is raw");
+    TEST_ASSERT(results, frame_format("frame") == FrameFormat::PNG, "No extension is PNG");
+
+    std::printf("  test_frame_format: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 3: Raw RGB565 dump
+// -----------------------------------------------------------------------
+static void test_rgb565_dump(TestResults& results) {
+    std::vector<uint16_t> fb = {0xF800, 0x07E0, 0x001F, 0x1234};
+    std::string path = test_temp_path("frame.rgb565");
+    frame_writer::write_frame(path, 2, 2, fb);
+    std::vector<uint8_t> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    std::vector<uint8_t> want = {0x00, 0xF8, 0xE0, 0x07, 0x1F, 0x00, 0x34, 0x12};
+    TEST_ASSERT(results, bytes == want, "Dump is little-endian RGB565 words");
+
+    bool rejected = false;
+    try {
+        std::vector<uint8_t> rgb(2 * 2 * 3);
+        frame_writer::write_frame(path, 2, 2, rgb);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    TEST_ASSERT(results, rejected, "RGB data rejected for a .rgb565 path");
+    TEST_ASSERT(results, !std::filesystem::exists(path), "Rejected dump wrote no file");
+
+    std::printf("  test_rgb565_dump: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 4: QOI framing
+// -----------------------------------------------------------------------
+static void test_qoi_framing(TestResults& results) {
+    std::vector<uint16_t> fb = test_frame(300, 2);
+    std::vector<uint8_t> qoi = frame_writer::encode_qoi(300, 2, fb);
+
+    std::vector<uint8_t> header = {'q', 'o', 'i', 'f', 0, 0, 0x01, 0x2C, 0, 0, 0, 2, 3, 0};
+    std::vector<uint8_t> end = {0, 0, 0, 0, 0, 0, 0, 1};
+    TEST_ASSERT(results, qoi.size() > header.size() + end.size(), "QOI has a body");
+    TEST_ASSERT(results, std::equal(header.begin(), header.end(), qoi.begin()),
+                "QOI header: magic, big-endian size, 3 channels, sRGB");
+    TEST_ASSERT(results, std::equal(end.rbegin(), end.rend(), qoi.rbegin()), "QOI end marker");
+
+    std::printf("  test_qoi_framing: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main() {
+    std::printf("Running frame writer tests...\n\n");
+
+    TestResults results;
+
+    test_striped_png(results);
+    test_frame_format(results);
+    test_rgb565_dump(results);
+    test_qoi_framing(results);
+
+    return test_summary(results);
+}
@@ -0,0 +1,85 @@
+// Unit tests for in-process golden image comparison (golden_compare.hpp,
+// png_reader.hpp).
+//
+// Verifies:
+//   1. read_png() reads back exactly the pixels write_png() wrote.
+//   2. A channel error is a mismatch at tolerance 0 and a pass once the
+//      tolerance covers it; a size difference always fails.
+//
+// Run by `make test-golden-compare`; no Verilator model needed.
+
+#include "golden_compare.hpp"
+#include "png_reader.hpp"
+#include "png_writer.hpp"
+#include "test_support.hpp"
+
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+/// Red, green, blue and white: one pixel per RGB565 field extreme.
+static constexpr std::array<uint16_t, 4> TEST_FB = {0xF800, 0x07E0, 0x001F, 0xFFFF};
+
+/// TEST_FB as a golden image: written with write_png() and read back.
+static png_reader::RgbImage write_and_read_golden() {
+    std::string path = test_temp_path("golden.png");
+    png_writer::write_png(path.c_str(), 2, 2, TEST_FB);
+    png_reader::RgbImage image = png_reader::read_png(path);
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return image;
+}
+
+// -----------------------------------------------------------------------
+// Test 1: PNG file round trip
+// -----------------------------------------------------------------------
+static void test_round_trip(TestResults& results) {
+    auto decoded = write_and_read_golden();
+    TEST_ASSERT(results, decoded.width == 2 && decoded.height == 2, "Decoded size");
+    GoldenDiff diff = compare_to_golden(decoded, 2, 2, TEST_FB);
+    TEST_ASSERT(results, diff.passed(), "Decoded pixels match the framebuffer");
+    TEST_ASSERT_EQ(results, diff.differing, uint64_t{0}, "No differing pixels");
+
+    std::printf("  test_round_trip: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Tolerance and size checks
+// -----------------------------------------------------------------------
+static void test_tolerance(TestResults& results) {
+    auto golden = write_and_read_golden();
+
+    // Blue 31 -> 30 in pixel 2 is an 8-bit error of 255 - 247 = 8.
+    std::array<uint16_t, 4> off_by_one = TEST_FB;
+    off_by_one[2] = 0x001E;
+    GoldenDiff exact = compare_to_golden(golden, 2, 2, off_by_one);
+    TEST_ASSERT(results, !exact.passed(), "Channel error fails at tolerance 0");
+    TEST_ASSERT_EQ(results, exact.mismatched, uint64_t{1}, "One mismatched pixel");
+    TEST_ASSERT_EQ(results, exact.max_channel_error, 8, "Max channel error");
+
+    GoldenDiff tolerant = compare_to_golden(golden, 2, 2, off_by_one, 8);
+    TEST_ASSERT(results, tolerant.passed(), "Channel error within tolerance passes");
+    TEST_ASSERT_EQ(results, tolerant.differing, uint64_t{1}, "Tolerated pixel still counted");
+
+    std::array<uint16_t, 2> row = {TEST_FB[0], TEST_FB[1]};
+    GoldenDiff resized = compare_to_golden(golden, 2, 1, row, 255);
+    TEST_ASSERT(results, resized.size_mismatch() && !resized.passed(), "Size difference fails");
+
+    std::printf("  test_tolerance: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main() {
+    std::printf("Running golden compare tests...\n\n");
+
+    TestResults results;
+
+    test_round_trip(results);
+    test_tolerance(results);
+
+    return test_summary(results);
+}
@@ -0,0 +1,215 @@
+// Unit tests for the streaming hex script parser (hex_parser.hpp).
+//
+// Verifies:
+//   1. A data line straddling a HexStreamReader buffer refill.
+//   2. A line longer than the buffer is an error naming its line.
+//   3. A bad hex value reports its own line.
+//   4. '## INCLUDE:' splices the included commands into the including
+//      phase, dropping the included file's PHASE and INCLUDE lines.
+//   5. Parity with the line-at-a-time parser HexStreamReader replaced on
+//      every VER script in the directory given as argv[1] (default
+//      "scripts", i.e. run from integration/).
+//
+// Run by `make test-hex-parser`; no Verilator model needed.
+
+#include "hex_parser.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+static bool same_commands(std::span<const HexRegWrite> a, std::span<const HexRegWrite> b) {
+    return std::ranges::equal(a, b, [](const HexRegWrite& x, const HexRegWrite& y) {
+        return x.addr == y.addr && x.data == y.data;
+    });
+}
+
+static bool same_script(const HexScript& a, const HexScript& b) {
+    return a.fb_width == b.fb_width && a.fb_height == b.fb_height
+        && std::ranges::equal(a.phases, b.phases, [](const HexPhase& x, const HexPhase& y) {
+               return x.name == y.name && same_commands(x.commands, y.commands);
+           });
+}
+
+/// Message of the std::runtime_error `parse` throws, or "" if it does not.
+template <typename F>
+static std::string parse_error(F parse) {
+    try {
+        parse();
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return {};
+}
+
+/// The line-at-a-time parser HexStreamReader replaced, kept as a reference.
+/// Covers the directives the VER scripts use (PHASE, FRAMEBUFFER and data
+/// lines); any other '##' line is ignored, as it was before.
+static HexScript reference_parse_hex_file(const std::string& path) {
+    std::ifstream file(path);
+    auto hex = [](std::string s) {
+        std::erase(s, '_');
+        return std::stoull(s, nullptr, 16);
+    };
+
+    HexScript script;
+    HexPhase current{"main", {}};
+    bool has_explicit_phase = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        while (!line.empty() && (line.back() == ' ' || line.back() == '\t' || line.back() == '\r')) {
+            line.pop_back();
+        }
+        if (line.starts_with("##")) {
+            if (line.starts_with("## PHASE:")) {
+                if (!current.commands.empty() || has_explicit_phase) {
+                    script.phases.push_back(std::move(current));
+                    current = HexPhase{};
+                }
+                auto start = line.find_first_not_of(" \t", 9);
+                current.name = start == std::string::npos ? "" : line.substr(start);
+                has_explicit_phase = true;
+            } else if (line.starts_with("## FRAMEBUFFER:")) {
+                std::istringstream(line.substr(15)) >> script.fb_width >> script.fb_height;
+            }
+            continue;
+        }
+        std::istringstream fields(line.substr(0, line.find('#')));
+        std::string addr;
+        std::string data;
+        if (fields >> addr >> data) {
+            current.commands.push_back({static_cast<uint8_t>(hex(addr) & 0x7F), hex(data)});
+        }
+    }
+    if (!current.commands.empty() || has_explicit_phase) {
+        script.phases.push_back(std::move(current));
+    }
+    return script;
+}
+
+// -----------------------------------------------------------------------
+// Test 1: Buffer refill
+// -----------------------------------------------------------------------
+static void test_buffer_refill(TestResults& results) {
+    constexpr size_t BUF = HexStreamReader::BUFFER_SIZE;
+    std::string head = "## PHASE: p\n";
+    std::string pad = "# " + std::string(BUF - 10 - head.size() - 3, 'x') + "\n";
+    std::string text = head + pad + "07 0123_4567_89AB_CDEF\n08 0000_0000_0000_0002\n";
+    TEST_ASSERT(results, text.find("07 ") < BUF && text.find("CDEF") > BUF,
+                "Fixture straddles the buffer");
+
+    HexScript s = parse_hex_string(text);
+    TEST_ASSERT(results,
+                s.phases.size() == 1 && s.phases[0].commands.size() == 2
+                    && s.phases[0].commands[0].addr == 0x07
+                    && s.phases[0].commands[0].data == 0x0123'4567'89AB'CDEF
+                    && s.phases[0].commands[1].data == 2,
+                "Line split across a buffer refill parsed");
+
+    std::printf("  test_buffer_refill: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Error line numbers
+// -----------------------------------------------------------------------
+static void test_error_lines(TestResults& results) {
+    std::string long_line = "00 0\n" + std::string(HexStreamReader::BUFFER_SIZE + 1, '#') + "\n00 1\n";
+    std::string err = parse_error([&] { parse_hex_string(long_line); });
+    TEST_ASSERT(results, err.find("line 2: line too long") != std::string::npos,
+                "Over-long line reported at line 2");
+
+    err = parse_error([] { parse_hex_string("# comment\n## PHASE: p\n00 0\n\n07 12G4\n"); });
+    TEST_ASSERT(results, err.find("line 5: bad hex value '12G4'") != std::string::npos,
+                "Bad hex value reported at line 5");
+
+    std::printf("  test_error_lines: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 3: INCLUDE splicing
+// -----------------------------------------------------------------------
+static void test_include(TestResults& results) {
+    auto dir = std::filesystem::path(test_temp_path("include"));
+    std::filesystem::create_directories(dir);
+    struct Cleanup {
+        std::filesystem::path dir;
+        ~Cleanup() {
+            std::error_code ec;
+            std::filesystem::remove_all(dir, ec);
+        }
+    } cleanup{dir};
+
+    // The nested include names a file that does not exist; it must be
+    // dropped rather than followed.
+    std::ofstream(dir / "inc.hex") << "## PHASE: dropped\n"
+                                      "## INCLUDE: missing.hex\n"
+                                      "## FRAMEBUFFER: 320 240\n"
+                                      "02 2\n"
+                                      "03 3\n";
+    std::ofstream(dir / "top.hex") << "## PHASE: first\n"
+                                      "01 1\n"
+                                      "## INCLUDE: inc.hex\n"
+                                      "04 4\n"
+                                      "## PHASE: second\n"
+                                      "05 5\n";
+    HexScript s = parse_hex_file((dir / "top.hex").string());
+    std::vector<HexRegWrite> first = {{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+    TEST_ASSERT_EQ(results, s.phases.size(), size_t{2}, "Phase count");
+    TEST_ASSERT(results,
+                s.phases.size() == 2 && s.phases[0].name == "first" && s.phases[1].name == "second"
+                    && same_commands(s.phases[0].commands, first)
+                    && s.phases[1].commands.size() == 1,
+                "Included commands spliced into the including phase");
+    TEST_ASSERT(results, s.fb_width == 320 && s.fb_height == 240, "Included FRAMEBUFFER applied");
+
+    std::printf("  test_include: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 4: Parity with the reference parser on the VER scripts
+// -----------------------------------------------------------------------
+static void test_ver_script_parity(TestResults& results, const std::filesystem::path& scripts) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(scripts, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.starts_with("ver_") && name.ends_with(".hex")) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    TEST_ASSERT(results, !paths.empty(), "VER scripts found");
+
+    for (const auto& path : paths) {
+        HexStreamReader reader(path);
+        if (!same_script(collect_hex_script(reader), reference_parse_hex_file(path))) {
+            test_fail(results, __func__, __LINE__,
+                      path + " parses differently from the reference parser");
+        }
+    }
+
+    std::printf("  test_ver_script_parity: PASS (%zu scripts)\n", paths.size());
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+    std::printf("Running hex parser tests...\n\n");
+
+    TestResults results;
+
+    test_buffer_refill(results);
+    test_error_lines(results);
+    test_include(results);
+    test_ver_script_parity(results, argc > 1 ? argv[1] : "scripts");
+
+    return test_summary(results);
+}
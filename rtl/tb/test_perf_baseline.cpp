@@ -0,0 +1,121 @@
+// Unit tests for performance metrics and baseline gating (perf_baseline.hpp).
+//
+// Verifies:
+//   1. SceneMetrics survive the scene,metric,value CSV round trip,
+//      including per-phase cycles, and read_metrics_csv() skips comment
+//      lines (the checked-in baseline starts with a header comment).
+//   2. The gate flags a cycle regression past the threshold only.
+//   3. With require_baseline, a scene with no baseline row, an empty
+//      baseline, or a zero-cycle row counts as missing; without it, none
+//      of these fail.
+//
+// Run by `make test-perf-baseline`; no Verilator model needed.
+
+#include "perf_baseline.hpp"
+#include "test_support.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+static SceneMetrics sample_metrics() {
+    return SceneMetrics{"smoke", 1000, {{"setup", 100}, {"draw", 900}}, 10, 20, 30, 0, 64, 0.0};
+}
+
+/// Removes the scratch CSV file when a test returns.
+struct TempFile {
+    std::string path;
+    ~TempFile() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+// -----------------------------------------------------------------------
+// Test 1: CSV round trip
+// -----------------------------------------------------------------------
+static void test_csv_round_trip(TestResults& results) {
+    SceneMetrics m = sample_metrics();
+    TempFile file{test_temp_path("metrics.csv")};
+    write_metrics_csv(file.path, std::span<const SceneMetrics>(&m, 1));
+    {
+        std::ofstream(file.path, std::ios::app) << "\n# trailing comment\n";
+    }
+
+    auto read = read_metrics_csv(file.path);
+    TEST_ASSERT_EQ(results, read.size(), size_t{1}, "One scene read back");
+    if (read.size() == 1) {
+        TEST_ASSERT(results, read[0].scene == "smoke", "Scene name");
+        TEST_ASSERT_EQ(results, read[0].cycles, uint64_t{1000}, "Total cycles");
+        TEST_ASSERT(results, read[0].phase_cycles == m.phase_cycles, "Phase cycles in order");
+        TEST_ASSERT_EQ(results, read[0].sdram_activates, uint64_t{10}, "SDRAM activates");
+        TEST_ASSERT_EQ(results, read[0].fragments, uint64_t{64}, "Fragments");
+    }
+
+    std::printf("  test_csv_round_trip: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Regression threshold
+// -----------------------------------------------------------------------
+static void test_regression_threshold(TestResults& results) {
+    SceneMetrics base = sample_metrics();
+    SceneMetrics slower = base;
+    slower.cycles = 1100;
+    auto current = std::span<const SceneMetrics>(&slower, 1);
+    auto baseline = std::span<const SceneMetrics>(&base, 1);
+
+    TEST_ASSERT_EQ(results, compare_to_baseline(current, baseline, 5.0).regressions, size_t{1},
+                   "10% slower fails a 5% gate");
+    TEST_ASSERT_EQ(results, compare_to_baseline(current, baseline, 20.0).regressions, size_t{0},
+                   "10% slower passes a 20% gate");
+    TEST_ASSERT_EQ(results, compare_to_baseline(baseline, current, 5.0).regressions, size_t{0},
+                   "Faster never fails");
+
+    std::printf("  test_regression_threshold: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 3: Missing baseline rows
+// -----------------------------------------------------------------------
+static void test_missing_rows(TestResults& results) {
+    SceneMetrics base = sample_metrics();
+    SceneMetrics other = base;
+    other.scene = "other";
+    SceneMetrics zero = base;
+    zero.cycles = 0;
+    auto baseline = std::span<const SceneMetrics>(&base, 1);
+    auto unknown = std::span<const SceneMetrics>(&other, 1);
+
+    TEST_ASSERT_EQ(results, compare_to_baseline(unknown, baseline, 5.0).missing, size_t{0},
+                   "New scene allowed without require_baseline");
+    TEST_ASSERT_EQ(results, compare_to_baseline(unknown, baseline, 5.0, true).missing, size_t{1},
+                   "Scene without a row is missing");
+    TEST_ASSERT_EQ(results, compare_to_baseline(unknown, {}, 5.0, true).missing, size_t{1},
+                   "Empty baseline is missing");
+    TEST_ASSERT_EQ(results,
+                   compare_to_baseline(baseline, std::span<const SceneMetrics>(&zero, 1), 5.0, true)
+                       .missing,
+                   size_t{1}, "Zero-cycle row is missing");
+
+    std::printf("  test_missing_rows: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main() {
+    std::printf("Running performance baseline tests...\n\n");
+
+    TestResults results;
+
+    test_csv_round_trip(results);
+    test_regression_threshold(results);
+    test_missing_rows(results);
+
+    return test_summary(results);
+}
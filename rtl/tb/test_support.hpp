@@ -0,0 +1,97 @@
+// Header-only assertion helpers for the host-side harness unit tests
+// (rtl/tb/test_*.cpp), in the style of integration/sim/test_sdram_model.cpp.
+//
+// Each test binary runs its `test_*` functions against one TestResults,
+// prints "  test_x: PASS" per function, and exits non-zero if any
+// assertion failed.  None of them needs Verilator.
+
+#ifndef TEST_SUPPORT_HPP
+#define TEST_SUPPORT_HPP
+
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+
+/// Aggregates test failure count across all test functions.
+struct TestResults {
+    int failures = 0;
+};
+
+/// Record a test assertion failure with source location context.
+///
+/// @param results   Test results accumulator.
+/// @param func      Name of the calling function (__func__).
+/// @param line      Source line number (__LINE__).
+/// @param msg       Human-readable failure description.
+inline void test_fail(TestResults& results, const char* func, int line, std::string_view msg) {
+    std::fprintf(stderr, "FAIL: %s (line %d): %.*s\n", func, line, static_cast<int>(msg.size()),
+                 msg.data());
+    results.failures++;
+}
+
+/// Record a test equality assertion failure with expected/actual values.
+///
+/// @param results   Test results accumulator.
+/// @param func      Name of the calling function (__func__).
+/// @param line      Source line number (__LINE__).
+/// @param msg       Human-readable failure description.
+/// @param expected  The expected value.
+/// @param actual    The actual value.
+template <typename T>
+void test_fail_eq(
+    TestResults& results, const char* func, int line, std::string_view msg, T expected, T actual
+) {
+    std::fprintf(
+        stderr,
+        "FAIL: %s (line %d): %.*s (expected %llu, got %llu)\n",
+        func,
+        line,
+        static_cast<int>(msg.size()),
+        msg.data(),
+        static_cast<unsigned long long>(expected),
+        static_cast<unsigned long long>(actual)
+    );
+    results.failures++;
+}
+
+/// Assert a boolean condition, recording a failure if false.
+///
+/// A macro is used here (rather than a function) because __func__ and __LINE__
+/// must be evaluated at the call site.
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TEST_ASSERT(results, cond, msg)                      \
+    do {                                                     \
+        if (!(cond)) {                                       \
+            test_fail((results), __func__, __LINE__, (msg)); \
+        }                                                    \
+    } while (0)
+
+/// Assert equality between two values, recording a failure with details.
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define TEST_ASSERT_EQ(results, a, b, msg)                                \
+    do {                                                                  \
+        if ((a) != (b)) {                                                 \
+            test_fail_eq((results), __func__, __LINE__, (msg), (b), (a)); \
+        }                                                                 \
+    } while (0)
+
+/// Path for a test artifact under the system temp directory.
+inline std::string test_temp_path(std::string_view name) {
+    return (std::filesystem::temp_directory_path() / std::format("harness_test_{}", name))
+        .string();
+}
+
+/// Print the summary line and return the process exit status.
+inline int test_summary(const TestResults& results) {
+    std::printf("\n");
+    if (results.failures == 0) {
+        std::printf("All tests PASSED.\n");
+        return 0;
+    }
+    std::printf("%d test(s) FAILED.\n", results.failures);
+    return 1;
+}
+
+#endif // TEST_SUPPORT_HPP
@@ -0,0 +1,115 @@
+// Unit tests for the procedural stress-scene generator (synth_scene.hpp).
+//
+// Verifies:
+//   1. Every kind's name round-trips through parse_synth_kind(), and an
+//      unknown name throws.
+//   2. The same kind, seed and count produce the same register stream; a
+//      different seed produces a different one.
+//   3. Every kind renders in the "setup", "draw" and "flush" phases.
+//   4. The two Hi-Z kinds draw the same layers in opposite orders: the
+//      same number of writes and triangles, but different streams.
+//
+// Run by `make test-synth-scene`; no Verilator model needed.
+
+#include "synth_scene.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+static constexpr std::array<SynthKind, 6> ALL_KINDS = {
+    SynthKind::TINY_TRIS,  SynthKind::OVERDRAW_BLEND, SynthKind::TEXTURE_THRASH,
+    SynthKind::HIZ_SORTED, SynthKind::HIZ_REVERSE,    SynthKind::STRIPS,
+};
+
+static bool same_stream(const HexScript& a, const HexScript& b) {
+    return std::ranges::equal(a.all_commands(), b.all_commands(),
+                              [](const HexRegWrite& x, const HexRegWrite& y) {
+                                  return x.addr == y.addr && x.data == y.data;
+                              });
+}
+
+// -----------------------------------------------------------------------
+// Test 1: Kind names
+// -----------------------------------------------------------------------
+static void test_kind_names(TestResults& results) {
+    for (SynthKind kind : ALL_KINDS) {
+        TEST_ASSERT(results, parse_synth_kind(synth_kind_name(kind)) == kind,
+                    std::string(synth_kind_name(kind)) + " round-trips");
+    }
+    bool threw = false;
+    try {
+        parse_synth_kind("no_such_kind");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    TEST_ASSERT(results, threw, "Unknown kind rejected");
+
+    std::printf("  test_kind_names: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Reproducibility
+// -----------------------------------------------------------------------
+static void test_reproducible(TestResults& results) {
+    SynthScene a = synthesize_scene({SynthKind::STRIPS, 7, 4});
+    SynthScene b = synthesize_scene({SynthKind::STRIPS, 7, 4});
+    SynthScene c = synthesize_scene({SynthKind::TINY_TRIS, 7, 64});
+    SynthScene d = synthesize_scene({SynthKind::TINY_TRIS, 8, 64});
+    TEST_ASSERT(results, same_stream(a.script, b.script), "Same seed, same stream");
+    TEST_ASSERT_EQ(results, a.triangles, uint64_t{4 * 64}, "Four strips of 64 triangles");
+    TEST_ASSERT(results, !same_stream(c.script, d.script), "Different seed, different stream");
+
+    std::printf("  test_reproducible: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 3: Phase layout
+// -----------------------------------------------------------------------
+static void test_phases(TestResults& results) {
+    for (SynthKind kind : ALL_KINDS) {
+        SynthScene scene = synthesize_scene({kind, 1, 4});
+        const auto& phases = scene.script.phases;
+        TEST_ASSERT(results,
+                    phases.size() == 3 && phases[0].name == "setup" && phases[1].name == "draw"
+                        && phases[2].name == "flush" && !phases[1].commands.empty(),
+                    std::string(synth_kind_name(kind)) + " has setup, draw and flush phases");
+        TEST_ASSERT(results, scene.triangles > 0, "Draw phase kicks triangles");
+    }
+
+    std::printf("  test_phases: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 4: Hi-Z orderings
+// -----------------------------------------------------------------------
+static void test_hiz_orderings(TestResults& results) {
+    SynthScene sorted = synthesize_scene({SynthKind::HIZ_SORTED, 7, 8});
+    SynthScene reverse = synthesize_scene({SynthKind::HIZ_REVERSE, 7, 8});
+    TEST_ASSERT_EQ(results, sorted.triangles, uint64_t{16}, "Eight quads are 16 triangles");
+    TEST_ASSERT_EQ(results, reverse.triangles, sorted.triangles, "Same triangle count");
+    TEST_ASSERT_EQ(results, reverse.script.all_commands().size(),
+                   sorted.script.all_commands().size(), "Same write count");
+    TEST_ASSERT(results, !same_stream(sorted.script, reverse.script), "Different draw order");
+
+    std::printf("  test_hiz_orderings: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main() {
+    std::printf("Running synthesized scene tests...\n\n");
+
+    TestResults results;
+
+    test_kind_names(results);
+    test_reproducible(results);
+    test_phases(results);
+    test_hiz_orderings(results);
+
+    return test_summary(results);
+}
@@ -0,0 +1,157 @@
+// Unit tests for the --tri-trace per-triangle tracer (tri_trace.hpp).
+//
+// Verifies:
+//   1. A triangle followed through setup, FIFO, iteration and retirement
+//      gets the expected stage durations and fragment count
+//   2. Stages a triangle had not finished when the run ended read as 0
+//      rather than wrapping (one triangle waiting in the FIFO, one still
+//      in setup)
+//   3. CSV and JSON output carry those zeros for the incomplete triangles
+//
+// Run by `make test-tri-trace`; no Verilator model needed.
+
+#include "test_support.hpp"
+#include "tri_trace.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/// Trace of three triangles that ends with the first retired, the second
+/// set up but still in raster_setup_fifo, and the third still in setup:
+///
+///   cycle 10      tri 0 submitted
+///   11..13        tri 0 setup, FIFO write at 13
+///   14            tri 1 submitted
+///   15..19        tri 0 iterating, fragments accepted at 16 and 17
+///   15..17        tri 1 setup, FIFO write at 17
+///   18            tri 2 submitted
+///   19..22        tri 2 setup (never finishes)
+///   20            tri 0 iteration ends, pixel pipeline still busy
+///   21            pixel pipeline back in IDLE: tri 0 retires
+static TriangleTracer trace_three_triangles() {
+    TriangleTracer tracer;
+    tracer.set_phase("draw");
+    for (uint64_t cycle = 10; cycle <= 22; cycle++) {
+        TriangleSample s;
+        s.cycle = cycle;
+        s.tri_valid = cycle == 10 || cycle == 14 || cycle == 18;
+        bool in_setup = (cycle >= 11 && cycle <= 13) || (cycle >= 15 && cycle <= 17)
+            || cycle >= 19;
+        s.setup_state = in_setup ? 1 : 0;
+        s.fifo_wr_en = cycle == 13 || cycle == 17;
+        s.iter_state = cycle >= 15 && cycle <= 19 ? 1 : 0;
+        s.frag_valid = cycle == 16 || cycle == 17;
+        s.frag_ready = s.frag_valid;
+        s.pp_state = cycle >= 15 && cycle <= 20 ? 1 : 0;
+        tracer.sample(s);
+    }
+    return tracer;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+static bool has(const std::string& text, const std::string& needle) {
+    return text.find(needle) != std::string::npos;
+}
+
+// -----------------------------------------------------------------------
+// Test 1: Retired triangle
+// -----------------------------------------------------------------------
+static void test_retired_triangle(TestResults& results) {
+    TriangleTracer tracer = trace_three_triangles();
+    TEST_ASSERT_EQ(results, tracer.records().size(), size_t{3}, "triangle count");
+
+    const TriangleRecord& rec = tracer.records()[0];
+    TEST_ASSERT(results, rec.complete && !rec.culled, "tri 0 retired");
+    TEST_ASSERT(results, rec.phase == "draw", "tri 0 phase");
+    TEST_ASSERT_EQ(results, rec.submit_cycle, uint64_t{10}, "tri 0 submit");
+    TEST_ASSERT_EQ(results, rec.setup_cycles(), uint64_t{3}, "tri 0 setup");
+    TEST_ASSERT_EQ(results, rec.fifo_wait_cycles(), uint64_t{1}, "tri 0 FIFO wait");
+    TEST_ASSERT_EQ(results, rec.iteration_cycles(), uint64_t{5}, "tri 0 iteration");
+    TEST_ASSERT_EQ(results, rec.retire_cycle, uint64_t{21}, "tri 0 retire");
+    TEST_ASSERT_EQ(results, rec.latency_cycles(), uint64_t{11}, "tri 0 latency");
+    TEST_ASSERT_EQ(results, rec.fragments, uint64_t{2}, "tri 0 fragments");
+
+    std::printf("  test_retired_triangle: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Incomplete triangles
+// -----------------------------------------------------------------------
+static void test_incomplete_triangles(TestResults& results) {
+    TriangleTracer tracer = trace_three_triangles();
+
+    const TriangleRecord& queued = tracer.records()[1];
+    TEST_ASSERT(results, !queued.complete, "tri 1 incomplete");
+    TEST_ASSERT_EQ(results, queued.submit_cycle, uint64_t{14}, "tri 1 submit");
+    TEST_ASSERT_EQ(results, queued.setup_cycles(), uint64_t{3}, "tri 1 setup");
+    TEST_ASSERT_EQ(results, queued.fifo_wait_cycles(), uint64_t{0}, "tri 1 FIFO wait");
+    TEST_ASSERT_EQ(results, queued.iteration_cycles(), uint64_t{0}, "tri 1 iteration");
+    TEST_ASSERT_EQ(results, queued.latency_cycles(), uint64_t{0}, "tri 1 latency");
+
+    const TriangleRecord& in_setup = tracer.records()[2];
+    TEST_ASSERT(results, !in_setup.complete, "tri 2 incomplete");
+    TEST_ASSERT_EQ(results, in_setup.submit_cycle, uint64_t{18}, "tri 2 submit");
+    TEST_ASSERT_EQ(results, in_setup.setup_cycles(), uint64_t{0}, "tri 2 setup");
+    TEST_ASSERT_EQ(results, in_setup.fifo_wait_cycles(), uint64_t{0}, "tri 2 FIFO wait");
+    TEST_ASSERT_EQ(results, in_setup.iteration_cycles(), uint64_t{0}, "tri 2 iteration");
+    TEST_ASSERT_EQ(results, in_setup.latency_cycles(), uint64_t{0}, "tri 2 latency");
+
+    std::string summary = tracer.summary();
+    TEST_ASSERT(results, summary.starts_with("Triangles: 1 retired, 0 culled, 2 incomplete"),
+                "summary: " + summary);
+
+    std::printf("  test_incomplete_triangles: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 3: CSV and JSON output
+// -----------------------------------------------------------------------
+static void test_write(TestResults& results) {
+    TriangleTracer tracer = trace_three_triangles();
+
+    std::string csv_path = test_temp_path("tri_trace.csv");
+    tracer.write(csv_path);
+    std::string csv = read_file(csv_path);
+    TEST_ASSERT(results, has(csv, "\n0,draw,10,3,1,5,21,11,2,0,0,0,0,1\n"), "CSV tri 0 row");
+    TEST_ASSERT(results, has(csv, "\n1,draw,14,3,0,0,0,0,0,0,0,0,0,0\n"), "CSV tri 1 row");
+    TEST_ASSERT(results, has(csv, "\n2,draw,18,0,0,0,0,0,0,0,0,0,0,0\n"), "CSV tri 2 row");
+
+    std::string json_path = test_temp_path("tri_trace.json");
+    tracer.write(json_path);
+    std::string json = read_file(json_path);
+    TEST_ASSERT(results,
+                has(json, "{\"triangle\": 2, \"phase\": \"draw\", \"submit_cycle\": 18, "
+                          "\"setup_cycles\": 0, \"fifo_wait_cycles\": 0, "
+                          "\"iteration_cycles\": 0, \"retire_cycle\": 0, "
+                          "\"latency_cycles\": 0,"),
+                "JSON tri 2 record");
+
+    std::filesystem::remove(csv_path);
+    std::filesystem::remove(json_path);
+
+    std::printf("  test_write: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main() {
+    std::printf("Running triangle trace tests...\n\n");
+
+    TestResults results;
+
+    test_retired_triangle(results);
+    test_incomplete_triangles(results);
+    test_write(results);
+
+    return test_summary(results);
+}
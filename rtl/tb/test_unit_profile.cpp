@@ -0,0 +1,121 @@
+// Unit tests for the --profile state name tables (unit_profile.hpp).
+//
+// Verifies that unit_state_name() still matches the RTL: each state enum
+// is read from the .sv source under the component directory given as
+// argv[1] (default "../rtl/components", i.e. run from integration/), and
+// every encoding below UnitProfile::MAX_STATES must carry the enum's name
+// (prefix stripped), or "S<n>" where the enum has no such value.
+//   1. rasterizer.sv state_t
+//   2. pixel_pipeline.sv pp_state_t
+//   3. color_tile_cache.sv and zbuf_tile_cache.sv state_t
+//
+// Run by `make test-unit-profile`; no Verilator model needed.
+
+#include "test_support.hpp"
+#include "unit_profile.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+
+/// Encoding -> name of the `typedef enum ... } type_name;` in `sv_file`,
+/// with `prefix` stripped from each name.  Empty if the file or the enum
+/// is missing.
+static std::map<size_t, std::string> read_sv_enum(const std::filesystem::path& sv_file,
+                                                  const std::string& type_name,
+                                                  const std::string& prefix) {
+    std::ifstream file(sv_file);
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string source = text.str();
+
+    std::map<size_t, std::string> names;
+    static const std::regex enum_re(R"(typedef\s+enum[^{]*\{([^}]*)\}\s*(\w+)\s*;)");
+    static const std::regex item_re(R"((\w+)\s*=\s*\d*'[dD](\d+))");
+    for (auto it = std::sregex_iterator(source.begin(), source.end(), enum_re);
+         it != std::sregex_iterator(); ++it) {
+        if ((*it)[2] != type_name) {
+            continue;
+        }
+        std::string body = (*it)[1];
+        for (auto item = std::sregex_iterator(body.begin(), body.end(), item_re);
+             item != std::sregex_iterator(); ++item) {
+            std::string name = (*item)[1];
+            if (name.starts_with(prefix)) {
+                name.erase(0, prefix.size());
+            }
+            names[std::stoul((*item)[2])] = name;
+        }
+    }
+    return names;
+}
+
+/// Compare `unit`'s name table with the enum read from `sv_file`.
+static void check_unit(TestResults& results, ProfiledUnit unit,
+                       const std::filesystem::path& sv_file, const std::string& type_name,
+                       const std::string& prefix) {
+    auto rtl = read_sv_enum(sv_file, type_name, prefix);
+    TEST_ASSERT(results, !rtl.empty(),
+                std::format("{} declares {}", sv_file.string(), type_name));
+    for (size_t state = 0; state < UnitProfile::MAX_STATES; state++) {
+        auto it = rtl.find(state);
+        std::string expected = it != rtl.end() ? it->second : std::format("S{}", state);
+        TEST_ASSERT(results, unit_state_name(unit, state) == expected,
+                    std::format("{} state {}: table has {}, {} has {}", unit_name(unit), state,
+                                unit_state_name(unit, state), sv_file.filename().string(),
+                                expected));
+    }
+}
+
+// -----------------------------------------------------------------------
+// Test 1: Rasterizer
+// -----------------------------------------------------------------------
+static void test_rasterizer(TestResults& results, const std::filesystem::path& comp_dir) {
+    check_unit(results, ProfiledUnit::RASTERIZER, comp_dir / "rasterizer/src/rasterizer.sv",
+               "state_t", "");
+
+    std::printf("  test_rasterizer: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 2: Pixel pipeline
+// -----------------------------------------------------------------------
+static void test_pixel_pipeline(TestResults& results, const std::filesystem::path& comp_dir) {
+    check_unit(results, ProfiledUnit::PIXEL_PIPELINE,
+               comp_dir / "pixel-write/src/pixel_pipeline.sv", "pp_state_t", "PP_");
+
+    std::printf("  test_pixel_pipeline: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Test 3: Tile caches
+// -----------------------------------------------------------------------
+static void test_tile_caches(TestResults& results, const std::filesystem::path& comp_dir) {
+    check_unit(results, ProfiledUnit::COLOR_CACHE,
+               comp_dir / "pixel-write/src/color_tile_cache.sv", "state_t", "S_");
+    check_unit(results, ProfiledUnit::Z_CACHE, comp_dir / "zbuf/src/zbuf_tile_cache.sv",
+               "state_t", "S_");
+
+    std::printf("  test_tile_caches: PASS\n");
+}
+
+// -----------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------
+int main(int argc, char** argv) {
+    std::printf("Running unit profile state table tests...\n\n");
+
+    std::filesystem::path comp_dir = argc > 1 ? argv[1] : "../rtl/components";
+    TestResults results;
+
+    test_rasterizer(results, comp_dir);
+    test_pixel_pipeline(results, comp_dir);
+    test_tile_caches(results, comp_dir);
+
+    return test_summary(results);
+}
@@ -0,0 +1,174 @@
+// Per-triangle latency trace: stage tracking and CSV / JSON output.
+//
+// See tri_trace.hpp for the stage boundaries.
+
+#include "tri_trace.hpp"
+
+#include <array>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+// rasterizer.sv setup_state_t / iter_state_t and pixel_pipeline.sv
+// pp_state_t encodings used below.
+constexpr uint8_t S_IDLE = 0;
+constexpr uint8_t S_SETUP = 1;
+constexpr uint8_t I_IDLE = 0;
+constexpr uint8_t PP_IDLE = 0;
+
+/// Pixel-pipeline states that wait on another unit (Z_WAIT, CC_WAIT,
+/// FB_WAIT, TEX_WAIT).
+constexpr bool pp_waiting(uint8_t state) {
+    return state == 2 || state == 4 || state == 6 || state == 10;
+}
+
+} // namespace
+
+void TriangleTracer::sample(const TriangleSample& s) {
+    // 1. Charge this cycle's fragment traffic.  A fragment inside the
+    // pixel pipeline belongs to the retiring triangle until it retires;
+    // one waiting at the rasterizer output to the iterating triangle.
+    std::optional<size_t> in_pipeline = retiring_ ? retiring_ : iterating_;
+    std::optional<size_t> at_output = iterating_ ? iterating_ : retiring_;
+    if (s.frag_valid && s.frag_ready && at_output) {
+        records_[*at_output].fragments++;
+    }
+    if (s.frag_valid && !s.frag_ready && at_output) {
+        records_[*at_output].backpressure_cycles++;
+    }
+    if (pp_waiting(s.pp_state) && in_pipeline) {
+        records_[*in_pipeline].pp_stall_cycles++;
+    }
+
+    // 2. Submission and setup.  A triangle is created when the setup FSM
+    // enters S_SETUP; its submit cycle is the first tri_valid before that.
+    if (s.tri_valid && !pending_submit_) {
+        pending_submit_ = s.cycle;
+    }
+    if (s.setup_state == S_SETUP && prev_setup_state_ != S_SETUP) {
+        TriangleRecord rec;
+        rec.index = records_.size();
+        rec.phase = phase_;
+        rec.submit_cycle = pending_submit_.value_or(s.cycle);
+        rec.setup_start = s.cycle;
+        pending_submit_.reset();
+        in_setup_ = rec.index;
+        records_.push_back(std::move(rec));
+    }
+    if (in_setup_) {
+        TriangleRecord& rec = records_[*in_setup_];
+        if (s.fifo_wr_en) {
+            rec.setup_end = s.cycle + 1;
+            in_fifo_.push_back(*in_setup_);
+            in_setup_.reset();
+        } else if (s.setup_state == S_IDLE) {
+            // Left setup without a FIFO write: zero-area cull.
+            rec.setup_end = s.cycle;
+            rec.culled = true;
+            rec.complete = true;
+            in_setup_.reset();
+        }
+    }
+    prev_setup_state_ = s.setup_state;
+
+    // 3. Iteration.  Triangles leave the FIFO in order.  Iteration with
+    // nothing queued (a run restored mid-triangle) is not traced.
+    if (!iterating_ && s.iter_state != I_IDLE && !in_fifo_.empty()) {
+        iterating_ = in_fifo_.front();
+        in_fifo_.pop_front();
+        records_[*iterating_].iter_start = s.cycle;
+        hiz_at_iter_start_ = s.hiz_rejected_tiles;
+    } else if (iterating_ && s.iter_state == I_IDLE) {
+        TriangleRecord& rec = records_[*iterating_];
+        rec.iter_end = s.cycle;
+        rec.hiz_rejected_tiles = s.hiz_rejected_tiles - hiz_at_iter_start_;
+        if (retiring_) {
+            // Still in flight when the next triangle finished iterating.
+            records_[*retiring_].retire_cycle = s.cycle;
+            records_[*retiring_].complete = true;
+        }
+        retiring_ = iterating_;
+        iterating_.reset();
+    }
+
+    // 4. Retirement: the pixel pipeline is back in IDLE.
+    if (retiring_ && s.pp_state == PP_IDLE) {
+        records_[*retiring_].retire_cycle = s.cycle;
+        records_[*retiring_].complete = true;
+        retiring_.reset();
+    }
+}
+
+std::string TriangleTracer::summary() const {
+    size_t traced = 0;
+    size_t culled = 0;
+    uint64_t setup = 0;
+    uint64_t iteration = 0;
+    uint64_t fragments = 0;
+    for (const auto& rec : records_) {
+        if (rec.culled) {
+            culled++;
+        } else if (rec.complete) {
+            traced++;
+            setup += rec.setup_cycles();
+            iteration += rec.iteration_cycles();
+            fragments += rec.fragments;
+        }
+    }
+    auto mean = [traced](uint64_t total) {
+        return traced ? static_cast<double>(total) / static_cast<double>(traced) : 0.0;
+    };
+    return std::format(
+        "Triangles: {} retired, {} culled, {} incomplete; mean setup {:.1f}, "
+        "iteration {:.1f} cycles, {:.1f} fragments",
+        traced, culled, records_.size() - traced - culled, mean(setup), mean(iteration),
+        mean(fragments)
+    );
+}
+
+void TriangleTracer::write(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error(std::format("cannot write triangle trace {}", path));
+    }
+    bool json = path.ends_with(".json");
+
+    if (json) {
+        out << "[\n";
+    } else {
+        out << "triangle,phase,submit_cycle,setup_cycles,fifo_wait_cycles,iteration_cycles,"
+               "retire_cycle,latency_cycles,fragments,hiz_rejected_tiles,pp_stall_cycles,"
+               "backpressure_cycles,culled,complete\n";
+    }
+    for (size_t i = 0; i < records_.size(); i++) {
+        const auto& r = records_[i];
+        if (json) {
+            out << std::format(
+                "  {{\"triangle\": {}, \"phase\": \"{}\", \"submit_cycle\": {}, "
+                "\"setup_cycles\": {}, \"fifo_wait_cycles\": {}, \"iteration_cycles\": {}, "
+                "\"retire_cycle\": {}, \"latency_cycles\": {}, \"fragments\": {}, "
+                "\"hiz_rejected_tiles\": {}, \"pp_stall_cycles\": {}, "
+                "\"backpressure_cycles\": {}, \"culled\": {}, \"complete\": {}}}{}\n",
+                r.index, r.phase, r.submit_cycle, r.setup_cycles(), r.fifo_wait_cycles(),
+                r.iteration_cycles(), r.retire_cycle, r.latency_cycles(), r.fragments,
+                r.hiz_rejected_tiles, r.pp_stall_cycles, r.backpressure_cycles, r.culled,
+                r.complete, i + 1 < records_.size() ? "," : ""
+            );
+        } else {
+            out << std::format(
+                "{},{},{},{},{},{},{},{},{},{},{},{},{},{}\n", r.index, r.phase, r.submit_cycle,
+                r.setup_cycles(), r.fifo_wait_cycles(), r.iteration_cycles(), r.retire_cycle,
+                r.latency_cycles(), r.fragments, r.hiz_rejected_tiles, r.pp_stall_cycles,
+                r.backpressure_cycles, r.culled ? 1 : 0, r.complete ? 1 : 0
+            );
+        }
+    }
+    if (json) {
+        out << "]\n";
+    }
+    if (!out) {
+        throw std::runtime_error(std::format("cannot write triangle trace {}", path));
+    }
+}
@@ -0,0 +1,114 @@
+// Per-triangle latency trace for the integration harness (--tri-trace).
+//
+// The rasterizer (UNIT-005, DD-035) is a producer-consumer pair: a setup
+// FSM computes edge equations and the reciprocal area, then pushes the
+// triangle into raster_setup_fifo, from which the iteration FSM walks
+// it and emits fragments to the pixel pipeline (UNIT-006).  Setup of
+// triangle N+1 therefore overlaps iteration of triangle N, so a single
+// cycle total cannot say what each triangle cost.
+//
+// TriangleTracer follows every triangle through those stages from
+// per-cycle samples:
+//
+//   submit   first tri_valid cycle of the triangle
+//   setup    setup_state from S_SETUP until the FIFO write (fifo_wr_en),
+//            or until it returns to S_IDLE without one (zero-area cull)
+//   fifo     waiting in raster_setup_fifo
+//   iterate  iter_state out of I_IDLE; fragment handshakes, Hi-Z tile
+//            rejections and pixel-pipeline stalls are charged here
+//   retire   first cycle after iteration ends with the pixel pipeline
+//            back in IDLE (its last fragment has left the FSM)
+//
+// Records are written as CSV or JSON for offline analysis, e.g. setup
+// overhead against triangle area in VER-015 (size_grid).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// One cycle's worth of sampled rasterizer / pixel-pipeline state.
+struct TriangleSample {
+    uint64_t cycle = 0;              ///< Core clock cycle number
+    bool tri_valid = false;          ///< gpu_top tri_valid
+    uint8_t setup_state = 0;         ///< rasterizer.sv setup_state_t
+    uint8_t iter_state = 0;          ///< rasterizer.sv iter_state_t
+    bool fifo_wr_en = false;         ///< Setup -> raster_setup_fifo write
+    bool frag_valid = false;         ///< Rasterizer fragment valid
+    bool frag_ready = false;         ///< Pixel pipeline ready
+    uint8_t pp_state = 0;            ///< pixel_pipeline.sv pp_state_t
+    uint32_t hiz_rejected_tiles = 0; ///< Running Hi-Z rejection counter
+};
+
+/// Timing and work of one triangle.
+struct TriangleRecord {
+    size_t index = 0;                ///< 0-based submission order
+    std::string phase;               ///< Script phase it was submitted in
+    uint64_t submit_cycle = 0;       ///< First tri_valid cycle
+    uint64_t setup_start = 0;        ///< First S_SETUP cycle
+    uint64_t setup_end = 0;          ///< Cycle after the FIFO write (0 until then)
+    uint64_t iter_start = 0;         ///< First non-I_IDLE cycle (0 until then)
+    uint64_t iter_end = 0;           ///< First I_IDLE cycle after iterating (0 until then)
+    uint64_t retire_cycle = 0;       ///< Pixel pipeline back in IDLE (0 until then)
+    uint64_t fragments = 0;          ///< Fragments accepted by the pixel pipeline
+    uint32_t hiz_rejected_tiles = 0; ///< Hi-Z tiles rejected while iterating
+    uint64_t pp_stall_cycles = 0;    ///< Pixel pipeline in a *_WAIT state
+    uint64_t backpressure_cycles = 0; ///< Fragment valid, pixel pipeline not ready
+    bool culled = false;             ///< Dropped at setup (zero area)
+    bool complete = false;           ///< Retired (or culled) within the run
+
+    // Stage durations are 0 for a stage whose end cycle the run did not
+    // reach (its boundary field is still 0).
+    uint64_t setup_cycles() const {
+        return setup_end ? setup_end - setup_start : 0;
+    }
+    uint64_t fifo_wait_cycles() const {
+        return culled || !iter_start ? 0 : iter_start - setup_end;
+    }
+    uint64_t iteration_cycles() const {
+        return culled || !iter_end ? 0 : iter_end - iter_start;
+    }
+    uint64_t latency_cycles() const {
+        return complete ? (culled ? setup_end : retire_cycle) - submit_cycle : 0;
+    }
+};
+
+/// Follows triangles through setup, iteration and retirement.
+class TriangleTracer {
+public:
+    /// Phase name recorded for triangles submitted from now on.
+    void set_phase(std::string phase) {
+        phase_ = std::move(phase);
+    }
+
+    /// Account one cycle.
+    void sample(const TriangleSample& s);
+
+    /// All triangles seen so far, in submission order.
+    const std::vector<TriangleRecord>& records() const {
+        return records_;
+    }
+
+    /// One-line summary (count, culled, mean setup/iteration/fragments).
+    std::string summary() const;
+
+    /// Write records to `path`: JSON if it ends in ".json", else CSV.
+    /// @throws std::runtime_error if the file cannot be written.
+    void write(const std::string& path) const;
+
+private:
+    std::vector<TriangleRecord> records_;
+    std::string phase_;
+    std::optional<uint64_t> pending_submit_; ///< tri_valid seen, setup not started
+    std::optional<size_t> in_setup_;          ///< Triangle in the setup FSM
+    std::deque<size_t> in_fifo_;              ///< Set up, waiting to iterate
+    std::optional<size_t> iterating_;         ///< Triangle in the iteration FSM
+    std::optional<size_t> retiring_;          ///< Iterated, fragments still in flight
+    uint32_t hiz_at_iter_start_ = 0;
+    uint8_t prev_setup_state_ = 0;
+};
@@ -0,0 +1,166 @@
+// Per-unit cycle accounting: state names and report formatting.
+//
+// See unit_profile.hpp for what is sampled.
+
+#include "unit_profile.hpp"
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/// State names indexed by encoding; empty entries are unused encodings.
+using StateNames = std::array<std::string_view, UnitProfile::MAX_STATES>;
+
+/// rasterizer.sv state_t (5-bit, sparse encoding).
+constexpr StateNames RAST_STATES = [] {
+    StateNames n{};
+    n[0] = "IDLE";
+    n[1] = "SETUP";
+    n[2] = "ITER_START";
+    n[4] = "INIT_E1";
+    n[5] = "WALKING";
+    n[12] = "SETUP_RECIP";
+    n[13] = "SETUP_2";
+    n[14] = "SETUP_3";
+    n[15] = "INIT_E2";
+    n[16] = "DERIV_WAIT";
+    return n;
+}();
+
+/// pixel_pipeline.sv pp_state_t.
+constexpr StateNames PP_STATES = {
+    "IDLE",    "Z_READ",  "Z_WAIT",     "CC_EMIT",    "CC_WAIT",  "FB_READ",
+    "FB_WAIT", "WRITE",   "Z_WRITE",    "TEX_LOOKUP", "TEX_WAIT", "TEX_READ",
+};
+
+/// color_tile_cache.sv / zbuf_tile_cache.sv state_t (same encoding).
+constexpr StateNames CACHE_STATES = {
+    "IDLE",       "RD_HIT", "EVICT",  "FILL",       "LAZYFILL",  "WR_UPDATE",
+    "WR_FILL_WAIT", "BRAM_RD", "TAG_RD", "FLUSH_NEXT", "FLUSH_TAG", "FLUSH_WB",
+};
+
+const StateNames& state_names(ProfiledUnit unit) {
+    switch (unit) {
+        case ProfiledUnit::RASTERIZER:
+            return RAST_STATES;
+        case ProfiledUnit::PIXEL_PIPELINE:
+            return PP_STATES;
+        default:
+            return CACHE_STATES;
+    }
+}
+
+/// Pixel-pipeline states that wait on another unit rather than doing
+/// work; these are the stall reasons ranked in the report.
+constexpr std::array<std::pair<size_t, std::string_view>, 4> PP_STALLS = {{
+    {2, "Z_WAIT (Z tile cache read)"},
+    {4, "CC_WAIT (color combiner)"},
+    {6, "FB_WAIT (color tile cache read)"},
+    {10, "TEX_WAIT (texture cache fill)"},
+}};
+
+constexpr std::array<ProfiledUnit, PROFILED_UNIT_COUNT> ALL_UNITS = {
+    ProfiledUnit::RASTERIZER,
+    ProfiledUnit::PIXEL_PIPELINE,
+    ProfiledUnit::COLOR_CACHE,
+    ProfiledUnit::Z_CACHE,
+};
+
+double percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+} // namespace
+
+void UnitProfile::merge(const UnitProfile& other) {
+    cycles += other.cycles;
+    fragments += other.fragments;
+    triangles += other.triangles;
+    starved_cycles += other.starved_cycles;
+    for (size_t u = 0; u < PROFILED_UNIT_COUNT; u++) {
+        for (size_t s = 0; s < MAX_STATES; s++) {
+            states_[u][s] += other.states_[u][s];
+        }
+    }
+}
+
+std::string_view unit_name(ProfiledUnit unit) {
+    switch (unit) {
+        case ProfiledUnit::RASTERIZER:
+            return "rasterizer";
+        case ProfiledUnit::PIXEL_PIPELINE:
+            return "pixel_pipeline";
+        case ProfiledUnit::COLOR_CACHE:
+            return "color_cache";
+        case ProfiledUnit::Z_CACHE:
+            return "z_cache";
+    }
+    return "?";
+}
+
+std::string unit_state_name(ProfiledUnit unit, size_t state) {
+    const auto& names = state_names(unit);
+    if (state < names.size() && !names[state].empty()) {
+        return std::string(names[state]);
+    }
+    return std::format("S{}", state);
+}
+
+std::string format_unit_profile(std::string_view title, const UnitProfile& p) {
+    std::string r = std::format("Profile: {} — {} cycles, {} fragments", title, p.cycles, p.fragments);
+    if (p.fragments > 0) {
+        double cpf = static_cast<double>(p.cycles) / static_cast<double>(p.fragments);
+        r += std::format(
+            ", {:.3f} frag/cycle, {:.2f} cycles/frag ({:.2f}x target of {:.0f})\n",
+            1.0 / cpf, cpf, cpf / TARGET_CYCLES_PER_FRAGMENT, TARGET_CYCLES_PER_FRAGMENT
+        );
+    } else {
+        r += "\n";
+    }
+    if (p.cycles == 0) {
+        return r;
+    }
+
+    // Utilization and the busiest non-IDLE states of each unit.
+    for (auto unit : ALL_UNITS) {
+        r += std::format(
+            "  {:<15} busy {:5.1f}%", unit_name(unit), percent(p.busy_cycles(unit), p.cycles)
+        );
+        std::vector<std::pair<uint64_t, size_t>> states;
+        for (size_t s = 1; s < UnitProfile::MAX_STATES; s++) {
+            if (p.state_cycles(unit, s) > 0) {
+                states.emplace_back(p.state_cycles(unit, s), s);
+            }
+        }
+        std::ranges::sort(states, std::greater{});
+        for (size_t i = 0; i < states.size() && i < 4; i++) {
+            r += std::format(
+                " {} {:.1f}%", unit_state_name(unit, states[i].second),
+                percent(states[i].first, p.cycles)
+            );
+        }
+        r += "\n";
+    }
+
+    // Where the pixel pipeline's cycles go when it is not doing work.
+    std::vector<std::pair<uint64_t, std::string_view>> stalls;
+    for (const auto& [state, reason] : PP_STALLS) {
+        stalls.emplace_back(p.state_cycles(ProfiledUnit::PIXEL_PIPELINE, state), reason);
+    }
+    stalls.emplace_back(p.starved_cycles, "IDLE while rasterizer busy (starved)");
+    std::ranges::sort(stalls, std::greater{});
+    r += "  top stalls:";
+    bool any = false;
+    for (size_t i = 0; i < stalls.size() && i < 3 && stalls[i].first > 0; i++) {
+        r += std::format(
+            "{} {} {:.1f}%", any ? "," : "", stalls[i].second, percent(stalls[i].first, p.cycles)
+        );
+        any = true;
+    }
+    r += any ? "\n" : " none\n";
+    return r;
+}
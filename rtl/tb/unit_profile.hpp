@@ -0,0 +1,97 @@
+// Per-unit cycle accounting for the integration harness (--profile).
+//
+// Each simulated cycle the harness samples the FSM state of the
+// rasterizer (UNIT-005), pixel pipeline (UNIT-006), color tile cache
+// (UNIT-013) and Z tile cache (UNIT-012) into a UnitSample, and
+// UnitProfile accumulates a state histogram per unit plus fragment and
+// triangle counts.  format_unit_profile() turns one profile into a
+// report of unit utilization, the states where the pixel pipeline
+// loses cycles, and cycles per fragment against the 4-cycle/fragment
+// throughput target (ARCHITECTURE.md).
+//
+// State numbering mirrors the state_t enums in rasterizer.sv,
+// pixel_pipeline.sv, color_tile_cache.sv and zbuf_tile_cache.sv; keep
+// the name tables in unit_profile.cpp in sync with them
+// (`make test-unit-profile` reads the enums and fails on any mismatch).
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// Target pixel-pipeline throughput (ARCHITECTURE.md, UNIT-010).
+inline constexpr double TARGET_CYCLES_PER_FRAGMENT = 4.0;
+
+/// One cycle's worth of sampled unit state.
+struct UnitSample {
+    uint8_t rast_state = 0;        ///< rasterizer.sv state_t
+    uint8_t pp_state = 0;          ///< pixel_pipeline.sv pp_state_t
+    uint8_t color_cache_state = 0; ///< color_tile_cache.sv state_t
+    uint8_t z_cache_state = 0;     ///< zbuf_tile_cache.sv state_t
+    bool frag_accepted = false;    ///< Rasterizer -> pixel pipeline handshake
+    bool tri_valid = false;        ///< Triangle submitted to the rasterizer
+};
+
+/// Profiled units, in report order.
+enum class ProfiledUnit : uint8_t {
+    RASTERIZER,
+    PIXEL_PIPELINE,
+    COLOR_CACHE,
+    Z_CACHE,
+};
+
+/// Number of ProfiledUnit values.
+inline constexpr size_t PROFILED_UNIT_COUNT = 4;
+
+/// Cycle histograms accumulated over one phase (or a whole run).
+class UnitProfile {
+public:
+    /// Histogram slots per unit; every sampled state field is < 32.
+    static constexpr size_t MAX_STATES = 32;
+
+    /// Account one cycle.
+    void sample(const UnitSample& s) {
+        cycles++;
+        states_[0][s.rast_state & (MAX_STATES - 1)]++;
+        states_[1][s.pp_state & (MAX_STATES - 1)]++;
+        states_[2][s.color_cache_state & (MAX_STATES - 1)]++;
+        states_[3][s.z_cache_state & (MAX_STATES - 1)]++;
+        fragments += s.frag_accepted;
+        triangles += s.tri_valid;
+        // The pixel pipeline waiting in IDLE while the rasterizer is
+        // still working means it is starved for fragments.
+        starved_cycles += (s.pp_state == 0 && s.rast_state != 0);
+    }
+
+    /// Add another profile's counts to this one.
+    void merge(const UnitProfile& other);
+
+    /// Cycles `unit` spent in `state`.
+    uint64_t state_cycles(ProfiledUnit unit, size_t state) const {
+        return states_[static_cast<size_t>(unit)][state];
+    }
+
+    /// Cycles `unit` spent outside its IDLE state (state 0).
+    uint64_t busy_cycles(ProfiledUnit unit) const {
+        return cycles - state_cycles(unit, 0);
+    }
+
+    uint64_t cycles = 0;         ///< Sampled cycles
+    uint64_t fragments = 0;      ///< Fragments accepted by the pixel pipeline
+    uint64_t triangles = 0;      ///< Cycles with tri_valid asserted
+    uint64_t starved_cycles = 0; ///< Pixel pipeline IDLE, rasterizer busy
+
+private:
+    std::array<std::array<uint64_t, MAX_STATES>, PROFILED_UNIT_COUNT> states_{};
+};
+
+/// Display name of `unit` (e.g. "pixel_pipeline").
+std::string_view unit_name(ProfiledUnit unit);
+
+/// RTL name of `state` for `unit` (e.g. "Z_WAIT"), or "S<n>" if unknown.
+std::string unit_state_name(ProfiledUnit unit, size_t state);
+
+/// Multi-line report for one profile, headed by `title`.
+std::string format_unit_profile(std::string_view title, const UnitProfile& profile);
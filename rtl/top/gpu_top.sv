@@ -118,12 +118,12 @@ module gpu_top (
     // Command FIFO signals
     wire        fifo_wr_en;
     wire [71:0] fifo_wr_data;
-    wire        fifo_wr_full;
+    wire        fifo_wr_full /* verilator public */;
     wire        fifo_wr_almost_full /* verilator public */;
     wire        fifo_rd_en;
     wire [71:0] fifo_rd_data;
     wire        fifo_rd_empty;
-    wire [9:0]  fifo_rd_count;
+    wire [9:0]  fifo_rd_count /* verilator public */;
 
     // Register file signals
 `ifdef SIM_DIRECT_REG
@@ -938,8 +938,8 @@ module gpu_top (
     wire rast_ready;
 
     // Rasterizer fragment output bus (to pixel pipeline)
-    wire        rast_frag_valid;
-    wire        rast_frag_ready;
+    wire        rast_frag_valid /* verilator public */;  // Sampled by harness --profile
+    wire        rast_frag_ready /* verilator public */;
     wire [9:0]  rast_frag_x;
     wire [9:0]  rast_frag_y;
     wire [15:0] rast_frag_z;
@@ -12,6 +12,8 @@
 //! - `## FRAMEBUFFER: <width> <height>` declares output dimensions
 //! - `## TEXTURE: <type> base=<hex> format=<fmt> width_log2=<n>`
 //! - `## INCLUDE: <relative-path>` includes another hex file
+//! - `## TIMESTAMP: <label> <hex-addr>` emits a PERF_TIMESTAMP (0x50)
+//!   write; the label is only used by the Verilator harness
 
 use crate::triangle::RegWrite;
 
@@ -129,14 +131,19 @@ fn parse_texture_directive(line: &str) -> Option<TextureDirective> {
 
 /// Handle a `##` directive line, updating script/phase state.
 ///
-/// Returns `Some(path)` if the directive is an `## INCLUDE:` that needs
+/// Returns `Ok(Some(path))` if the directive is an `## INCLUDE:` that needs
 /// to be processed by the caller (since it requires filesystem access).
+///
+/// # Errors
+///
+/// Returns a descriptive error string for a malformed `## TIMESTAMP:` line.
 fn handle_directive(
     line: &str,
+    line_no: usize,
     script: &mut HexScript,
     current_phase: &mut HexPhase,
     has_explicit_phase: &mut bool,
-) -> Option<String> {
+) -> Result<Option<String>, String> {
     if let Some(name) = line.strip_prefix("## PHASE:") {
         if !current_phase.commands.is_empty() || *has_explicit_phase {
             let prev = std::mem::replace(
@@ -155,10 +162,12 @@ fn handle_directive(
         script.fb_height = h;
     } else if let Some(td) = parse_texture_directive(line) {
         script.textures.push(td);
+    } else if let Some(cmd) = parse_timestamp_directive(line, line_no) {
+        current_phase.commands.push(cmd?);
     } else if let Some(path) = line.strip_prefix("## INCLUDE:") {
-        return Some(path.trim().to_string());
+        return Ok(Some(path.trim().to_string()));
     }
-    None
+    Ok(None)
 }
 
 /// Parse a `## FRAMEBUFFER:` directive, returning (width, height).
@@ -174,6 +183,43 @@ fn parse_framebuffer_directive(line: &str) -> Option<(u32, u32)> {
     }
 }
 
+/// Parse a `## TIMESTAMP: <label> <addr>` directive into its PERF_TIMESTAMP
+/// register write.
+///
+/// Returns `None` if `line` is not a `## TIMESTAMP:` directive, and an
+/// error for a missing label or address or a bad hex address, as the
+/// Verilator harness's reader does, so both see the same command stream.
+fn parse_timestamp_directive(line: &str, line_no: usize) -> Option<Result<RegWrite, String>> {
+    let args = line.strip_prefix("## TIMESTAMP:")?;
+    let mut tokens = args.split_whitespace();
+    let (Some(_label), Some(addr_tok)) = (tokens.next(), tokens.next()) else {
+        return Some(Err(format!(
+            "Line {}: expected '## TIMESTAMP: <label> <addr>', got '{}'",
+            line_no + 1,
+            line
+        )));
+    };
+    let hex_str = addr_tok
+        .strip_prefix("0x")
+        .or_else(|| addr_tok.strip_prefix("0X"))
+        .unwrap_or(addr_tok);
+    Some(
+        u64::from_str_radix(&strip_underscores(hex_str), 16)
+            .map(|addr| RegWrite {
+                addr: 0x50,
+                data: addr & 0x7F_FFFF,
+            })
+            .map_err(|e| {
+                format!(
+                    "Line {}: bad timestamp address '{}': {}",
+                    line_no + 1,
+                    addr_tok,
+                    e
+                )
+            }),
+    )
+}
+
 /// Parse a single data line: `<addr_hex> <data_hex>`.
 fn parse_data_line(line: &str, line_no: usize) -> Result<RegWrite, String> {
     let parts: Vec<&str> = line.split_whitespace().collect();
@@ -240,7 +286,8 @@ fn process_include(
 ///
 /// # Errors
 ///
-/// Returns a descriptive error string if any data line is malformed.
+/// Returns a descriptive error string if any data line or
+/// `## TIMESTAMP:` directive is malformed.
 pub fn parse_hex_str(content: &str) -> Result<HexScript, String> {
     parse_hex_str_with_base(content, None)
 }
@@ -256,8 +303,9 @@ pub fn parse_hex_str(content: &str) -> Result<HexScript, String> {
 ///
 /// # Errors
 ///
-/// Returns a descriptive error string if any data line is malformed
-/// or an included file cannot be read.
+/// Returns a descriptive error string if any data line or
+/// `## TIMESTAMP:` directive is malformed, or an included file cannot
+/// be read.
 pub fn parse_hex_str_with_base(
     content: &str,
     base_dir: Option<&std::path::Path>,
@@ -282,10 +330,11 @@ pub fn parse_hex_str_with_base(
         if line.starts_with("##") {
             let include_path = handle_directive(
                 line,
+                line_no,
                 &mut script,
                 &mut current_phase,
                 &mut has_explicit_phase,
-            );
+            )?;
             if let (Some(path), Some(base)) = (include_path, base_dir) {
                 process_include(&path, base, line_no, &mut script, &mut current_phase)?;
             }
@@ -390,6 +439,43 @@ mod tests {
         assert_eq!(script.textures[0].width_log2, 4);
     }
 
+    #[test]
+    fn test_parse_timestamp_directive() {
+        let hex = "\
+## PHASE: main
+## TIMESTAMP: start 0x7_F000
+40 0000000000000000
+## TIMESTAMP: end 7F001
+";
+        let script = parse_hex_str(hex).unwrap();
+        let cmds = &script.phases[0].commands;
+        assert_eq!(cmds.len(), 3);
+        assert_eq!(cmds[0].addr, 0x50);
+        assert_eq!(cmds[0].data, 0x7F000);
+        assert_eq!(cmds[2].addr, 0x50);
+        assert_eq!(cmds[2].data, 0x7F001);
+    }
+
+    #[test]
+    fn test_malformed_timestamp_directive_is_an_error() {
+        let usage = "expected '## TIMESTAMP: <label> <addr>'";
+        for (line, expected) in [
+            ("## TIMESTAMP:", usage),
+            ("## TIMESTAMP: start", usage),
+            (
+                "## TIMESTAMP: start 0x7G000",
+                "bad timestamp address '0x7G000'",
+            ),
+        ] {
+            let hex = format!("## PHASE: main\n40 0000000000000000\n{line}\n");
+            let err = parse_hex_str(&hex).unwrap_err();
+            assert!(
+                err.starts_with("Line 3: ") && err.contains(expected),
+                "{line:?}: {err}"
+            );
+        }
+    }
+
     #[test]
     fn test_include_directive_ignored_without_base() {
         let hex = "\